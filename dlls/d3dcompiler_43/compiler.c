@@ -20,6 +20,8 @@
 
 #define COBJMACROS
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include "wine/debug.h"
 
@@ -399,6 +401,562 @@ HRESULT WINAPI D3DAssemble(const void *data, SIZE_T datasize, const char *filena
     return hr;
 }
 
+/* Optional on-disk cache of compiled shaders, enabled by pointing the
+ * WINE_D3DCOMPILER_CACHE environment variable at a directory. The variable
+ * may hold either a DOS path or a Unix path. WINE_D3DCOMPILER_CACHE_SIZE
+ * limits the size of the directory in MiB; the least recently used entries
+ * are evicted once it is exceeded, and 0 disables the cache.
+ *
+ * Entries are keyed by the source, macros and every other input that affects
+ * code generation. The include files opened during compilation are recorded
+ * along with their contents. On lookup they are opened again through the
+ * application's ID3DInclude and compared, so that a cache hit makes the same
+ * Open() and Close() calls a compilation would. Only when an include has
+ * changed does the compilation that follows open the includes a second time.
+ * The full key is stored with each entry and compared on lookup, so a hash
+ * collision is merely a miss. */
+
+#define COMPILE_CACHE_MAGIC 0x43344457 /* "WD4C" */
+#define COMPILE_CACHE_MAX_ENTRY_SIZE 0x10000000
+#define COMPILE_CACHE_DEFAULT_SIZE 256 /* MiB */
+
+/* Parent indices for includes that aren't opened from another include. */
+#define COMPILE_CACHE_PARENT_NONE   (~0u)
+#define COMPILE_CACHE_PARENT_SOURCE (~0u - 1)
+
+struct compile_cache_header
+{
+    uint32_t magic;
+    uint32_t key_size;
+    uint32_t includes_size;
+    uint32_t code_size;
+    uint32_t messages_size;
+};
+
+struct compile_cache_key
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    uint64_t hash;
+};
+
+/* Include files opened by a compilation. Each record consists of the include
+ * type, the parent index, the NUL-terminated file name, the data size and the
+ * data. */
+struct compile_cache_includes
+{
+    ID3DInclude *iface;
+    struct compile_cache_key records;
+    const void **open;
+    size_t count, capacity;
+    BOOL failed;
+};
+
+struct compile_cache_file
+{
+    FILETIME access_time;
+    uint64_t size;
+    char name[MAX_PATH];
+};
+
+static struct
+{
+    BOOL enabled;
+    char path[MAX_PATH];
+    uint64_t size;
+    uint64_t max_size;
+}
+compile_cache;
+
+static CRITICAL_SECTION compile_cache_cs;
+static CRITICAL_SECTION_DEBUG compile_cache_cs_debug =
+{
+    0, 0, &compile_cache_cs,
+    { &compile_cache_cs_debug.ProcessLocksList,
+      &compile_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": compile_cache_cs") }
+};
+static CRITICAL_SECTION compile_cache_cs = { &compile_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static INIT_ONCE compile_cache_once = INIT_ONCE_STATIC_INIT;
+
+static int compile_cache_file_compare(const void *a, const void *b)
+{
+    const struct compile_cache_file *f1 = a, *f2 = b;
+
+    return CompareFileTime(&f1->access_time, &f2->access_time);
+}
+
+/* Recompute the cache size from the directory contents, which may have been
+ * changed by other processes, and evict the least recently used entries if
+ * the limit is exceeded. Called with compile_cache_cs held. */
+static void compile_cache_trim(void)
+{
+    struct compile_cache_file *files = NULL, *new_files;
+    size_t count = 0, capacity = 0, i;
+    char pattern[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    uint64_t size = 0;
+    HANDLE find;
+
+    snprintf(pattern, sizeof(pattern), "%s\\*.d3dcache", compile_cache.path);
+    if ((find = FindFirstFileA(pattern, &data)) == INVALID_HANDLE_VALUE)
+    {
+        compile_cache.size = 0;
+        return;
+    }
+
+    do
+    {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+        if (count == capacity)
+        {
+            capacity = max(capacity * 2, 64);
+            if (!(new_files = heap_realloc(files, capacity * sizeof(*files))))
+                break;
+            files = new_files;
+        }
+        files[count].access_time = data.ftLastAccessTime;
+        files[count].size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        snprintf(files[count].name, sizeof(files[count].name), "%s\\%s", compile_cache.path, data.cFileName);
+        size += files[count++].size;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    if (size > compile_cache.max_size)
+    {
+        TRACE("Shader cache size %s exceeds the limit, evicting.\n", wine_dbgstr_longlong(size));
+        qsort(files, count, sizeof(*files), compile_cache_file_compare);
+        for (i = 0; i < count && size > compile_cache.max_size / 4 * 3; ++i)
+        {
+            if (DeleteFileA(files[i].name))
+                size -= files[i].size;
+        }
+    }
+
+    compile_cache.size = size;
+    heap_free(files);
+}
+
+static BOOL compile_cache_get_directory(char *path, size_t size)
+{
+    WCHAR *(CDECL *p_wine_get_dos_file_name)(const char *);
+    char value[MAX_PATH];
+    WCHAR *dos_path;
+    DWORD len;
+
+    len = GetEnvironmentVariableA("WINE_D3DCOMPILER_CACHE", value, ARRAY_SIZE(value));
+    if (!len || len >= ARRAY_SIZE(value))
+        return FALSE;
+
+    if (value[0] != '/')
+    {
+        lstrcpynA(path, value, size);
+        return TRUE;
+    }
+
+    p_wine_get_dos_file_name = (void *)GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "wine_get_dos_file_name");
+    if (!p_wine_get_dos_file_name || !(dos_path = p_wine_get_dos_file_name(value)))
+    {
+        WARN("Failed to convert %s to a DOS path.\n", debugstr_a(value));
+        return FALSE;
+    }
+    len = WideCharToMultiByte(CP_ACP, 0, dos_path, -1, path, size, NULL, NULL);
+    HeapFree(GetProcessHeap(), 0, dos_path);
+    return !!len;
+}
+
+static BOOL WINAPI compile_cache_init(INIT_ONCE *once, void *param, void **context)
+{
+    unsigned int max_size = COMPILE_CACHE_DEFAULT_SIZE;
+    DWORD attributes, len;
+    char value[16];
+
+    len = GetEnvironmentVariableA("WINE_D3DCOMPILER_CACHE_SIZE", value, ARRAY_SIZE(value));
+    if (len && len < ARRAY_SIZE(value))
+        max_size = strtoul(value, NULL, 10);
+    if (!max_size || !compile_cache_get_directory(compile_cache.path, sizeof(compile_cache.path)))
+        return TRUE;
+
+    CreateDirectoryA(compile_cache.path, NULL);
+    attributes = GetFileAttributesA(compile_cache.path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        WARN("Failed to create shader cache directory %s.\n", debugstr_a(compile_cache.path));
+        return TRUE;
+    }
+
+    TRACE("Using shader cache directory %s, limit %u MiB.\n", debugstr_a(compile_cache.path), max_size);
+    compile_cache.max_size = (uint64_t)max_size * 1024 * 1024;
+    EnterCriticalSection(&compile_cache_cs);
+    compile_cache_trim();
+    LeaveCriticalSection(&compile_cache_cs);
+    compile_cache.enabled = TRUE;
+    return TRUE;
+}
+
+static BOOL compile_cache_enabled(void)
+{
+    InitOnceExecuteOnce(&compile_cache_once, compile_cache_init, NULL, NULL);
+    return compile_cache.enabled;
+}
+
+static BOOL compile_cache_key_append(struct compile_cache_key *key, const void *data, size_t size)
+{
+    if (key->size + size > key->capacity)
+    {
+        size_t capacity = max(max(key->capacity * 2, key->size + size), 4096);
+        char *data;
+
+        if (!(data = heap_realloc(key->data, capacity)))
+            return FALSE;
+        key->data = data;
+        key->capacity = capacity;
+    }
+    memcpy(key->data + key->size, data, size);
+    key->size += size;
+    return TRUE;
+}
+
+static BOOL compile_cache_key_append_string(struct compile_cache_key *key, const char *str)
+{
+    if (!str)
+        str = "";
+    return compile_cache_key_append(key, str, strlen(str) + 1);
+}
+
+static BOOL compile_cache_key_append_uint(struct compile_cache_key *key, uint32_t value)
+{
+    return compile_cache_key_append(key, &value, sizeof(value));
+}
+
+static void compile_cache_key_cleanup(struct compile_cache_key *key)
+{
+    heap_free(key->data);
+}
+
+static BOOL compile_cache_init_key(struct compile_cache_key *key, const struct vkd3d_shader_compile_info *compile_info,
+        const struct vkd3d_shader_preprocess_info *preprocess_info, const struct vkd3d_shader_hlsl_source_info *hlsl_info,
+        UINT flags, UINT effect_flags, UINT secondary_flags)
+{
+    BOOL ret;
+    size_t i;
+
+    memset(key, 0, sizeof(*key));
+
+    ret = compile_cache_key_append_string(key, vkd3d_shader_get_version(NULL, NULL))
+            && compile_cache_key_append_uint(key, D3D_COMPILER_VERSION)
+            && compile_cache_key_append_uint(key, compile_info->target_type)
+            && compile_cache_key_append_string(key, hlsl_info->profile)
+            && compile_cache_key_append_string(key, hlsl_info->entry_point)
+            && compile_cache_key_append_uint(key, flags)
+            && compile_cache_key_append_uint(key, effect_flags)
+            && compile_cache_key_append_uint(key, secondary_flags)
+            && compile_cache_key_append_uint(key, hlsl_info->secondary_code.size)
+            && compile_cache_key_append(key, hlsl_info->secondary_code.code, hlsl_info->secondary_code.size)
+            && compile_cache_key_append_string(key, compile_info->source_name)
+            && compile_cache_key_append_uint(key, preprocess_info->macro_count);
+    for (i = 0; ret && i < preprocess_info->macro_count; ++i)
+    {
+        ret = compile_cache_key_append_string(key, preprocess_info->macros[i].name)
+                && compile_cache_key_append_string(key, preprocess_info->macros[i].value);
+    }
+    ret = ret && compile_cache_key_append(key, compile_info->source.code, compile_info->source.size);
+
+    if (!ret || key->size > UINT32_MAX)
+    {
+        compile_cache_key_cleanup(key);
+        return FALSE;
+    }
+
+    /* FNV-1a; only used to name the entry. */
+    key->hash = 0xcbf29ce484222325ull;
+    for (i = 0; i < key->size; ++i)
+        key->hash = (key->hash ^ (unsigned char)key->data[i]) * 0x100000001b3ull;
+
+    return TRUE;
+}
+
+static int compile_cache_open_include(const char *filename, bool local, const char *parent_data, void *context,
+        struct vkd3d_shader_code *code)
+{
+    struct compile_cache_includes *includes = context;
+    uint32_t parent = COMPILE_CACHE_PARENT_SOURCE;
+    const void **open;
+    size_t i;
+    int ret;
+
+    if ((ret = open_include(filename, local, parent_data, includes->iface, code)))
+        return ret;
+
+    if (!parent_data)
+        parent = COMPILE_CACHE_PARENT_NONE;
+    for (i = includes->count; i && parent_data; --i)
+    {
+        if (includes->open[i - 1] == parent_data)
+        {
+            parent = i - 1;
+            break;
+        }
+    }
+
+    if (includes->count == includes->capacity)
+    {
+        includes->capacity = max(includes->capacity * 2, 8);
+        if (!(open = heap_realloc(includes->open, includes->capacity * sizeof(*open))))
+        {
+            includes->failed = TRUE;
+            includes->capacity = includes->count;
+            return VKD3D_OK;
+        }
+        includes->open = open;
+    }
+    includes->open[includes->count++] = code->code;
+
+    if (!compile_cache_key_append_uint(&includes->records, local ? D3D_INCLUDE_LOCAL : D3D_INCLUDE_SYSTEM)
+            || !compile_cache_key_append_uint(&includes->records, parent)
+            || !compile_cache_key_append_string(&includes->records, filename)
+            || !compile_cache_key_append_uint(&includes->records, code->size)
+            || !compile_cache_key_append(&includes->records, code->code, code->size))
+        includes->failed = TRUE;
+
+    return VKD3D_OK;
+}
+
+static void compile_cache_close_include(const struct vkd3d_shader_code *code, void *context)
+{
+    struct compile_cache_includes *includes = context;
+    size_t i;
+
+    /* The data may be reused by a later include; make sure that it isn't
+     * mistaken for the parent of that include's children. */
+    for (i = includes->count; i; --i)
+    {
+        if (includes->open[i - 1] == code->code)
+        {
+            includes->open[i - 1] = NULL;
+            break;
+        }
+    }
+
+    close_include(code, includes->iface);
+}
+
+static void compile_cache_includes_cleanup(struct compile_cache_includes *includes)
+{
+    compile_cache_key_cleanup(&includes->records);
+    heap_free(includes->open);
+}
+
+static BOOL compile_cache_read_uint(const char **ptr, const char *end, uint32_t *value)
+{
+    if (end - *ptr < sizeof(*value))
+        return FALSE;
+    memcpy(value, *ptr, sizeof(*value));
+    *ptr += sizeof(*value);
+    return TRUE;
+}
+
+/* Open the include files recorded in an entry, and check that they still have
+ * the same contents. */
+static BOOL compile_cache_check_includes(ID3DInclude *iface, const void *source,
+        const char *ptr, const char *end)
+{
+    uint32_t type, parent, size;
+    size_t count = 0, max_count, i;
+    const void **data;
+    BOOL ret = TRUE;
+    const char *name;
+    UINT bytes;
+
+    if (ptr == end)
+        return TRUE;
+    /* Each record takes at least 13 bytes. */
+    max_count = (end - ptr) / 13;
+    if (!iface || !(data = heap_calloc(max_count, sizeof(*data))))
+        return FALSE;
+
+    while (ptr != end)
+    {
+        const void *parent_data;
+
+        ret = FALSE;
+        if (!compile_cache_read_uint(&ptr, end, &type) || !compile_cache_read_uint(&ptr, end, &parent))
+            break;
+        name = ptr;
+        if (!(ptr = memchr(name, 0, end - name)))
+            break;
+        ++ptr;
+        if (!compile_cache_read_uint(&ptr, end, &size) || end - ptr < size)
+            break;
+
+        if (parent == COMPILE_CACHE_PARENT_NONE)
+            parent_data = NULL;
+        else if (parent == COMPILE_CACHE_PARENT_SOURCE)
+            parent_data = source;
+        else if (parent < count)
+            parent_data = data[parent];
+        else
+            break;
+
+        if (count == max_count || FAILED(ID3DInclude_Open(iface, type, name, parent_data, &data[count], &bytes)))
+            break;
+        ++count;
+        if (bytes != size || memcmp(data[count - 1], ptr, size))
+            break;
+        ptr += size;
+        ret = TRUE;
+    }
+
+    for (i = count; i; --i)
+        ID3DInclude_Close(iface, data[i - 1]);
+    heap_free(data);
+
+    return ret;
+}
+
+static void compile_cache_get_path(const struct compile_cache_key *key, char *path, size_t size)
+{
+    snprintf(path, size, "%s\\%08x%08x.d3dcache", compile_cache.path,
+            (uint32_t)(key->hash >> 32), (uint32_t)key->hash);
+}
+
+static BOOL compile_cache_lookup(const struct compile_cache_key *key, ID3DInclude *iface, const void *source,
+        ID3DBlob **shader_blob, ID3DBlob **messages_blob)
+{
+    struct compile_cache_header *header;
+    char path[MAX_PATH];
+    LARGE_INTEGER size;
+    BOOL ret = FALSE;
+    const char *ptr;
+    DWORD read;
+    HANDLE file;
+    char *data;
+
+    compile_cache_get_path(key, path, sizeof(path));
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < sizeof(*header)
+            || size.QuadPart > COMPILE_CACHE_MAX_ENTRY_SIZE
+            || !(data = heap_alloc(size.QuadPart)))
+    {
+        CloseHandle(file);
+        return FALSE;
+    }
+
+    if (!ReadFile(file, data, size.QuadPart, &read, NULL) || read != size.QuadPart)
+        goto done;
+
+    header = (struct compile_cache_header *)data;
+    if (header->magic != COMPILE_CACHE_MAGIC || header->key_size != key->size
+            || size.QuadPart != sizeof(*header) + (ULONGLONG)header->key_size
+            + header->includes_size + header->code_size + header->messages_size)
+        goto done;
+
+    ptr = data + sizeof(*header);
+    if (memcmp(ptr, key->data, key->size))
+        goto done;
+    ptr += key->size;
+
+    if (!compile_cache_check_includes(iface, source, ptr, ptr + header->includes_size))
+    {
+        TRACE("Include files of %s changed.\n", debugstr_a(path));
+        goto done;
+    }
+    ptr += header->includes_size;
+
+    if (FAILED(D3DCreateBlob(header->code_size, shader_blob)))
+        goto done;
+    memcpy(ID3D10Blob_GetBufferPointer(*shader_blob), ptr, header->code_size);
+    ptr += header->code_size;
+
+    if (messages_blob && header->messages_size)
+    {
+        if (FAILED(D3DCreateBlob(header->messages_size, messages_blob)))
+        {
+            ID3D10Blob_Release(*shader_blob);
+            *shader_blob = NULL;
+            goto done;
+        }
+        memcpy(ID3D10Blob_GetBufferPointer(*messages_blob), ptr, header->messages_size);
+    }
+
+    ret = TRUE;
+
+done:
+    heap_free(data);
+    CloseHandle(file);
+    return ret;
+}
+
+static BOOL compile_cache_write(HANDLE file, const void *data, size_t size)
+{
+    DWORD written;
+
+    return WriteFile(file, data, size, &written, NULL) && written == size;
+}
+
+/* Entries are written to a temporary file and renamed into place, so that
+ * concurrent processes never observe a partially written entry. */
+static void compile_cache_store(const struct compile_cache_key *key, const struct compile_cache_includes *includes,
+        const struct vkd3d_shader_code *byte_code, const char *messages)
+{
+    struct compile_cache_header header;
+    char path[MAX_PATH], tmp_path[MAX_PATH];
+    uint64_t entry_size;
+    HANDLE file;
+    BOOL ret;
+
+    if (includes->failed || includes->records.size > UINT32_MAX)
+        return;
+
+    header.magic = COMPILE_CACHE_MAGIC;
+    header.key_size = key->size;
+    header.includes_size = includes->records.size;
+    header.code_size = byte_code->size;
+    header.messages_size = messages ? strlen(messages) : 0;
+
+    entry_size = sizeof(header) + (uint64_t)header.key_size + header.includes_size
+            + header.code_size + header.messages_size;
+    if (entry_size > COMPILE_CACHE_MAX_ENTRY_SIZE || entry_size > compile_cache.max_size)
+        return;
+
+    compile_cache_get_path(key, path, sizeof(path));
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%lx.%lx.tmp", path, GetCurrentProcessId(), GetCurrentThreadId());
+
+    file = CreateFileA(tmp_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        WARN("Failed to create %s, error %lu.\n", debugstr_a(tmp_path), GetLastError());
+        return;
+    }
+
+    ret = compile_cache_write(file, &header, sizeof(header))
+            && compile_cache_write(file, key->data, key->size)
+            && compile_cache_write(file, includes->records.data, includes->records.size)
+            && compile_cache_write(file, byte_code->code, byte_code->size)
+            && compile_cache_write(file, messages, header.messages_size);
+    CloseHandle(file);
+
+    if (!ret || !MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to store shader cache entry %s, error %lu.\n", debugstr_a(path), GetLastError());
+        DeleteFileA(tmp_path);
+        return;
+    }
+
+    EnterCriticalSection(&compile_cache_cs);
+    compile_cache.size += entry_size;
+    if (compile_cache.size > compile_cache.max_size)
+        compile_cache_trim();
+    LeaveCriticalSection(&compile_cache_cs);
+}
+
 HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filename,
         const D3D_SHADER_MACRO *macros, ID3DInclude *include, const char *entry_point,
         const char *profile, UINT flags, UINT effect_flags, UINT secondary_flags,
@@ -411,9 +969,12 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
     struct vkd3d_shader_compile_option options[2];
     struct vkd3d_shader_compile_info compile_info;
     struct vkd3d_shader_compile_option *option;
+    struct compile_cache_includes cache_includes;
+    struct compile_cache_key cache_key;
     struct vkd3d_shader_code byte_code;
     const D3D_SHADER_MACRO *macro;
     size_t profile_len, i;
+    BOOL use_cache;
     char *messages;
     HRESULT hr;
     int ret;
@@ -519,10 +1080,35 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
         option->value = true;
     }
 
+    use_cache = compile_cache_enabled() && compile_cache_init_key(&cache_key,
+            &compile_info, &preprocess_info, &hlsl_info, flags, effect_flags, secondary_flags);
+    if (use_cache)
+    {
+        if (compile_cache_lookup(&cache_key, include, data, shader_blob, messages_blob))
+        {
+            TRACE("Found shader in cache.\n");
+            compile_cache_key_cleanup(&cache_key);
+            return S_OK;
+        }
+
+        memset(&cache_includes, 0, sizeof(cache_includes));
+        cache_includes.iface = include;
+        preprocess_info.pfn_open_include = compile_cache_open_include;
+        preprocess_info.pfn_close_include = compile_cache_close_include;
+        preprocess_info.include_context = &cache_includes;
+    }
+
     ret = vkd3d_shader_compile(&compile_info, &byte_code, &messages);
 
     if (ret)
         ERR("Failed to compile shader, vkd3d result %d.\n", ret);
+    else if (use_cache)
+        compile_cache_store(&cache_key, &cache_includes, &byte_code, messages);
+    if (use_cache)
+    {
+        compile_cache_includes_cleanup(&cache_includes);
+        compile_cache_key_cleanup(&cache_key);
+    }
 
     if (messages)
     {
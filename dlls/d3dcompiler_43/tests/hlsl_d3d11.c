@@ -1168,12 +1168,190 @@ static void test_semantic_reflection(void)
     }
 }
 
+struct test_cache_include
+{
+    ID3DInclude ID3DInclude_iface;
+    unsigned int open_count, close_count;
+    const char *value;
+};
+
+static const char test_cache_light_h[] =
+    "#include \"value.h\"\n"
+    "#define LIGHT VALUE\n";
+
+static struct test_cache_include *impl_from_test_cache_include(ID3DInclude *iface)
+{
+    return CONTAINING_RECORD(iface, struct test_cache_include, ID3DInclude_iface);
+}
+
+static HRESULT WINAPI test_cache_include_open(ID3DInclude *iface, D3D_INCLUDE_TYPE include_type,
+        const char *filename, const void *parent_data, const void **data, UINT *bytes)
+{
+    struct test_cache_include *include = impl_from_test_cache_include(iface);
+    const char *source;
+    char *buffer;
+
+    ++include->open_count;
+    ok(include_type == D3D_INCLUDE_LOCAL, "Got unexpected include type %#x.\n", include_type);
+
+    if (!strcmp(filename, "light.h"))
+    {
+        ok(!parent_data, "Got unexpected parent data %p.\n", parent_data);
+        source = test_cache_light_h;
+    }
+    else if (!strcmp(filename, "value.h"))
+    {
+        ok(parent_data && !strncmp(parent_data, test_cache_light_h, strlen(test_cache_light_h)),
+                "Got unexpected parent data %p.\n", parent_data);
+        source = include->value;
+    }
+    else
+    {
+        ok(0, "Got unexpected include %s.\n", debugstr_a(filename));
+        return E_FAIL;
+    }
+
+    buffer = malloc(strlen(source));
+    memcpy(buffer, source, strlen(source));
+    *data = buffer;
+    *bytes = strlen(source);
+    return S_OK;
+}
+
+static HRESULT WINAPI test_cache_include_close(ID3DInclude *iface, const void *data)
+{
+    struct test_cache_include *include = impl_from_test_cache_include(iface);
+
+    ++include->close_count;
+    free((void *)data);
+    return S_OK;
+}
+
+static const struct ID3DIncludeVtbl test_cache_include_vtbl =
+{
+    test_cache_include_open,
+    test_cache_include_close,
+};
+
+#define compile_cached_shader(a, b) compile_cached_shader_(__LINE__, a, b)
+static ID3D10Blob *compile_cached_shader_(unsigned int line, struct test_cache_include *include,
+        unsigned int expect_open_count)
+{
+    static const char ps_source[] =
+        "#include \"light.h\"\n"
+        "\n"
+        "float4 main() : sv_target\n"
+        "{\n"
+        "    return float4(LIGHT, 0.0, 0.0, 1.0);\n"
+        "}";
+    ID3D10Blob *blob = NULL, *errors = NULL;
+    HRESULT hr;
+
+    include->open_count = include->close_count = 0;
+    hr = D3DCompile(ps_source, strlen(ps_source), "source.ps", NULL,
+            &include->ID3DInclude_iface, "main", "ps_4_0", 0, 0, &blob, &errors);
+    ok_(__FILE__, line)(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    if (expect_open_count)
+        ok_(__FILE__, line)(include->open_count == expect_open_count,
+                "Got unexpected open count %u.\n", include->open_count);
+    ok_(__FILE__, line)(include->close_count == include->open_count,
+            "Got close count %u, open count %u.\n", include->close_count, include->open_count);
+    if (errors)
+        ID3D10Blob_Release(errors);
+    return blob;
+}
+
+static BOOL compare_blobs(ID3D10Blob *a, ID3D10Blob *b)
+{
+    return ID3D10Blob_GetBufferSize(a) == ID3D10Blob_GetBufferSize(b)
+            && !memcmp(ID3D10Blob_GetBufferPointer(a), ID3D10Blob_GetBufferPointer(b), ID3D10Blob_GetBufferSize(a));
+}
+
+/* Run in a child process with WINE_D3DCOMPILER_CACHE set. Native d3dcompiler
+ * ignores the variable; either way, results and include callbacks must be
+ * the same as without a cache. */
+static void test_compile_cache_child(void)
+{
+    struct test_cache_include include = {{&test_cache_include_vtbl}};
+    ID3D10Blob *blob, *cached_blob, *changed_blob;
+
+    include.value = "#define VALUE 0.25\n";
+    blob = compile_cached_shader(&include, 2);
+    if (!blob)
+        return;
+    cached_blob = compile_cached_shader(&include, 2);
+    ok(cached_blob && compare_blobs(blob, cached_blob), "Got different bytecode from the cache.\n");
+    if (cached_blob)
+        ID3D10Blob_Release(cached_blob);
+
+    /* A changed include must not return the stale entry. Checking the cached
+     * includes opens them once more before the compilation does. */
+    include.value = "#define VALUE 0.5\n";
+    changed_blob = compile_cached_shader(&include, 0);
+    ok(changed_blob && !compare_blobs(blob, changed_blob), "Got stale bytecode for a changed include.\n");
+    if (changed_blob)
+        ID3D10Blob_Release(changed_blob);
+
+    cached_blob = compile_cached_shader(&include, 2);
+    ok(cached_blob && !compare_blobs(blob, cached_blob), "Got stale bytecode for a changed include.\n");
+    if (cached_blob)
+        ID3D10Blob_Release(cached_blob);
+
+    ID3D10Blob_Release(blob);
+}
+
+static void test_compile_cache(void)
+{
+    char path[MAX_PATH], cmdline[MAX_PATH * 2], file_path[MAX_PATH], **argv;
+    PROCESS_INFORMATION pi;
+    WIN32_FIND_DATAA data;
+    STARTUPINFOA si = {0};
+    HANDLE find;
+    BOOL ret;
+
+    GetTempPathA(ARRAY_SIZE(path), path);
+    strcat(path, "d3dcompiler_cache");
+    SetEnvironmentVariableA("WINE_D3DCOMPILER_CACHE", path);
+
+    winetest_get_mainargs(&argv);
+    sprintf(cmdline, "\"%s\" %s compile_cache", argv[0], argv[1]);
+    si.cb = sizeof(si);
+    ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+    ok(ret, "Failed to create process, error %lu.\n", GetLastError());
+    SetEnvironmentVariableA("WINE_D3DCOMPILER_CACHE", NULL);
+    if (!ret)
+        return;
+    wait_child_process(pi.hProcess);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+
+    sprintf(file_path, "%s\\*", path);
+    if ((find = FindFirstFileA(file_path, &data)) != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            sprintf(file_path, "%s\\%s", path, data.cFileName);
+            DeleteFileA(file_path);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+    RemoveDirectoryA(path);
+}
+
 START_TEST(hlsl_d3d11)
 {
     HMODULE mod;
+    char **argv;
+
+    if (winetest_get_mainargs(&argv) >= 3 && !strcmp(argv[2], "compile_cache"))
+    {
+        test_compile_cache_child();
+        return;
+    }
 
     test_reflection();
     test_semantic_reflection();
+    test_compile_cache();
 
     if (!(mod = LoadLibraryA("d3d11.dll")))
     {
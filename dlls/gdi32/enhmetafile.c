@@ -58,10 +58,25 @@ static CRITICAL_SECTION_DEBUG critsect_debug =
 };
 static CRITICAL_SECTION enhmetafile_cs = { &critsect_debug, -1, 0, 0, 0, 0 };
 
+/* pre-decoded form of a metafile used to replay it with PlayEnhMetaFile */
+struct emf_display_list
+{
+    UINT                  count;     /* number of valid records */
+    DWORD                *offsets;   /* offset of each record */
+    DWORD                *handles;   /* handle table index created or deleted by each record, or ~0u */
+    HGDIOBJ              *objects;   /* objects created by each record, kept across replays */
+    LONG                  cached;    /* number of objects kept alive */
+};
+
+/* maximum number of objects kept alive by a display list */
+#define MAX_DISPLAY_LIST_OBJECTS 64
+
 typedef struct
 {
     ENHMETAHEADER        *emh;
     BOOL                  on_disk;   /* true if metafile is on disk */
+    UINT                  replays;   /* number of PlayEnhMetaFile calls */
+    struct emf_display_list *display_list;
 } ENHMETAFILEOBJ;
 
 static const struct emr_name {
@@ -288,6 +303,8 @@ HENHMETAFILE EMF_Create_HENHMETAFILE(ENHMETAHEADER *emh, DWORD filesize, BOOL on
 
     metaObj->emh = emh;
     metaObj->on_disk = on_disk;
+    metaObj->replays = 0;
+    metaObj->display_list = NULL;
 
     if ((hmf = NtGdiCreateClientObj( NTGDI_OBJ_ENHMETAFILE )))
         set_gdi_client_ptr( hmf, metaObj );
@@ -296,6 +313,87 @@ HENHMETAFILE EMF_Create_HENHMETAFILE(ENHMETAHEADER *emh, DWORD filesize, BOOL on
     return hmf;
 }
 
+/* return the handle table index of the object created or deleted by a record, or ~0u */
+static DWORD get_record_handle( const ENHMETARECORD *emr )
+{
+    /* the index always follows the record header */
+    if (emr->nSize < sizeof(EMRSELECTOBJECT)) return ~0u;
+
+    switch (emr->iType)
+    {
+    case EMR_CREATEPEN:
+    case EMR_EXTCREATEPEN:
+    case EMR_CREATEBRUSHINDIRECT:
+    case EMR_CREATEMONOBRUSH:
+    case EMR_CREATEDIBPATTERNBRUSHPT:
+    case EMR_EXTCREATEFONTINDIRECTW:
+    case EMR_DELETEOBJECT:
+        return ((const EMRSELECTOBJECT *)emr)->ihObject;
+    }
+    return ~0u;
+}
+
+/****************************************************************************
+ *          create_display_list
+ *
+ * Decode the record layout of a metafile once so that it can be replayed
+ * without validating the records again.
+ */
+static struct emf_display_list *create_display_list( const ENHMETAHEADER *emh )
+{
+    struct emf_display_list *list;
+    const ENHMETARECORD *emr;
+    DWORD offset;
+    UINT count;
+
+    for (offset = count = 0; offset < emh->nBytes; offset += emr->nSize, count++)
+    {
+        emr = (const ENHMETARECORD *)((const char *)emh + offset);
+        if (offset + 8 > emh->nBytes || offset > offset + emr->nSize ||
+            offset + emr->nSize > emh->nBytes)
+            break;
+        if (!emr->nSize) break;
+    }
+
+    if (!(list = HeapAlloc( GetProcessHeap(), 0, sizeof(*list) ))) return NULL;
+    list->count = count;
+    list->cached = 0;
+    list->offsets = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*list->offsets) );
+    list->handles = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*list->handles) );
+    list->objects = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, count * sizeof(*list->objects) );
+    if (!list->offsets || !list->handles || !list->objects)
+    {
+        HeapFree( GetProcessHeap(), 0, list->offsets );
+        HeapFree( GetProcessHeap(), 0, list->handles );
+        HeapFree( GetProcessHeap(), 0, list->objects );
+        HeapFree( GetProcessHeap(), 0, list );
+        return NULL;
+    }
+
+    for (offset = count = 0; count < list->count; offset += emr->nSize, count++)
+    {
+        emr = (const ENHMETARECORD *)((const char *)emh + offset);
+        list->offsets[count] = offset;
+        list->handles[count] = get_record_handle( emr );
+    }
+
+    TRACE( "%u records\n", list->count );
+    return list;
+}
+
+static void free_display_list( struct emf_display_list *list )
+{
+    UINT i;
+
+    if (!list) return;
+    for (i = 0; i < list->count; i++)
+        if (list->objects[i]) DeleteObject( list->objects[i] );
+    HeapFree( GetProcessHeap(), 0, list->offsets );
+    HeapFree( GetProcessHeap(), 0, list->handles );
+    HeapFree( GetProcessHeap(), 0, list->objects );
+    HeapFree( GetProcessHeap(), 0, list );
+}
+
 /****************************************************************************
  *          EMF_Delete_HENHMETAFILE
  */
@@ -312,6 +410,7 @@ static BOOL EMF_Delete_HENHMETAFILE( HENHMETAFILE hmf )
         return FALSE;
     }
 
+    free_display_list( metafile->display_list );
     if (metafile->on_disk)
         UnmapViewOfFile( metafile->emh );
     else
@@ -342,6 +441,29 @@ static ENHMETAHEADER *EMF_GetEnhMetaHeader( HENHMETAFILE hmf )
     return ret;
 }
 
+/******************************************************************
+ *         EMF_GetDisplayList
+ *
+ * Returns the display list of a HENHMETAFILE, creating it once the
+ * metafile is played again, so that metafiles played only once don't
+ * keep their objects alive.
+ */
+static struct emf_display_list *EMF_GetDisplayList( HENHMETAFILE hmf )
+{
+    struct emf_display_list *ret = NULL;
+    ENHMETAFILEOBJ *metafile;
+
+    EnterCriticalSection( &enhmetafile_cs );
+    if ((metafile = get_gdi_client_ptr( hmf, NTGDI_OBJ_ENHMETAFILE )))
+    {
+        if (!metafile->display_list && metafile->replays++)
+            metafile->display_list = create_display_list( metafile->emh );
+        ret = metafile->display_list;
+    }
+    LeaveCriticalSection( &enhmetafile_cs );
+    return ret;
+}
+
 /*****************************************************************************
  *         EMF_GetEnhMetaFile
  *
@@ -2322,47 +2444,46 @@ BOOL WINAPI PlayEnhMetaFileRecord(
 }
 
 
-/*****************************************************************************
- *
- *        EnumEnhMetaFile  (GDI32.@)
- *
- *  Walk an enhanced metafile, calling a user-specified function _EnhMetaFunc_
- *  for each
- *  record. Returns when either every record has been used or
- *  when _EnhMetaFunc_ returns FALSE.
- *
- *
- * RETURNS
- *  TRUE if every record is used, FALSE if any invocation of _EnhMetaFunc_
- *  returns FALSE.
- *
- * BUGS
- *   Ignores rect.
- *
- * NOTES
- *   This function behaves differently in Win9x and WinNT.
- *
- *   In WinNT, the DC's world transform is updated as the EMF changes
- *    the Window/Viewport Extent and Origin or its world transform.
- *    The actual Window/Viewport Extent and Origin are left untouched.
- *
- *   In Win9x, the DC is left untouched, and PlayEnhMetaFileRecord
- *    updates the scaling itself but only just before a record that
- *    writes anything to the DC.
- *
- *   I'm not sure where the data (enum_emh_data) is stored in either
- *    version. For this implementation, it is stored before the handle
- *    table, but it could be stored in the DC, in the EMF handle or in
- *    TLS.
- *             MJM  5 Oct 2002
- */
-BOOL WINAPI EnumEnhMetaFile(
-     HDC hdc,                /* [in] device context to pass to _EnhMetaFunc_ */
-     HENHMETAFILE hmf,       /* [in] EMF to walk */
-     ENHMFENUMPROC callback, /* [in] callback function */
-     LPVOID data,            /* [in] optional data for callback function */
-     const RECT *lpRect      /* [in] bounding rectangle for rendered metafile */
-    )
+/* play a record of a display list, reusing the objects created by previous replays */
+static BOOL play_display_list_record( HDC hdc, HANDLETABLE *ht, const ENHMETARECORD *emr, UINT handles,
+                                      struct emf_display_list *list, UINT index, BYTE *cached )
+{
+    DWORD ih = list->handles[index];
+    HGDIOBJ obj;
+    BOOL ret;
+
+    if (ih >= handles) return PlayEnhMetaFileRecord( hdc, ht, emr, handles );
+
+    if (emr->iType == EMR_DELETEOBJECT)
+    {
+        if (!cached[ih]) return PlayEnhMetaFileRecord( hdc, ht, emr, handles );
+        /* cached objects are only deleted with the metafile */
+        ht->objectHandle[ih] = 0;
+        cached[ih] = FALSE;
+        return TRUE;
+    }
+
+    if ((obj = list->objects[index]))
+    {
+        ht->objectHandle[ih] = obj;
+        cached[ih] = TRUE;
+        return TRUE;
+    }
+
+    cached[ih] = FALSE;
+    ret = PlayEnhMetaFileRecord( hdc, ht, emr, handles );
+    if (!(obj = ht->objectHandle[ih])) return ret;
+    if (InterlockedIncrement( &list->cached ) <= MAX_DISPLAY_LIST_OBJECTS &&
+        !InterlockedCompareExchangePointer( &list->objects[index], obj, NULL ))
+        cached[ih] = TRUE;
+    else
+        InterlockedDecrement( &list->cached );
+    return ret;
+}
+
+/* walk an enhanced metafile, using its display list if one is given */
+static BOOL enum_enh_metafile( HDC hdc, HENHMETAFILE hmf, ENHMFENUMPROC callback, void *data,
+                               const RECT *lpRect, struct emf_display_list *list )
 {
     BOOL ret;
     ENHMETAHEADER *emh;
@@ -2370,6 +2491,7 @@ BOOL WINAPI EnumEnhMetaFile(
     DWORD offset;
     UINT i;
     HANDLETABLE *ht;
+    BYTE *cached = NULL;
     INT savedMode = 0;
     XFORM savedXform;
     HPEN hPen = NULL;
@@ -2424,6 +2546,9 @@ BOOL WINAPI EnumEnhMetaFile(
     for(i = 1; i < emh->nHandles; i++)
         ht->objectHandle[i] = NULL;
 
+    if (list && !(cached = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, emh->nHandles )))
+        list = NULL;
+
     if (hdc && !is_meta_dc( hdc ))
     {
         savedMode = SetGraphicsMode(hdc, GM_ADVANCED);
@@ -2509,7 +2634,17 @@ BOOL WINAPI EnumEnhMetaFile(
 
     ret = TRUE;
     offset = 0;
-    while(ret && offset < emh->nBytes)
+    for (i = 0; list && ret && i < list->count; i++)
+    {
+        emr = (ENHMETARECORD *)((char *)emh + list->offsets[i]);
+
+        if (hdc && IS_WIN9X() && emr_produces_output(emr->iType))
+            EMF_Update_MF_Xform(hdc, info);
+
+        TRACE("Playing record %s, size %ld\n", get_emr_name(emr->iType), emr->nSize);
+        ret = play_display_list_record( hdc, ht, emr, emh->nHandles, list, i, cached );
+    }
+    while(!list && ret && offset < emh->nBytes)
     {
 	emr = (ENHMETARECORD *)((char *)emh + offset);
 
@@ -2558,8 +2693,9 @@ BOOL WINAPI EnumEnhMetaFile(
     }
 
     for(i = 1; i < emh->nHandles; i++) /* Don't delete element 0 (hmf) */
-        if( (ht->objectHandle)[i] )
+        if( (ht->objectHandle)[i] && !(cached && cached[i]) )
 	    DeleteObject( (ht->objectHandle)[i] );
+    HeapFree( GetProcessHeap(), 0, cached );
 
     while (info->saved_state)
     {
@@ -2571,6 +2707,52 @@ BOOL WINAPI EnumEnhMetaFile(
     return ret;
 }
 
+
+/*****************************************************************************
+ *
+ *        EnumEnhMetaFile  (GDI32.@)
+ *
+ *  Walk an enhanced metafile, calling a user-specified function _EnhMetaFunc_
+ *  for each
+ *  record. Returns when either every record has been used or
+ *  when _EnhMetaFunc_ returns FALSE.
+ *
+ *
+ * RETURNS
+ *  TRUE if every record is used, FALSE if any invocation of _EnhMetaFunc_
+ *  returns FALSE.
+ *
+ * BUGS
+ *   Ignores rect.
+ *
+ * NOTES
+ *   This function behaves differently in Win9x and WinNT.
+ *
+ *   In WinNT, the DC's world transform is updated as the EMF changes
+ *    the Window/Viewport Extent and Origin or its world transform.
+ *    The actual Window/Viewport Extent and Origin are left untouched.
+ *
+ *   In Win9x, the DC is left untouched, and PlayEnhMetaFileRecord
+ *    updates the scaling itself but only just before a record that
+ *    writes anything to the DC.
+ *
+ *   I'm not sure where the data (enum_emh_data) is stored in either
+ *    version. For this implementation, it is stored before the handle
+ *    table, but it could be stored in the DC, in the EMF handle or in
+ *    TLS.
+ *             MJM  5 Oct 2002
+ */
+BOOL WINAPI EnumEnhMetaFile(
+     HDC hdc,                /* [in] device context to pass to _EnhMetaFunc_ */
+     HENHMETAFILE hmf,       /* [in] EMF to walk */
+     ENHMFENUMPROC callback, /* [in] callback function */
+     LPVOID data,            /* [in] optional data for callback function */
+     const RECT *lpRect      /* [in] bounding rectangle for rendered metafile */
+    )
+{
+    return enum_enh_metafile( hdc, hmf, callback, data, lpRect, NULL );
+}
+
 static INT CALLBACK EMF_PlayEnhMetaFileCallback(HDC hdc, HANDLETABLE *ht,
 						const ENHMETARECORD *emr,
 						INT handles, LPARAM data)
@@ -2594,8 +2776,15 @@ BOOL WINAPI PlayEnhMetaFile(
        const RECT *lpRect /* [in] rectangle to place metafile inside */
       )
 {
-    return EnumEnhMetaFile(hdc, hmf, EMF_PlayEnhMetaFileCallback, NULL,
-			   lpRect);
+    struct emf_display_list *list;
+    DC_ATTR *dc_attr;
+
+    /* replays don't go through a callback, so the objects they create can be kept,
+     * except when recording into a metafile where object deletions have to be played */
+    if (is_meta_dc( hdc ) || ((dc_attr = get_dc_attr( hdc )) && dc_attr->emf) ||
+        !(list = EMF_GetDisplayList( hmf )))
+        return EnumEnhMetaFile( hdc, hmf, EMF_PlayEnhMetaFileCallback, NULL, lpRect );
+    return enum_enh_metafile( hdc, hmf, NULL, NULL, lpRect, list );
 }
 
 /*****************************************************************************
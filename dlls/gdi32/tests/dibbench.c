@@ -0,0 +1,451 @@
+/*
+ * DIB engine benchmarks
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * These are not conformance tests, they time the DIB engine primitives for
+ * every DIB format and a few typical sizes. They only run when the
+ * WINETEST_DIB_BENCHMARK environment variable is set; if its value is not "1"
+ * only the benchmarks whose name contains it are run.
+ *
+ * Results are printed one per line, in the form
+ *   dibbench,<benchmark>,<format>,<width>x<height>,<iterations>,<Mpixels/s>
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "windef.h"
+#include "winbase.h"
+#include "wingdi.h"
+#include "winuser.h"
+
+#include "wine/test.h"
+
+#define MIN_TIME_MS    100
+#define MIN_ITERATIONS 3
+#define PIXEL_CALLS    4096  /* number of calls for the per-pixel functions */
+
+struct format
+{
+    const char *name;
+    WORD        bpp;
+    DWORD       compression;
+    DWORD       masks[3];
+};
+
+static const struct format formats[] =
+{
+    { "8888", 32, BI_RGB },
+    { "32",   32, BI_BITFIELDS, { 0x0000ff, 0x00ff00, 0xff0000 } },
+    { "24",   24, BI_RGB },
+    { "555",  16, BI_RGB },
+    { "16",   16, BI_BITFIELDS, { 0xf800, 0x07e0, 0x001f } },
+    { "8",     8, BI_RGB },
+    { "4",     4, BI_RGB },
+    { "1",     1, BI_RGB },
+};
+
+static const SIZE sizes[] =
+{
+    { 32, 32 },
+    { 256, 256 },
+    { 1920, 1080 },
+};
+
+struct bench_ctx
+{
+    HDC   dc;        /* destination, in the format being measured */
+    HDC   src_dc;    /* source of the same format and size */
+    HDC   argb_dc;   /* premultiplied 32-bit source */
+    HDC   mono_dc;   /* 1-bit source */
+    int   width;
+    int   height;
+    HFONT aa_font;
+    HFONT cleartype_font;
+};
+
+/* run one operation, return the number of pixels it touched */
+typedef ULONGLONG (*bench_func)( const struct bench_ctx *ctx );
+
+static ULONGLONG bench_solid_rects( const struct bench_ctx *ctx )
+{
+    HGDIOBJ old = SelectObject( ctx->dc, GetStockObject( BLACK_BRUSH ));
+    PatBlt( ctx->dc, 0, 0, ctx->width, ctx->height, PATCOPY );
+    SelectObject( ctx->dc, old );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_solid_rects_rop( const struct bench_ctx *ctx )
+{
+    PatBlt( ctx->dc, 0, 0, ctx->width, ctx->height, DSTINVERT );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_pattern_rects( const struct bench_ctx *ctx )
+{
+    HBRUSH brush = CreateHatchBrush( HS_DIAGCROSS, RGB( 0xff, 0, 0 ));
+    HGDIOBJ old = SelectObject( ctx->dc, brush );
+    PatBlt( ctx->dc, 0, 0, ctx->width, ctx->height, PATCOPY );
+    SelectObject( ctx->dc, old );
+    DeleteObject( brush );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_dither( const struct bench_ctx *ctx )
+{
+    HBRUSH brush = CreateSolidBrush( RGB( 0x40, 0x80, 0xc0 ));
+    HGDIOBJ old = SelectObject( ctx->dc, brush );
+    PatBlt( ctx->dc, 0, 0, ctx->width, ctx->height, PATCOPY );
+    SelectObject( ctx->dc, old );
+    DeleteObject( brush );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_solid_line( const struct bench_ctx *ctx )
+{
+    HPEN pen = CreatePen( PS_SOLID, 1, RGB( 0, 0xff, 0 ));
+    HGDIOBJ old = SelectObject( ctx->dc, pen );
+    ULONGLONG pixels = 0;
+    int y;
+
+    for (y = 0; y < ctx->height; y++)
+    {
+        MoveToEx( ctx->dc, 0, y, NULL );
+        LineTo( ctx->dc, ctx->width - 1, ctx->height - 1 - y );
+        pixels += max( ctx->width, abs( ctx->height - 1 - 2 * y ));
+    }
+    SelectObject( ctx->dc, old );
+    DeleteObject( pen );
+    return pixels;
+}
+
+static ULONGLONG bench_copy_rect( const struct bench_ctx *ctx )
+{
+    BitBlt( ctx->dc, 0, 0, ctx->width, ctx->height, ctx->src_dc, 0, 0, SRCCOPY );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_copy_rect_rop( const struct bench_ctx *ctx )
+{
+    BitBlt( ctx->dc, 0, 0, ctx->width, ctx->height, ctx->src_dc, 0, 0, SRCINVERT );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_mask_rect( const struct bench_ctx *ctx )
+{
+    BitBlt( ctx->dc, 0, 0, ctx->width, ctx->height, ctx->mono_dc, 0, 0, SRCCOPY );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_blend_src_alpha( const struct bench_ctx *ctx )
+{
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+
+    GdiAlphaBlend( ctx->dc, 0, 0, ctx->width, ctx->height,
+                   ctx->argb_dc, 0, 0, ctx->width, ctx->height, blend );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_blend_constant_alpha( const struct bench_ctx *ctx )
+{
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 128, 0 };
+
+    GdiAlphaBlend( ctx->dc, 0, 0, ctx->width, ctx->height,
+                   ctx->argb_dc, 0, 0, ctx->width, ctx->height, blend );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_gradient_rect( const struct bench_ctx *ctx )
+{
+    TRIVERTEX vert[2] = { { 0, 0, 0xff00, 0x8000, 0x0000, 0xff00 },
+                          { ctx->width, ctx->height, 0x0000, 0x8000, 0xff00, 0x0000 } };
+    GRADIENT_RECT rect = { 0, 1 };
+
+    GdiGradientFill( ctx->dc, vert, 2, &rect, 1, GRADIENT_FILL_RECT_H );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_gradient_triangle( const struct bench_ctx *ctx )
+{
+    TRIVERTEX vert[3] = { { 0, 0, 0xff00, 0x0000, 0x0000, 0xff00 },
+                          { ctx->width, 0, 0x0000, 0xff00, 0x0000, 0xff00 },
+                          { 0, ctx->height, 0x0000, 0x0000, 0xff00, 0xff00 } };
+    GRADIENT_TRIANGLE tri = { 0, 1, 2 };
+
+    GdiGradientFill( ctx->dc, vert, 3, &tri, 1, GRADIENT_FILL_TRIANGLE );
+    return (ULONGLONG)ctx->width * ctx->height / 2;
+}
+
+static ULONGLONG draw_text_lines( const struct bench_ctx *ctx, HFONT font )
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog 0123456789";
+    HGDIOBJ old = SelectObject( ctx->dc, font );
+    TEXTMETRICA tm;
+    int y;
+
+    GetTextMetricsA( ctx->dc, &tm );
+    SetBkMode( ctx->dc, TRANSPARENT );
+    SetTextColor( ctx->dc, RGB( 0x20, 0x40, 0x80 ));
+    for (y = 0; y < ctx->height; y += tm.tmHeight)
+        ExtTextOutA( ctx->dc, 0, y, 0, NULL, text, strlen( text ), NULL );
+    SelectObject( ctx->dc, old );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_draw_glyph( const struct bench_ctx *ctx )
+{
+    return draw_text_lines( ctx, ctx->aa_font );
+}
+
+static ULONGLONG bench_draw_subpixel_glyph( const struct bench_ctx *ctx )
+{
+    return draw_text_lines( ctx, ctx->cleartype_font );
+}
+
+static ULONGLONG bench_get_pixel( const struct bench_ctx *ctx )
+{
+    int i;
+
+    for (i = 0; i < PIXEL_CALLS; i++) GetPixel( ctx->dc, i % ctx->width, (i / ctx->width) % ctx->height );
+    return PIXEL_CALLS;
+}
+
+static ULONGLONG bench_set_pixel( const struct bench_ctx *ctx )
+{
+    int i;
+
+    for (i = 0; i < PIXEL_CALLS; i++)
+        SetPixel( ctx->dc, i % ctx->width, (i / ctx->width) % ctx->height, RGB( i, i >> 4, i >> 8 ));
+    return PIXEL_CALLS;
+}
+
+static ULONGLONG convert_to( const struct bench_ctx *ctx, WORD bpp )
+{
+    BITMAPINFO info = {{ sizeof(BITMAPINFOHEADER), ctx->width, ctx->height, 1, bpp, BI_RGB }};
+    HBITMAP bitmap = GetCurrentObject( ctx->dc, OBJ_BITMAP );
+    void *bits = malloc( ((ctx->width * bpp + 31) / 32) * 4 * ctx->height );
+
+    GetDIBits( ctx->dc, bitmap, 0, ctx->height, bits, &info, DIB_RGB_COLORS );
+    free( bits );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_convert_to_8888( const struct bench_ctx *ctx )
+{
+    return convert_to( ctx, 32 );
+}
+
+static ULONGLONG bench_convert_to_24( const struct bench_ctx *ctx )
+{
+    return convert_to( ctx, 24 );
+}
+
+static ULONGLONG bench_stretch_row( const struct bench_ctx *ctx )
+{
+    SetStretchBltMode( ctx->dc, COLORONCOLOR );
+    StretchBlt( ctx->dc, 0, 0, ctx->width, ctx->height,
+                ctx->src_dc, 0, 0, ctx->width / 2, ctx->height / 2, SRCCOPY );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_shrink_row( const struct bench_ctx *ctx )
+{
+    SetStretchBltMode( ctx->dc, COLORONCOLOR );
+    StretchBlt( ctx->dc, 0, 0, ctx->width / 2, ctx->height / 2,
+                ctx->src_dc, 0, 0, ctx->width, ctx->height, SRCCOPY );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static ULONGLONG bench_halftone( const struct bench_ctx *ctx )
+{
+    SetStretchBltMode( ctx->dc, HALFTONE );
+    StretchBlt( ctx->dc, 0, 0, ctx->width / 2, ctx->height / 2,
+                ctx->src_dc, 0, 0, ctx->width, ctx->height, SRCCOPY );
+    SetStretchBltMode( ctx->dc, COLORONCOLOR );
+    return (ULONGLONG)ctx->width * ctx->height;
+}
+
+static const struct
+{
+    const char *name;
+    bench_func  func;
+} benchmarks[] =
+{
+    { "solid_rects",           bench_solid_rects },
+    { "solid_rects_rop",       bench_solid_rects_rop },
+    { "pattern_rects",         bench_pattern_rects },
+    { "dither",                bench_dither },
+    { "solid_line",            bench_solid_line },
+    { "copy_rect",             bench_copy_rect },
+    { "copy_rect_rop",         bench_copy_rect_rop },
+    { "mask_rect",             bench_mask_rect },
+    { "blend_src_alpha",       bench_blend_src_alpha },
+    { "blend_constant_alpha",  bench_blend_constant_alpha },
+    { "gradient_rect",         bench_gradient_rect },
+    { "gradient_triangle",     bench_gradient_triangle },
+    { "draw_glyph",            bench_draw_glyph },
+    { "draw_subpixel_glyph",   bench_draw_subpixel_glyph },
+    { "get_pixel",             bench_get_pixel },
+    { "set_pixel",             bench_set_pixel },
+    { "convert_to_8888",       bench_convert_to_8888 },
+    { "convert_to_24",         bench_convert_to_24 },
+    { "stretch_row",           bench_stretch_row },
+    { "shrink_row",            bench_shrink_row },
+    { "halftone",              bench_halftone },
+};
+
+static HDC create_dib_dc( const struct format *format, int width, int height, BOOL fill )
+{
+    char buffer[sizeof(BITMAPINFO) + 256 * sizeof(RGBQUAD)];
+    BITMAPINFO *info = (BITMAPINFO *)buffer;
+    HBITMAP bitmap;
+    HDC dc;
+    BYTE *bits;
+    int i, size;
+
+    memset( buffer, 0, sizeof(buffer) );
+    info->bmiHeader.biSize = sizeof(info->bmiHeader);
+    info->bmiHeader.biWidth = width;
+    info->bmiHeader.biHeight = -height;
+    info->bmiHeader.biPlanes = 1;
+    info->bmiHeader.biBitCount = format->bpp;
+    info->bmiHeader.biCompression = format->compression;
+    if (format->compression == BI_BITFIELDS) memcpy( info->bmiColors, format->masks, sizeof(format->masks) );
+    else if (format->bpp <= 8)
+    {
+        int count = 1 << format->bpp;
+        for (i = 0; i < count; i++)
+        {
+            info->bmiColors[i].rgbRed   = i * 255 / (count - 1);
+            info->bmiColors[i].rgbGreen = (i * 97) & 0xff;
+            info->bmiColors[i].rgbBlue  = 255 - i * 255 / (count - 1);
+        }
+    }
+
+    bitmap = CreateDIBSection( 0, info, DIB_RGB_COLORS, (void **)&bits, NULL, 0 );
+    ok( bitmap != NULL, "failed to create %s DIB %dx%d\n", format->name, width, height );
+    if (!bitmap) return 0;
+
+    if (fill)
+    {
+        size = ((width * format->bpp + 31) / 32) * 4 * height;
+        if (format->bpp == 32 && format->compression == BI_RGB)
+        {
+            /* premultiplied gradient for blending */
+            DWORD *pixel = (DWORD *)bits;
+            for (i = 0; i < size / 4; i++)
+            {
+                BYTE alpha = i * 7, r = alpha * (i & 0xff) / 255, g = alpha * ((i >> 8) & 0xff) / 255;
+                pixel[i] = alpha << 24 | r << 16 | g << 8 | (alpha / 2);
+            }
+        }
+        else for (i = 0; i < size; i++) bits[i] = i * 13 + (i >> 8);
+    }
+
+    dc = CreateCompatibleDC( 0 );
+    SelectObject( dc, bitmap );
+    return dc;
+}
+
+static void delete_dib_dc( HDC dc )
+{
+    HBITMAP bitmap = GetCurrentObject( dc, OBJ_BITMAP );
+    DeleteDC( dc );
+    DeleteObject( bitmap );
+}
+
+static void run_benchmark( const char *name, bench_func func, const struct bench_ctx *ctx, const char *format )
+{
+    LARGE_INTEGER freq, start, now;
+    ULONGLONG pixels = 0;
+    unsigned int iterations = 0;
+    double elapsed;
+
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &start );
+    do
+    {
+        pixels += func( ctx );
+        GdiFlush();
+        iterations++;
+        QueryPerformanceCounter( &now );
+        elapsed = (double)(now.QuadPart - start.QuadPart) / freq.QuadPart;
+    } while (iterations < MIN_ITERATIONS || elapsed * 1000 < MIN_TIME_MS);
+
+    printf( "dibbench,%s,%s,%dx%d,%u,%.2f\n", name, format, ctx->width, ctx->height,
+            iterations, pixels / elapsed / 1000000 );
+}
+
+START_TEST(dibbench)
+{
+    static const struct format argb_format = { "8888", 32, BI_RGB };
+    static const struct format mono_format = { "1", 1, BI_RGB };
+    const char *filter = getenv( "WINETEST_DIB_BENCHMARK" );
+    struct bench_ctx ctx;
+    LOGFONTA lf;
+    int i, j, k;
+
+    if (!filter)
+    {
+        skip( "set WINETEST_DIB_BENCHMARK to run the DIB engine benchmarks\n" );
+        return;
+    }
+    if (!strcmp( filter, "1" )) filter = "";
+
+    memset( &lf, 0, sizeof(lf) );
+    lf.lfHeight = -12;
+    strcpy( lf.lfFaceName, "Tahoma" );
+    lf.lfQuality = ANTIALIASED_QUALITY;
+    ctx.aa_font = CreateFontIndirectA( &lf );
+    lf.lfQuality = CLEARTYPE_QUALITY;
+    ctx.cleartype_font = CreateFontIndirectA( &lf );
+
+    printf( "dibbench,benchmark,format,size,iterations,mpixels_per_sec\n" );
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        ctx.width = sizes[i].cx;
+        ctx.height = sizes[i].cy;
+        ctx.argb_dc = create_dib_dc( &argb_format, ctx.width, ctx.height, TRUE );
+        ctx.mono_dc = create_dib_dc( &mono_format, ctx.width, ctx.height, TRUE );
+
+        for (j = 0; j < ARRAY_SIZE(formats); j++)
+        {
+            ctx.dc = create_dib_dc( &formats[j], ctx.width, ctx.height, FALSE );
+            ctx.src_dc = create_dib_dc( &formats[j], ctx.width, ctx.height, TRUE );
+            if (ctx.dc && ctx.src_dc)
+            {
+                for (k = 0; k < ARRAY_SIZE(benchmarks); k++)
+                {
+                    if (!strstr( benchmarks[k].name, filter )) continue;
+                    run_benchmark( benchmarks[k].name, benchmarks[k].func, &ctx, formats[j].name );
+                }
+            }
+            if (ctx.dc) delete_dib_dc( ctx.dc );
+            if (ctx.src_dc) delete_dib_dc( ctx.src_dc );
+        }
+        delete_dib_dc( ctx.argb_dc );
+        delete_dib_dc( ctx.mono_dc );
+    }
+
+    DeleteObject( ctx.aa_font );
+    DeleteObject( ctx.cleartype_font );
+}
@@ -7760,6 +7760,97 @@ static void test_GetOutlineTextMetrics_subst(void)
     ReleaseDC(0, hdc);
 }
 
+struct font_list_hash
+{
+    DWORD count;
+    DWORD hash;
+};
+
+static INT CALLBACK font_list_hash_proc(const LOGFONTW *lf, const TEXTMETRICW *tm, DWORD type, LPARAM lparam)
+{
+    const ENUMLOGFONTEXW *elf = (const ENUMLOGFONTEXW *)lf;
+    struct font_list_hash *list = (struct font_list_hash *)lparam;
+    DWORD hash = 5381 + lf->lfCharSet + type;
+    const WCHAR *p;
+
+    for (p = elf->elfFullName; *p; p++) hash = hash * 33 + *p;
+    for (p = elf->elfStyle; *p; p++) hash = hash * 33 + *p;
+    for (p = lf->lfFaceName; *p; p++) hash = hash * 33 + *p;
+    /* the enumeration order doesn't matter */
+    list->hash += hash;
+    list->count++;
+    return 1;
+}
+
+static void get_font_list_hash(struct font_list_hash *list)
+{
+    LOGFONTW lf;
+    HDC hdc;
+
+    memset(list, 0, sizeof(*list));
+    memset(&lf, 0, sizeof(lf));
+    lf.lfCharSet = DEFAULT_CHARSET;
+    hdc = GetDC(0);
+    EnumFontFamiliesExW(hdc, &lf, font_list_hash_proc, (LPARAM)list, 0);
+    ReleaseDC(0, hdc);
+}
+
+static void test_font_list_child(const char *count, const char *hash)
+{
+    struct font_list_hash list;
+
+    get_font_list_hash(&list);
+    ok(list.count == strtoul(count, NULL, 16), "got %lu fonts, expected %s\n", list.count, count);
+    ok(list.hash == strtoul(hash, NULL, 16), "got hash %08lx, expected %s\n", list.hash, hash);
+}
+
+static void run_font_list_child(const char *argv0, const struct font_list_hash *list)
+{
+    char cmdline[MAX_PATH + 64];
+    PROCESS_INFORMATION info;
+    STARTUPINFOA startup;
+
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+    sprintf(cmdline, "%s font font_list %lx %lx", argv0, list->count, list->hash);
+    ok(CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &startup, &info),
+        "CreateProcess failed.\n");
+    wait_child_process(info.hProcess);
+    CloseHandle(info.hProcess);
+    CloseHandle(info.hThread);
+}
+
+/* other processes must see the same font list, whether it was scanned or loaded from a cache */
+static void test_font_list(const char *argv0)
+{
+    struct font_list_hash list;
+    char ttf_name[MAX_PATH];
+    int num;
+    BOOL ret;
+
+    get_font_list_hash(&list);
+    ok(list.count > 0, "no fonts enumerated\n");
+
+    run_font_list_child(argv0, &list);
+
+    /* adding or removing a public font discards any cached font list,
+     * so that the next process has to scan the fonts again */
+    if (!write_ttf_file("wine_test.ttf", ttf_name))
+    {
+        skip("Failed to create ttf file for testing\n");
+        return;
+    }
+    num = AddFontResourceExA(ttf_name, 0, 0);
+    ok(num == 1, "AddFontResourceExA returned %d\n", num);
+    ret = RemoveFontResourceExA(ttf_name, 0, 0);
+    ok(ret, "RemoveFontResourceEx error %ld\n", GetLastError());
+    DeleteFileA(ttf_name);
+
+    run_font_list_child(argv0, &list);
+    /* and the one after that loads the list published by the scan */
+    run_font_list_child(argv0, &list);
+}
+
 START_TEST(font)
 {
     static const char *test_names[] =
@@ -7778,9 +7869,12 @@ START_TEST(font)
     {
         if (!strcmp(argv[2], "AddFontMemResource"))
             test_AddFontMemResource();
+        else if (!strcmp(argv[2], "font_list") && argc >= 5)
+            test_font_list_child(argv[3], argv[4]);
         return;
     }
 
+    test_font_list(argv[0]);
     test_stock_fonts();
     test_logfont();
     test_bitmap_font();
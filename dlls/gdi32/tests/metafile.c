@@ -4248,6 +4248,114 @@ static void test_emf_pattern_brush(void)
     HeapFree(GetProcessHeap(), 0, orig_lb);
 }
 
+static int CALLBACK play_emf_record_proc(HDC hdc, HANDLETABLE *ht, const ENHMETARECORD *emr,
+                                         int handles, LPARAM param)
+{
+    return PlayEnhMetaFileRecord(hdc, ht, emr, handles);
+}
+
+static void play_emf_to_bits(HENHMETAFILE emf, DWORD *bits, BOOL enum_records)
+{
+    BITMAPINFO info = {{ sizeof(info.bmiHeader), 64, -64, 1, 32, BI_RGB }};
+    RECT rect = { 0, 0, 64, 64 };
+    HBITMAP dib, old;
+    void *dib_bits;
+    HDC hdc;
+    BOOL ret;
+
+    hdc = CreateCompatibleDC(0);
+    dib = CreateDIBSection(hdc, &info, DIB_RGB_COLORS, &dib_bits, NULL, 0);
+    ok(dib != NULL, "CreateDIBSection failed\n");
+    old = SelectObject(hdc, dib);
+    FillRect(hdc, &rect, GetStockObject(WHITE_BRUSH));
+    /* records played from a callback never reuse objects from previous playbacks */
+    if (enum_records) ret = EnumEnhMetaFile(hdc, emf, play_emf_record_proc, NULL, &rect);
+    else ret = PlayEnhMetaFile(hdc, emf, &rect);
+    ok(ret, "playback error %ld\n", GetLastError());
+    GdiFlush();
+    memcpy(bits, dib_bits, 64 * 64 * sizeof(DWORD));
+    SelectObject(hdc, old);
+    DeleteObject(dib);
+    DeleteDC(hdc);
+}
+
+static void test_emf_replay(void)
+{
+    static DWORD first[64 * 64], second[64 * 64];
+    LOGFONTA lf = { -12 };
+    HGDIOBJ pen, brush, font, objects[4];
+    HENHMETAFILE emf;
+    unsigned int i;
+    HDC hdc;
+    BOOL ret;
+
+    hdc = CreateEnhMetaFileA(NULL, NULL, NULL, NULL);
+    ok(hdc != 0, "CreateEnhMetaFileA error %ld\n", GetLastError());
+
+    strcpy(lf.lfFaceName, "Tahoma");
+    pen = SelectObject(hdc, CreatePen(PS_SOLID, 3, RGB(255, 0, 0)));
+    brush = SelectObject(hdc, CreateSolidBrush(RGB(0, 0, 255)));
+    font = SelectObject(hdc, CreateFontIndirectA(&lf));
+    Rectangle(hdc, 4, 4, 40, 40);
+    TextOutA(hdc, 10, 44, "emf", 3);
+    DeleteObject(SelectObject(hdc, pen));
+    DeleteObject(SelectObject(hdc, brush));
+    DeleteObject(SelectObject(hdc, font));
+
+    /* objects created after a deletion may reuse the same handle slot */
+    brush = SelectObject(hdc, CreateSolidBrush(RGB(0, 255, 0)));
+    Ellipse(hdc, 44, 4, 60, 20);
+    DeleteObject(SelectObject(hdc, brush));
+
+    emf = CloseEnhMetaFile(hdc);
+    ok(emf != 0, "CloseEnhMetaFile error %ld\n", GetLastError());
+
+    play_emf_to_bits(emf, first, FALSE);
+    for (i = 0; i < 3; i++)
+    {
+        play_emf_to_bits(emf, second, FALSE);
+        ok(!memcmp(first, second, sizeof(first)), "%u: playback differs\n", i);
+    }
+    ok(first[20 * 64 + 20] == 0x0000ff, "got %#lx\n", first[20 * 64 + 20]);
+    ok(first[12 * 64 + 52] == 0x00ff00, "got %#lx\n", first[12 * 64 + 52]);
+
+    ret = DeleteEnhMetaFile(emf);
+    ok(ret, "DeleteEnhMetaFile error %ld\n", GetLastError());
+
+    /* objects that the metafile never deletes */
+    hdc = CreateEnhMetaFileA(NULL, NULL, NULL, NULL);
+    ok(hdc != 0, "CreateEnhMetaFileA error %ld\n", GetLastError());
+
+    objects[0] = CreatePen(PS_DASH, 1, RGB(255, 0, 255));
+    objects[1] = CreateHatchBrush(HS_DIAGCROSS, RGB(0, 128, 0));
+    objects[2] = CreateFontIndirectA(&lf);
+    objects[3] = CreateSolidBrush(RGB(255, 255, 0));
+    SelectObject(hdc, objects[0]);
+    SelectObject(hdc, objects[1]);
+    SelectObject(hdc, objects[2]);
+    Rectangle(hdc, 2, 2, 30, 30);
+    TextOutA(hdc, 4, 40, "emf", 3);
+    SelectObject(hdc, objects[3]);
+    Ellipse(hdc, 34, 2, 62, 30);
+
+    emf = CloseEnhMetaFile(hdc);
+    ok(emf != 0, "CloseEnhMetaFile error %ld\n", GetLastError());
+    for (i = 0; i < ARRAY_SIZE(objects); i++) DeleteObject(objects[i]);
+
+    play_emf_to_bits(emf, first, TRUE);
+    ok(first[16 * 64 + 48] == 0xffff00, "got %#lx\n", first[16 * 64 + 48]);
+    for (i = 0; i < 3; i++)
+    {
+        play_emf_to_bits(emf, second, FALSE);
+        ok(!memcmp(first, second, sizeof(first)), "%u: playback differs\n", i);
+    }
+    play_emf_to_bits(emf, second, TRUE);
+    ok(!memcmp(first, second, sizeof(first)), "enumerated playback differs\n");
+
+    ret = DeleteEnhMetaFile(emf);
+    ok(ret, "DeleteEnhMetaFile error %ld\n", GetLastError());
+}
+
 static void test_mf_palette_brush(void)
 {
     char buffer[sizeof(BITMAPINFOHEADER) + 256 * sizeof(RGBQUAD) + 16 * 16];
@@ -10632,6 +10740,7 @@ START_TEST(metafile)
     test_emf_select();
     test_emf_blit();
     test_emf_pattern_brush();
+    test_emf_replay();
     test_emf_mask_blit();
     test_emf_StretchDIBits();
     test_emf_SetDIBitsToDevice();
@@ -28,6 +28,7 @@
 #include "winbase.h"
 #include "winreg.h"
 #include "winternl.h"
+#include "wine/heap_profile.h"
 #include "wine/test.h"
 
 /* some undocumented flags (names are made up) */
@@ -3730,6 +3731,88 @@ static void test_heap_sizes(void)
     test_heap_size( 0x150000 );
 }
 
+static void test_heap_profile(void)
+{
+    HEAP_PROFILE_SETTINGS settings = {.Enabled = TRUE, .SampleInterval = 1};
+    HEAP_PROFILE_INFORMATION *info;
+    void *ptrs[16];
+    SIZE_T size;
+    HANDLE heap;
+    UINT i;
+    BOOL ret;
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( !!heap, "HeapCreate failed, error %lu\n", GetLastError() );
+
+    ret = pHeapSetInformation( heap, HeapWineProfileInformation, &settings, sizeof(settings) );
+    size = 0;
+    SetLastError( 0xdeadbeef );
+    if (!ret || (!pHeapQueryInformation( heap, HeapWineProfileInformation, NULL, 0, &size ) &&
+                 GetLastError() != ERROR_INSUFFICIENT_BUFFER))
+    {
+        win_skip( "HeapWineProfileInformation not supported\n" );
+        HeapDestroy( heap );
+        return;
+    }
+    ok( size == offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] ), "got size %Iu\n", size );
+
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++)
+    {
+        ptrs[i] = HeapAlloc( heap, 0, 100 );
+        ok( !!ptrs[i], "HeapAlloc failed, error %lu\n", GetLastError() );
+    }
+    for (i = 0; i < 4; i++) HeapFree( heap, 0, ptrs[i] );
+
+    size = 0;
+    SetLastError( 0xdeadbeef );
+    ret = pHeapQueryInformation( heap, HeapWineProfileInformation, NULL, 0, &size );
+    ok( !ret, "HeapQueryInformation succeeded\n" );
+    ok( GetLastError() == ERROR_INSUFFICIENT_BUFFER, "got error %lu\n", GetLastError() );
+    ok( size == offsetof( HEAP_PROFILE_INFORMATION, Callsites[1] ), "got size %Iu\n", size );
+
+    info = malloc( size );
+    SetLastError( 0xdeadbeef );
+    ret = pHeapQueryInformation( heap, HeapWineProfileInformation, info, offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] ), NULL );
+    ok( !ret, "HeapQueryInformation succeeded\n" );
+    ok( GetLastError() == ERROR_MORE_DATA, "got error %lu\n", GetLastError() );
+    ok( info->CallsiteCount == 0, "got CallsiteCount %lu\n", info->CallsiteCount );
+
+    ret = pHeapQueryInformation( heap, HeapWineProfileInformation, info, size, &size );
+    ok( ret, "HeapQueryInformation failed, error %lu\n", GetLastError() );
+    ok( info->Enabled == 1, "got Enabled %lu\n", info->Enabled );
+    ok( info->SampleInterval == 1, "got SampleInterval %lu\n", info->SampleInterval );
+    ok( info->TotalAllocs == 16, "got TotalAllocs %I64u\n", info->TotalAllocs );
+    ok( info->TotalFrees == 4, "got TotalFrees %I64u\n", info->TotalFrees );
+    ok( info->TotalBytes == 1600, "got TotalBytes %I64u\n", info->TotalBytes );
+    ok( info->LiveBytes == 1200, "got LiveBytes %I64d\n", info->LiveBytes );
+    ok( info->SizeHistogram[6] == 16, "got SizeHistogram[6] %I64u\n", info->SizeHistogram[6] );
+    ok( info->CallsiteCount == 1, "got CallsiteCount %lu\n", info->CallsiteCount );
+    ok( info->Callsites[0].SampledAllocs == 16, "got SampledAllocs %I64u\n", info->Callsites[0].SampledAllocs );
+    ok( info->Callsites[0].SampledBytes == 1600, "got SampledBytes %I64u\n", info->Callsites[0].SampledBytes );
+    ok( info->Callsites[0].LiveAllocs == 12, "got LiveAllocs %I64u\n", info->Callsites[0].LiveAllocs );
+    ok( info->Callsites[0].LiveBytes == 1200, "got LiveBytes %I64u\n", info->Callsites[0].LiveBytes );
+    ok( info->Callsites[0].FrameCount > 0, "got FrameCount %lu\n", info->Callsites[0].FrameCount );
+
+    ptrs[4] = HeapReAlloc( heap, 0, ptrs[4], 1000 );
+    ok( !!ptrs[4], "HeapReAlloc failed, error %lu\n", GetLastError() );
+
+    settings.Enabled = FALSE;
+    ret = pHeapSetInformation( heap, HeapWineProfileInformation, &settings, sizeof(settings) );
+    ok( ret, "HeapSetInformation failed, error %lu\n", GetLastError() );
+    for (i = 5; i < ARRAY_SIZE(ptrs); i++) HeapFree( heap, 0, ptrs[i] );
+
+    size = offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] );
+    ret = pHeapQueryInformation( heap, HeapWineProfileInformation, info, size, &size );
+    ok( !ret, "HeapQueryInformation succeeded\n" );
+    ok( info->Enabled == 0, "got Enabled %lu\n", info->Enabled );
+    ok( info->TotalFrees == 5, "got TotalFrees %I64u\n", info->TotalFrees );
+    ok( info->LiveBytes == 2100, "got LiveBytes %I64d\n", info->LiveBytes );
+
+    free( info );
+    ret = HeapDestroy( heap );
+    ok( ret, "HeapDestroy failed, error %lu\n", GetLastError() );
+}
+
 START_TEST(heap)
 {
     int argc;
@@ -3767,4 +3850,5 @@ START_TEST(heap)
     }
     else win_skip( "RtlGetNtGlobalFlags not found, skipping heap debug tests\n" );
     test_heap_sizes();
+    test_heap_profile();
 }
@@ -4308,6 +4308,36 @@ static void test_PrefetchVirtualMemory(void)
         "PrefetchVirtualMemory unexpected status on 2 page-aligned entries: %ld\n", GetLastError() );
 }
 
+static void test_large_pages(void)
+{
+    SIZE_T size = GetLargePageMinimum();
+    void *mem;
+
+    if (!size)
+    {
+        skip("large pages are not supported\n");
+        return;
+    }
+
+    SetLastError(0xdeadbeef);
+    mem = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+    ok(!mem, "VirtualAlloc succeeded\n");
+    ok(GetLastError() == ERROR_INVALID_PARAMETER, "got error %lu\n", GetLastError());
+
+    /* this requires SeLockMemoryPrivilege on Windows */
+    SetLastError(0xdeadbeef);
+    mem = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (!mem)
+    {
+        ok(GetLastError() == ERROR_PRIVILEGE_NOT_HELD || GetLastError() == ERROR_NOT_SUPPORTED,
+           "got error %lu\n", GetLastError());
+        return;
+    }
+    ok(!((ULONG_PTR)mem & (size - 1)), "got unaligned address %p\n", mem);
+    memset(mem, 0x55, size);
+    ok(VirtualFree(mem, 0, MEM_RELEASE), "VirtualFree failed %lu\n", GetLastError());
+}
+
 START_TEST(virtual)
 {
     int argc;
@@ -4387,6 +4417,7 @@ START_TEST(virtual)
     test_IsBadCodePtr();
     test_write_watch();
     test_PrefetchVirtualMemory();
+    test_large_pages();
 #if defined(__i386__) || defined(__x86_64__)
     test_stack_commit();
 #endif
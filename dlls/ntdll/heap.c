@@ -33,8 +33,10 @@
 #include "windef.h"
 #include "winnt.h"
 #include "winternl.h"
+#include "ddk/wdm.h"
 #include "ntdll_misc.h"
 #include "wine/list.h"
+#include "wine/heap_profile.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(heap);
@@ -277,6 +279,49 @@ static inline struct group **bin_get_affinity_group( struct bin *bin, BYTE affin
     return bin->affinity_group_base + affinity * BLOCK_SIZE_BIN_COUNT;
 }
 
+#define HEAP_PROFILE_DEFAULT_INTERVAL (512 * 1024)
+#define HEAP_PROFILE_SITE_COUNT       1024
+#define HEAP_PROFILE_SITE_HASH_BITS   11
+#define HEAP_PROFILE_SAMPLE_BITS      13
+
+struct heap_profile_site
+{
+    ULONG            hash;
+    ULONG            frame_count;
+    void            *frames[HEAP_PROFILE_MAX_FRAMES];
+    ULONG64          sampled_allocs;
+    ULONG64          sampled_bytes;
+    ULONG64          live_allocs;
+    ULONG64          live_bytes;
+};
+
+struct heap_profile_sample
+{
+    const void      *ptr;
+    SIZE_T           size;
+    ULONG            site;
+};
+
+/* sampling allocation profiler state, allocated when profiling is first enabled on a heap */
+struct heap_profile
+{
+    RTL_SRWLOCK      lock;          /* protects the call site and sample tables */
+    LONG             enabled;
+    ULONG            interval;      /* average number of bytes between samples */
+    ULONG            seed;          /* random seed for sampling interval jitter */
+    LONG             sample_count;  /* number of live sampled blocks */
+    LONG64           countdown;     /* bytes left until next sample */
+    LONG64           total_allocs;
+    LONG64           total_frees;
+    LONG64           total_bytes;
+    LONG64           live_bytes;
+    LONG64           histogram[HEAP_PROFILE_SIZE_CLASSES];
+    ULONG            site_count;    /* site 0 collects samples that don't fit in the table */
+    USHORT           site_hash[1 << HEAP_PROFILE_SITE_HASH_BITS];
+    struct heap_profile_site   sites[HEAP_PROFILE_SITE_COUNT];
+    struct heap_profile_sample samples[1 << HEAP_PROFILE_SAMPLE_BITS];
+};
+
 struct heap
 {                                  /* win32/win64 */
     DWORD_PTR        unknown1[2];   /* 0000/0000 */
@@ -298,6 +343,7 @@ struct heap
     DWORD            magic;         /* Magic number */
     DWORD            pending_pos;   /* Position in pending free requests ring */
     struct block   **pending_free;  /* Ring buffer for pending free requests */
+    struct heap_profile *profile;   /* Allocation profiler state */
     RTL_CRITICAL_SECTION cs;
     struct entry     free_lists[FREE_LIST_COUNT];
     struct bin      *bins;
@@ -330,10 +376,13 @@ C_ASSERT( HEAP_MIN_LARGE_BLOCK_SIZE <= HEAP_INITIAL_GROW_SIZE );
 #define HEAP_CHECKING_ENABLED 0x80000000
 
 BOOL delay_heap_free = FALSE;
+ULONG heap_profile_interval = 0;
+BOOL heap_large_pages = FALSE;
 
 static struct heap *process_heap;  /* main process heap */
 
 static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block );
+static NTSTATUS heap_size( const struct heap *heap, struct block *block, SIZE_T *size );
 
 /* check if memory range a contains memory range b */
 static inline BOOL contains( const void *a, SIZE_T a_size, const void *b, SIZE_T b_size )
@@ -979,8 +1028,11 @@ static struct block *split_block( struct heap *heap, ULONG flags, struct block *
 }
 
 
-static void *allocate_region( struct heap *heap, ULONG flags, SIZE_T *region_size, SIZE_T *commit_size )
+static void *allocate_region( struct heap *heap, ULONG flags, SIZE_T *region_size, SIZE_T *commit_size,
+                              SIZE_T align )
 {
+    MEM_ADDRESS_REQUIREMENTS requirements = {0};
+    MEM_EXTENDED_PARAMETER param = {0};
     void *addr = NULL;
     NTSTATUS status;
 
@@ -991,8 +1043,17 @@ static void *allocate_region( struct heap *heap, ULONG flags, SIZE_T *region_siz
     }
 
     /* allocate the memory block */
-    if ((status = NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, region_size, MEM_RESERVE,
-                                           get_protection_type( flags ) )))
+    if (align)
+    {
+        requirements.Alignment = align;
+        param.Type = MemExtendedParameterAddressRequirements;
+        param.u.Pointer = &requirements;
+        status = NtAllocateVirtualMemoryEx( NtCurrentProcess(), &addr, region_size, MEM_RESERVE,
+                                            get_protection_type( flags ), &param, 1 );
+    }
+    else status = NtAllocateVirtualMemory( NtCurrentProcess(), &addr, 0, region_size, MEM_RESERVE,
+                                           get_protection_type( flags ) );
+    if (status)
     {
         WARN( "Could not allocate %#Ix bytes, status %#lx\n", *region_size, status );
         return NULL;
@@ -1016,7 +1077,7 @@ static NTSTATUS heap_allocate_large( struct heap *heap, ULONG flags, SIZE_T bloc
     struct block *block;
 
     if (total_size < size) return STATUS_NO_MEMORY;  /* overflow */
-    if (!(arena = allocate_region( heap, flags, &total_size, &total_size ))) return STATUS_NO_MEMORY;
+    if (!(arena = allocate_region( heap, flags, &total_size, &total_size, 0 ))) return STATUS_NO_MEMORY;
 
     block = &arena->block;
     arena->data_size = size;
@@ -1097,10 +1158,21 @@ static SUBHEAP *create_subheap( struct heap *heap, DWORD flags, SIZE_T total_siz
     SIZE_T block_size;
     SUBHEAP *subheap;
 
+    SIZE_T large_page_size = user_shared_data->LargePageMinimum, align = 0;
+
     commit_size = ROUND_SIZE( max( commit_size, REGION_ALIGN ), REGION_ALIGN - 1 );
     total_size = min( max( commit_size, total_size ), 0xffff0000 );  /* don't allow a heap larger than 4GB */
 
-    if (!(subheap = allocate_region( heap, flags, &total_size, &commit_size ))) return NULL;
+    /* when requested, align large subheaps to the large page size, so that they
+     * get backed by transparent huge pages when they are committed */
+    if (heap_large_pages && large_page_size > REGION_ALIGN && total_size >= large_page_size &&
+        total_size <= 0xffff0000 - large_page_size)
+    {
+        total_size = ROUND_SIZE( total_size, large_page_size - 1 );
+        align = large_page_size;
+    }
+
+    if (!(subheap = allocate_region( heap, flags, &total_size, &commit_size, align ))) return NULL;
 
     subheap->user_value = heap;
     subheap_set_bounds( subheap, (char *)subheap + commit_size, (char *)subheap + total_size );
@@ -1438,6 +1510,279 @@ static DWORD heap_flags_from_global_flag( DWORD flag )
     return ret;
 }
 
+static char *ntdll_start, *ntdll_end;
+
+static void heap_profile_reset_countdown( struct heap_profile *profile )
+{
+    LONG64 countdown, prev;
+
+    /* randomize the interval to avoid aliasing with periodic allocation patterns */
+    countdown = 1 + profile->interval / 2 + RtlRandom( &profile->seed ) % profile->interval;
+    do prev = profile->countdown;
+    while (InterlockedCompareExchange64( &profile->countdown, countdown, prev ) != prev);
+}
+
+static void heap_profile_reset_counter( LONG64 *counter )
+{
+    LONG64 prev;
+
+    do prev = *counter;
+    while (InterlockedCompareExchange64( counter, 0, prev ) != prev);
+}
+
+static inline ULONG heap_profile_site_hash( ULONG hash )
+{
+    return (hash * 0x9e3779b1) >> (32 - HEAP_PROFILE_SITE_HASH_BITS);
+}
+
+static inline ULONG heap_profile_sample_hash( const void *ptr )
+{
+    return ((ULONG)((ULONG_PTR)ptr >> 4) * 0x9e3779b1) >> (32 - HEAP_PROFILE_SAMPLE_BITS);
+}
+
+static struct heap_profile_site *heap_profile_get_site( struct heap_profile *profile, void **frames,
+                                                         ULONG frame_count, ULONG hash )
+{
+    const ULONG mask = (1 << HEAP_PROFILE_SITE_HASH_BITS) - 1;
+    struct heap_profile_site *site;
+    ULONG i, index;
+
+    for (i = heap_profile_site_hash( hash ); (index = profile->site_hash[i]); i = (i + 1) & mask)
+    {
+        site = profile->sites + index;
+        if (site->hash != hash || site->frame_count != frame_count) continue;
+        if (!memcmp( site->frames, frames, frame_count * sizeof(*frames) )) return site;
+    }
+
+    if (profile->site_count == HEAP_PROFILE_SITE_COUNT) return profile->sites;
+
+    index = profile->site_count++;
+    site = profile->sites + index;
+    site->hash = hash;
+    site->frame_count = frame_count;
+    memcpy( site->frames, frames, frame_count * sizeof(*frames) );
+    profile->site_hash[i] = index;
+    return site;
+}
+
+static BOOL heap_profile_remove_sample( struct heap_profile *profile, const void *ptr,
+                                        struct heap_profile_sample *sample )
+{
+    const ULONG mask = (1 << HEAP_PROFILE_SAMPLE_BITS) - 1;
+    struct heap_profile_sample *samples = profile->samples;
+    ULONG i, j, home;
+
+    for (i = heap_profile_sample_hash( ptr ); samples[i].ptr != ptr; i = (i + 1) & mask)
+        if (!samples[i].ptr) return FALSE;
+
+    *sample = samples[i];
+
+    /* shift back the following entries of the probe sequence */
+    for (j = (i + 1) & mask; samples[j].ptr; j = (j + 1) & mask)
+    {
+        home = heap_profile_sample_hash( samples[j].ptr );
+        if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) continue;
+        samples[i] = samples[j];
+        i = j;
+    }
+
+    samples[i].ptr = NULL;
+    profile->sample_count--;
+    return TRUE;
+}
+
+static void heap_profile_remove_live( struct heap_profile *profile, const void *ptr )
+{
+    struct heap_profile_sample sample;
+    struct heap_profile_site *site;
+
+    if (!heap_profile_remove_sample( profile, ptr, &sample )) return;
+    site = profile->sites + sample.site;
+    site->live_allocs--;
+    site->live_bytes -= sample.size;
+}
+
+static void heap_profile_sample( struct heap_profile *profile, const void *ptr, SIZE_T size )
+{
+    const ULONG mask = (1 << HEAP_PROFILE_SAMPLE_BITS) - 1;
+    void *frames[HEAP_PROFILE_MAX_FRAMES + 8];
+    struct heap_profile_site *site;
+    ULONG i, hash = 0, skip, frame_count;
+
+    heap_profile_reset_countdown( profile );
+
+    /* attribute the allocation to the first caller outside of ntdll */
+    frame_count = RtlCaptureStackBackTrace( 0, ARRAY_SIZE(frames), frames, NULL );
+    for (skip = 0; skip < frame_count; skip++)
+        if ((char *)frames[skip] < ntdll_start || (char *)frames[skip] >= ntdll_end) break;
+    if (skip == frame_count) skip = 0;
+    frame_count = min( frame_count - skip, HEAP_PROFILE_MAX_FRAMES );
+    for (i = 0; i < frame_count; i++) hash = hash * 31 + (ULONG_PTR)frames[skip + i];
+
+    RtlAcquireSRWLockExclusive( &profile->lock );
+
+    site = heap_profile_get_site( profile, frames + skip, frame_count, hash );
+    site->sampled_allocs++;
+    site->sampled_bytes += size;
+
+    heap_profile_remove_live( profile, ptr );
+    if (profile->sample_count < (mask + 1) / 4 * 3)
+    {
+        for (i = heap_profile_sample_hash( ptr ); profile->samples[i].ptr; i = (i + 1) & mask) {}
+        profile->samples[i].ptr = ptr;
+        profile->samples[i].size = size;
+        profile->samples[i].site = site - profile->sites;
+        profile->sample_count++;
+        site->live_allocs++;
+        site->live_bytes += size;
+    }
+
+    RtlReleaseSRWLockExclusive( &profile->lock );
+}
+
+static inline BOOL heap_profile_enabled( struct heap *heap )
+{
+    struct heap_profile *profile = heap->profile;
+    return profile && ReadNoFence( &profile->enabled );
+}
+
+static FORCEINLINE void heap_profile_alloc( struct heap_profile *profile, const void *ptr, SIZE_T size )
+{
+    LONG64 countdown;
+
+    if (!ReadNoFence( &profile->enabled )) return;
+
+    InterlockedIncrement64( &profile->total_allocs );
+    InterlockedExchangeAdd64( &profile->total_bytes, size );
+    InterlockedExchangeAdd64( &profile->live_bytes, size );
+    InterlockedIncrement64( &profile->histogram[size ? min( RtlFindMostSignificantBit( size ), HEAP_PROFILE_SIZE_CLASSES - 1 ) : 0] );
+
+    /* only the thread crossing zero takes the sample */
+    countdown = InterlockedExchangeAdd64( &profile->countdown, -(LONG64)size );
+    if (countdown > 0 && countdown <= (LONG64)size) heap_profile_sample( profile, ptr, size );
+}
+
+static void heap_profile_free( struct heap_profile *profile, const void *ptr, SIZE_T size )
+{
+    if (!ReadNoFence( &profile->enabled )) return;
+
+    InterlockedIncrement64( &profile->total_frees );
+    InterlockedExchangeAdd64( &profile->live_bytes, -(LONG64)size );
+    if (!ReadNoFence( &profile->sample_count )) return;
+
+    RtlAcquireSRWLockExclusive( &profile->lock );
+    heap_profile_remove_live( profile, ptr );
+    RtlReleaseSRWLockExclusive( &profile->lock );
+}
+
+static NTSTATUS heap_profile_enable( struct heap *heap, ULONG interval )
+{
+    struct heap_profile *profile, *prev;
+    SIZE_T size = sizeof(*profile);
+    ULONG i;
+
+    if (!ntdll_end)
+    {
+        MEMORY_BASIC_INFORMATION info;
+        IMAGE_NT_HEADERS *nt;
+
+        NtQueryVirtualMemory( NtCurrentProcess(), RtlAllocateHeap, MemoryBasicInformation, &info, sizeof(info), NULL );
+        if ((nt = RtlImageNtHeader( info.AllocationBase )))
+        {
+            ntdll_start = info.AllocationBase;
+            ntdll_end = ntdll_start + nt->OptionalHeader.SizeOfImage;
+        }
+    }
+
+    if (!(profile = heap->profile))
+    {
+        if (NtAllocateVirtualMemory( NtCurrentProcess(), (void **)&profile, 0, &size, MEM_COMMIT, PAGE_READWRITE ))
+            return STATUS_NO_MEMORY;
+        if ((prev = InterlockedCompareExchangePointer( (void **)&heap->profile, profile, NULL )))
+        {
+            size = 0;
+            NtFreeVirtualMemory( NtCurrentProcess(), (void **)&profile, &size, MEM_RELEASE );
+            profile = prev;
+        }
+    }
+
+    RtlAcquireSRWLockExclusive( &profile->lock );
+    WriteNoFence( &profile->enabled, FALSE );
+
+    /* the counters are updated without the lock by threads that saw the profiler enabled */
+    heap_profile_reset_counter( &profile->total_allocs );
+    heap_profile_reset_counter( &profile->total_frees );
+    heap_profile_reset_counter( &profile->total_bytes );
+    heap_profile_reset_counter( &profile->live_bytes );
+    for (i = 0; i < HEAP_PROFILE_SIZE_CLASSES; i++) heap_profile_reset_counter( &profile->histogram[i] );
+
+    /* the tables are only used with the lock held */
+    WriteNoFence( &profile->sample_count, 0 );
+    memset( profile->site_hash, 0, sizeof(profile->site_hash) );
+    memset( profile->sites, 0, sizeof(profile->sites) );
+    memset( profile->samples, 0, sizeof(profile->samples) );
+    profile->site_count = 1;
+
+    profile->interval = interval ? interval : HEAP_PROFILE_DEFAULT_INTERVAL;
+    profile->seed = NtGetTickCount();
+    heap_profile_reset_countdown( profile );
+    WriteNoFence( &profile->enabled, TRUE );
+    RtlReleaseSRWLockExclusive( &profile->lock );
+
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS heap_profile_query( struct heap *heap, HEAP_PROFILE_INFORMATION *info, SIZE_T size, SIZE_T *size_out )
+{
+    struct heap_profile *profile = heap->profile;
+    const struct heap_profile_site *site;
+    ULONG i, count = 0, max_count;
+    NTSTATUS status = STATUS_SUCCESS;
+    SIZE_T needed;
+
+    if (profile) RtlAcquireSRWLockShared( &profile->lock );
+
+    if (profile) for (i = 0; i < profile->site_count; i++) if (profile->sites[i].sampled_allocs) count++;
+    needed = offsetof( HEAP_PROFILE_INFORMATION, Callsites[count] );
+    if (size_out) *size_out = needed;
+
+    if (size < offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] )) status = STATUS_BUFFER_TOO_SMALL;
+    else if (!profile) memset( info, 0, offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] ) );
+    else
+    {
+        info->Enabled = ReadNoFence( &profile->enabled );
+        info->SampleInterval = profile->interval;
+        info->TotalAllocs = profile->total_allocs;
+        info->TotalFrees = profile->total_frees;
+        info->TotalBytes = profile->total_bytes;
+        info->LiveBytes = profile->live_bytes;
+        for (i = 0; i < HEAP_PROFILE_SIZE_CLASSES; i++) info->SizeHistogram[i] = profile->histogram[i];
+
+        max_count = (size - offsetof( HEAP_PROFILE_INFORMATION, Callsites[0] )) / sizeof(*info->Callsites);
+        info->CallsiteCount = 0;
+        for (i = 0, site = profile->sites; i < profile->site_count; i++, site++)
+        {
+            HEAP_PROFILE_CALLSITE *callsite;
+
+            if (!site->sampled_allocs) continue;
+            if (info->CallsiteCount == max_count) break;
+
+            callsite = info->Callsites + info->CallsiteCount++;
+            callsite->SampledAllocs = site->sampled_allocs;
+            callsite->SampledBytes = site->sampled_bytes;
+            callsite->LiveAllocs = site->live_allocs;
+            callsite->LiveBytes = site->live_bytes;
+            callsite->FrameCount = site->frame_count;
+            memset( callsite->Frames, 0, sizeof(callsite->Frames) );
+            memcpy( callsite->Frames, site->frames, site->frame_count * sizeof(*site->frames) );
+        }
+        if (info->CallsiteCount < count) status = STATUS_BUFFER_OVERFLOW;
+    }
+
+    if (profile) RtlReleaseSRWLockShared( &profile->lock );
+    return status;
+}
+
 /***********************************************************************
  *           heap_set_debug_flags
  */
@@ -1540,7 +1885,7 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
         if (!commit_size) commit_size = REGION_ALIGN;
         total_size = min( max( total_size, commit_size ), 0xffff0000 );  /* don't allow a heap larger than 4GB */
         commit_size = min( total_size, ROUND_SIZE( commit_size, REGION_ALIGN - 1 ) );
-        if (!(heap = allocate_region( NULL, flags, &total_size, &commit_size ))) return 0;
+        if (!(heap = allocate_region( NULL, flags, &total_size, &commit_size, 0 ))) return 0;
     }
 
     heap->ffeeffee      = 0xffeeffee;
@@ -1589,6 +1934,7 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
     list_add_head( &heap->subheap_list, &subheap->entry );
 
     heap_set_debug_flags( heap );
+    if (heap_profile_interval) heap_profile_enable( heap, heap_profile_interval );
 
     if (heap->flags & HEAP_GROWABLE)
     {
@@ -1692,6 +2038,11 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE handle )
         NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
     }
     valgrind_notify_free_all( &heap->subheap, heap );
+    if ((addr = heap->profile))
+    {
+        size = 0;
+        NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+    }
     if ((addr = heap->bins))
     {
         size = 0;
@@ -2087,6 +2438,7 @@ void *WINAPI DECLSPEC_HOTPATCH RtlAllocateHeap( HANDLE handle, ULONG flags, SIZE
     }
 
     if (!status) valgrind_notify_alloc( ptr, size, flags & HEAP_ZERO_MEMORY );
+    if (!status && heap->profile) heap_profile_alloc( heap->profile, ptr, size );
 
     TRACE( "handle %p, flags %#lx, size %#Ix, return %p, status %#lx.\n", handle, flags, size, ptr, status );
     heap_set_status( heap, flags, status );
@@ -2112,21 +2464,29 @@ BOOLEAN WINAPI DECLSPEC_HOTPATCH RtlFreeHeap( HANDLE handle, ULONG flags, void *
         status = STATUS_INVALID_PARAMETER;
     else if (!(block = unsafe_block_from_ptr( heap, heap_flags, ptr )))
         status = STATUS_INVALID_PARAMETER;
-    else if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
-        status = heap_free_large( heap, heap_flags, block );
-    else if (!(block = heap_delay_free( heap, heap_flags, block )))
-        status = STATUS_SUCCESS;
-    else if (!heap_free_block_lfh( heap, heap_flags, block ))
-        status = STATUS_SUCCESS;
     else
     {
-        SIZE_T block_size = block_get_size( block ), bin = BLOCK_SIZE_BIN( block_size );
+        SIZE_T size;
 
-        heap_lock( heap, heap_flags );
-        status = heap_free_block( heap, heap_flags, block );
-        heap_unlock( heap, heap_flags );
+        if (heap_profile_enabled( heap ) && !heap_size( heap, block, &size ))
+            heap_profile_free( heap->profile, ptr, size );
 
-        if (!status && heap->bins) InterlockedIncrement( &heap->bins[bin].count_freed );
+        if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
+            status = heap_free_large( heap, heap_flags, block );
+        else if (!(block = heap_delay_free( heap, heap_flags, block )))
+            status = STATUS_SUCCESS;
+        else if (!heap_free_block_lfh( heap, heap_flags, block ))
+            status = STATUS_SUCCESS;
+        else
+        {
+            SIZE_T block_size = block_get_size( block ), bin = BLOCK_SIZE_BIN( block_size );
+
+            heap_lock( heap, heap_flags );
+            status = heap_free_block( heap, heap_flags, block );
+            heap_unlock( heap, heap_flags );
+
+            if (!status && heap->bins) InterlockedIncrement( &heap->bins[bin].count_freed );
+        }
     }
 
     TRACE( "handle %p, flags %#lx, ptr %p, return %u, status %#lx.\n", handle, flags, ptr, !status, status );
@@ -2279,6 +2639,11 @@ void *WINAPI RtlReAllocateHeap( HANDLE handle, ULONG flags, void *ptr, SIZE_T si
             status = STATUS_SUCCESS;
         }
     }
+    else if (heap->profile)
+    {
+        heap_profile_free( heap->profile, ptr, old_size );
+        heap_profile_alloc( heap->profile, ret, size );
+    }
 
     TRACE( "handle %p, flags %#lx, ptr %p, size %#Ix, return %p, status %#lx.\n", handle, flags, ptr, size, ret, status );
     heap_set_status( heap, flags, status );
@@ -2586,7 +2951,7 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS i
 
     TRACE( "handle %p, info_class %u, info %p, size_in %Iu, size_out %p.\n", handle, info_class, info, size_in, size_out );
 
-    switch (info_class)
+    switch ((ULONG)info_class)  /* may be a Wine specific class */
     {
     case HeapCompatibilityInformation:
         if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_ACCESS_VIOLATION;
@@ -2595,6 +2960,10 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS i
         *(ULONG *)info = ReadNoFence( &heap->compat_info );
         return STATUS_SUCCESS;
 
+    case HeapWineProfileInformation:
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_INVALID_HANDLE;
+        return heap_profile_query( heap, info, size_in, size_out );
+
     default:
         FIXME( "HEAP_INFORMATION_CLASS %u not implemented!\n", info_class );
         return STATUS_INVALID_INFO_CLASS;
@@ -2611,7 +2980,7 @@ NTSTATUS WINAPI RtlSetHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS inf
 
     TRACE( "handle %p, info_class %u, info %p, size %Iu.\n", handle, info_class, info, size );
 
-    switch (info_class)
+    switch ((ULONG)info_class)  /* may be a Wine specific class */
     {
     case HeapCompatibilityInformation:
     {
@@ -2632,12 +3001,165 @@ NTSTATUS WINAPI RtlSetHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS inf
         return STATUS_SUCCESS;
     }
 
+    case HeapWineProfileInformation:
+    {
+        HEAP_PROFILE_SETTINGS *settings = info;
+
+        if (size < sizeof(*settings)) return STATUS_BUFFER_TOO_SMALL;
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_INVALID_HANDLE;
+        if (settings->Enabled) return heap_profile_enable( heap, settings->SampleInterval );
+        if (heap->profile) WriteNoFence( &heap->profile->enabled, FALSE );
+        return STATUS_SUCCESS;
+    }
+
     default:
         FIXME( "HEAP_INFORMATION_CLASS %u not implemented!\n", info_class );
         return STATUS_SUCCESS;
     }
 }
 
+static UNICODE_STRING heap_profile_file;
+
+static void WINAPIV heap_profile_print( HANDLE file, const char *format, ... )
+{
+    IO_STATUS_BLOCK io;
+    char buffer[512];
+    va_list args;
+    int len;
+
+    va_start( args, format );
+    len = _vsnprintf( buffer, sizeof(buffer), format, args );
+    va_end( args );
+
+    if (len < 0 || len > sizeof(buffer)) len = sizeof(buffer);
+    NtWriteFile( file, 0, NULL, NULL, &io, buffer, len, NULL, NULL );
+}
+
+static void heap_profile_dump_heap( HANDLE file, struct heap *heap, HEAP_PROFILE_INFORMATION *info, SIZE_T size )
+{
+    const HEAP_PROFILE_CALLSITE *site;
+    ULONG i, j;
+
+    if (!heap->profile || heap_profile_query( heap, info, size, NULL ) == STATUS_BUFFER_TOO_SMALL) return;
+
+    heap_profile_print( file, "heap %p interval %lu allocs %I64u frees %I64u bytes %I64u live %I64d\n",
+                        heap, info->SampleInterval, info->TotalAllocs, info->TotalFrees,
+                        info->TotalBytes, info->LiveBytes );
+    for (i = 0; i < HEAP_PROFILE_SIZE_CLASSES; i++)
+    {
+        if (!info->SizeHistogram[i]) continue;
+        heap_profile_print( file, "  size 2^%lu count %I64u\n", i, info->SizeHistogram[i] );
+    }
+    for (i = 0, site = info->Callsites; i < info->CallsiteCount; i++, site++)
+    {
+        heap_profile_print( file, "  site allocs %I64u bytes %I64u live %I64u bytes %I64u\n",
+                            site->SampledAllocs, site->SampledBytes, site->LiveAllocs, site->LiveBytes );
+        for (j = 0; j < site->FrameCount; j++) heap_profile_print( file, "    %p\n", site->Frames[j] );
+    }
+}
+
+/***********************************************************************
+ *           heap_profile_dump
+ *
+ * Append the statistics of all the profiled heaps, followed by the module
+ * list to resolve the call site addresses, to the profile dump file.
+ */
+void heap_profile_dump(void)
+{
+    SIZE_T size = offsetof( HEAP_PROFILE_INFORMATION, Callsites[HEAP_PROFILE_SITE_COUNT] );
+    HEAP_PROFILE_INFORMATION *info = NULL;
+    LDR_DATA_TABLE_ENTRY *mod;
+    LIST_ENTRY *mark, *entry;
+    OBJECT_ATTRIBUTES attr;
+    IO_STATUS_BLOCK io;
+    struct heap *heap;
+    ULONG_PTR magic;
+    HANDLE file;
+
+    if (!heap_profile_file.Length) return;
+
+    InitializeObjectAttributes( &attr, &heap_profile_file, OBJ_CASE_INSENSITIVE, 0, NULL );
+    if (NtCreateFile( &file, FILE_APPEND_DATA | SYNCHRONIZE, &attr, &io, NULL, FILE_ATTRIBUTE_NORMAL,
+                      FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_OPEN_IF,
+                      FILE_NON_DIRECTORY_FILE | FILE_SYNCHRONOUS_IO_NONALERT, NULL, 0 ))
+        return;
+    if (NtAllocateVirtualMemory( NtCurrentProcess(), (void **)&info, 0, &size, MEM_COMMIT, PAGE_READWRITE ))
+    {
+        NtClose( file );
+        return;
+    }
+
+    heap_profile_print( file, "process %04lx\n", HandleToULong( NtCurrentTeb()->ClientId.UniqueProcess ) );
+
+    RtlEnterCriticalSection( &process_heap->cs );
+    heap_profile_dump_heap( file, process_heap, info, size );
+    LIST_FOR_EACH_ENTRY( heap, &process_heap->entry, struct heap, entry )
+        heap_profile_dump_heap( file, heap, info, size );
+    RtlLeaveCriticalSection( &process_heap->cs );
+
+    /* don't hold the heap lock, the loader lock is taken first elsewhere */
+    LdrLockLoaderLock( 0, NULL, &magic );
+    mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList;
+    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    {
+        mod = CONTAINING_RECORD( entry, LDR_DATA_TABLE_ENTRY, InLoadOrderLinks );
+        heap_profile_print( file, "module %p-%p %.*ls\n", mod->DllBase, (char *)mod->DllBase + mod->SizeOfImage,
+                            (int)(mod->FullDllName.Length / sizeof(WCHAR)), mod->FullDllName.Buffer );
+    }
+    LdrUnlockLoaderLock( 0, magic );
+
+    size = 0;
+    NtFreeVirtualMemory( NtCurrentProcess(), (void **)&info, &size, MEM_RELEASE );
+    NtClose( file );
+}
+
+static HANDLE heap_profile_event;
+
+static void CALLBACK heap_profile_dump_callback( void *context, BOOLEAN timeout )
+{
+    heap_profile_dump();
+}
+
+/***********************************************************************
+ *           heap_profile_init
+ *
+ * Set the profile dump file, and create the WineHeapProfile<pid> named
+ * event that other processes can signal to request a dump.
+ */
+void heap_profile_init( const WCHAR *file )
+{
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING str;
+    WCHAR name[64];
+
+    if (!RtlDosPathNameToNtPathName_U( file, &heap_profile_file, NULL, NULL )) return;
+
+    swprintf( name, ARRAY_SIZE(name), L"\\Sessions\\%u\\BaseNamedObjects\\WineHeapProfile%04lx",
+              NtCurrentTeb()->Peb->SessionId, HandleToULong( NtCurrentTeb()->ClientId.UniqueProcess ) );
+    RtlInitUnicodeString( &str, name );
+    InitializeObjectAttributes( &attr, &str, OBJ_OPENIF, 0, NULL );
+    if (NtCreateEvent( &heap_profile_event, EVENT_ALL_ACCESS, &attr, SynchronizationEvent, FALSE ))
+        heap_profile_event = 0;
+}
+
+/***********************************************************************
+ *           heap_profile_start
+ *
+ * Start waiting for dump requests, once the process is initialized
+ * enough for the thread pool to create threads.
+ */
+void heap_profile_start(void)
+{
+    HANDLE wait;
+
+    if (!heap_profile_event) return;
+    if (RtlRegisterWait( &wait, heap_profile_event, heap_profile_dump_callback, NULL, INFINITE, WT_EXECUTEDEFAULT ))
+    {
+        NtClose( heap_profile_event );
+        heap_profile_event = 0;
+    }
+}
+
 /***********************************************************************
  *           RtlGetUserInfoHeap    (NTDLL.@)
  */
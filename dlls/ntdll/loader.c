@@ -3769,6 +3769,7 @@ void WINAPI LdrShutdownProcess(void)
     if (!detaching)
         RtlProcessFlsData( NtCurrentTeb()->FlsSlots, 1 );
 
+    if (!detaching) heap_profile_dump();
     process_detach();
 }
 
@@ -4255,7 +4256,7 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
         ANSI_STRING func_name;
         WINE_MODREF *kernel32;
         PEB *peb = NtCurrentTeb()->Peb;
-        WCHAR env_str[16];
+        WCHAR env_str[16], path[MAX_PATH];
 
         NtQueryVirtualMemory( GetCurrentProcess(), LdrInitializeThunk, MemoryBasicInformation,
                               &meminfo, sizeof(meminfo), NULL );
@@ -4277,6 +4278,21 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
             }
         }
 
+        if (get_env( L"WINE_HEAP_LARGE_PAGES", env_str, sizeof(env_str)) )
+        {
+            if (env_str[0] == L'1')
+            {
+                ERR( "Enabling large page aligned heaps.\n" );
+                heap_large_pages = TRUE;
+            }
+        }
+
+        if (get_env( L"WINE_HEAP_PROFILE", env_str, sizeof(env_str)) )
+        {
+            if ((heap_profile_interval = wcstoul( env_str, NULL, 0 )))
+                ERR( "Enabling heap allocation profiler, sample interval %lu.\n", heap_profile_interval );
+        }
+
         peb->ProcessHeap        = RtlCreateHeap( HEAP_GROWABLE, NULL, 0, 0, NULL, NULL );
 
         RtlInitializeBitMap( &tls_bitmap, peb->TlsBitmapBits, sizeof(peb->TlsBitmapBits) * 8 );
@@ -4288,6 +4304,9 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
         load_global_options();
         version_init();
 
+        if (heap_profile_interval && get_env( L"WINE_HEAP_PROFILE_FILE", path, sizeof(path) ))
+            heap_profile_init( path );
+
         get_env_var( L"WINESYSTEMDLLPATH", 0, &system_dll_path );
 
         wm = build_main_module();
@@ -4371,6 +4390,7 @@ void WINAPI LdrInitializeThunk( CONTEXT *context, ULONG_PTR unknown2, ULONG_PTR
             NtTerminateProcess( GetCurrentProcess(), status );
         }
         release_address_space();
+        heap_profile_start();
         if (wm->ldr.TlsIndex == -1) call_tls_callbacks( wm->ldr.DllBase, DLL_PROCESS_ATTACH );
         if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
         process_breakpoint();
@@ -46,6 +46,8 @@ extern UINT_PTR page_size DECLSPEC_HIDDEN;
 #endif
 
 extern BOOL delay_heap_free DECLSPEC_HIDDEN;
+extern ULONG heap_profile_interval DECLSPEC_HIDDEN;
+extern BOOL heap_large_pages DECLSPEC_HIDDEN;
 
 /* exceptions */
 extern LONG call_vectored_handlers( EXCEPTION_RECORD *rec, CONTEXT *context ) DECLSPEC_HIDDEN;
@@ -130,5 +132,8 @@ static inline void ascii_to_unicode( WCHAR *dst, const char *src, size_t len )
 /* FLS data */
 extern TEB_FLS_DATA *fls_alloc_data(void) DECLSPEC_HIDDEN;
 extern void heap_thread_detach(void) DECLSPEC_HIDDEN;
+extern void heap_profile_init( const WCHAR *file ) DECLSPEC_HIDDEN;
+extern void heap_profile_start(void) DECLSPEC_HIDDEN;
+extern void heap_profile_dump(void) DECLSPEC_HIDDEN;
 
 #endif
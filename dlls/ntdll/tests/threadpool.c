@@ -1975,6 +1975,93 @@ static void test_tp_multi_wait(void)
     CloseHandle(semaphore);
 }
 
+static DWORD WINAPI many_waits_thread(void *arg)
+{
+    WaitForSingleObject(arg, INFINITE);
+    return 0;
+}
+
+static void test_tp_many_waits(void)
+{
+    HANDLE events[200], thread, thread_event;
+    TP_CALLBACK_ENVIRON environment;
+    TP_WAIT *waits[201];
+    HANDLE semaphore;
+    NTSTATUS status;
+    TP_POOL *pool;
+    DWORD result;
+    int i;
+
+    semaphore = CreateSemaphoreW(NULL, 0, ARRAY_SIZE(waits), NULL);
+    ok(semaphore != NULL, "failed to create semaphore\n");
+    multi_wait_info.semaphore = semaphore;
+
+    pool = NULL;
+    status = pTpAllocPool(&pool, NULL);
+    ok(!status, "TpAllocPool failed with status %lx\n", status);
+    ok(pool != NULL, "expected pool != NULL\n");
+
+    memset(&environment, 0, sizeof(environment));
+    environment.Version = 1;
+    environment.Pool = pool;
+
+    /* more waits than a single NtWaitForMultipleObjects call can handle */
+    for (i = 0; i < ARRAY_SIZE(events); i++)
+    {
+        events[i] = CreateEventW(NULL, FALSE, FALSE, NULL);
+        ok(events[i] != NULL, "failed to create event %i\n", i);
+
+        waits[i] = NULL;
+        status = pTpAllocWait(&waits[i], multi_wait_cb, (void *)(DWORD_PTR)i, &environment);
+        ok(!status, "TpAllocWait failed with status %lx\n", status);
+        pTpSetWait(waits[i], events[i], NULL);
+    }
+
+    /* a thread handle mixed with the events */
+    thread_event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    thread = CreateThread(NULL, 0, many_waits_thread, thread_event, 0, NULL);
+    ok(thread != NULL, "failed to create thread\n");
+    waits[i] = NULL;
+    status = pTpAllocWait(&waits[i], multi_wait_cb, (void *)(DWORD_PTR)i, &environment);
+    ok(!status, "TpAllocWait failed with status %lx\n", status);
+    pTpSetWait(waits[i], thread, NULL);
+
+    for (i = ARRAY_SIZE(events) - 1; i >= 0; i -= 37)
+    {
+        multi_wait_info.result = ~0u;
+        SetEvent(events[i]);
+
+        result = WaitForSingleObject(semaphore, 2000);
+        ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %lu\n", result);
+        ok(multi_wait_info.result == i, "expected result %d, got %lu\n", i, multi_wait_info.result);
+    }
+
+    multi_wait_info.result = ~0u;
+    SetEvent(thread_event);
+    result = WaitForSingleObject(semaphore, 2000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %lu\n", result);
+    ok(multi_wait_info.result == ARRAY_SIZE(events), "expected result %u, got %lu\n",
+            (unsigned int)ARRAY_SIZE(events), multi_wait_info.result);
+
+    /* none of the other waits should have been satisfied */
+    result = WaitForSingleObject(semaphore, 50);
+    ok(result == WAIT_TIMEOUT, "WaitForSingleObject returned %lu\n", result);
+
+    for (i = 0; i < ARRAY_SIZE(waits); i++)
+    {
+        pTpSetWait(waits[i], NULL, NULL);
+        pTpReleaseWait(waits[i]);
+    }
+    for (i = 0; i < ARRAY_SIZE(events); i++)
+        CloseHandle(events[i]);
+
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+    CloseHandle(thread_event);
+    pTpReleasePool(pool);
+    CloseHandle(semaphore);
+}
+
 struct io_cb_ctx
 {
     unsigned int count;
@@ -2373,6 +2460,7 @@ START_TEST(threadpool)
     test_tp_window_length();
     test_tp_wait();
     test_tp_multi_wait();
+    test_tp_many_waits();
     test_tp_io();
     test_kernel32_tp_io();
 }
@@ -99,6 +99,7 @@ struct timer_queue
 
 #define THREADPOOL_WORKER_TIMEOUT 5000
 #define MAXIMUM_WAITQUEUE_OBJECTS (MAXIMUM_WAIT_OBJECTS - 1)
+#define MAXIMUM_WAITQUEUE_BATCH_OBJECTS 4095
 
 /* internal threadpool representation */
 struct threadpool
@@ -290,10 +291,15 @@ struct waitqueue_bucket
 {
     struct list             bucket_entry;
     LONG                    objcount;
+    LONG                    max_objects;
     struct list             reserved;
     struct list             waiting;
     HANDLE                  update_event;
     BOOL                    alertable;
+    /* unix side wait set, used to wait for more than MAXIMUM_WAIT_OBJECTS handles */
+    UINT64                  wait_set;
+    struct threadpool_object **objects;
+    HANDLE                 *handles;
 };
 
 /* global I/O completion queue object */
@@ -1238,17 +1244,54 @@ static void tp_timerqueue_unlock( struct threadpool_object *timer )
     RtlLeaveCriticalSection( &timerqueue.cs );
 }
 
+/***********************************************************************
+ *           waitqueue_free_bucket    (internal)
+ */
+static void waitqueue_free_bucket( struct waitqueue_bucket *bucket )
+{
+    if (bucket->wait_set)
+    {
+        struct wait_set_params params = { bucket->wait_set };
+        NTDLL_UNIX_CALL( wait_set_free, &params );
+    }
+    if (bucket->update_event) NtClose( bucket->update_event );
+    RtlFreeHeap( GetProcessHeap(), 0, bucket->objects );
+    RtlFreeHeap( GetProcessHeap(), 0, bucket->handles );
+    RtlFreeHeap( GetProcessHeap(), 0, bucket );
+}
+
+/***********************************************************************
+ *           waitqueue_wait_set_wait    (internal)
+ */
+static NTSTATUS waitqueue_wait_set_wait( struct waitqueue_bucket *bucket, DWORD count,
+                                         const LARGE_INTEGER *timeout, DWORD *index )
+{
+    struct wait_set_params params;
+    NTSTATUS status;
+
+    params.set = bucket->wait_set;
+    params.count = count;
+    params.handles = bucket->handles;
+    params.timeout = timeout;
+    params.index = count;
+    status = NTDLL_UNIX_CALL( wait_set_wait, &params );
+    *index = params.index;
+    return status;
+}
+
+static BOOL tp_waitqueue_move( struct threadpool_object *wait );
+
 /***********************************************************************
  *           waitqueue_thread_proc    (internal)
  */
 static void CALLBACK waitqueue_thread_proc( void *param )
 {
-    struct threadpool_object *objects[MAXIMUM_WAITQUEUE_OBJECTS];
-    HANDLE handles[MAXIMUM_WAITQUEUE_OBJECTS + 1];
     struct waitqueue_bucket *bucket = param;
+    struct threadpool_object **objects = bucket->objects;
+    HANDLE *handles = bucket->handles;
     struct threadpool_object *wait, *next;
     LARGE_INTEGER now, timeout;
-    DWORD num_handles;
+    DWORD num_handles, index = 0;
     NTSTATUS status;
 
     TRACE( "starting wait queue thread\n" );
@@ -1290,7 +1333,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                 if (wait->u.wait.timeout < timeout.QuadPart)
                     timeout.QuadPart = wait->u.wait.timeout;
 
-                assert( num_handles < MAXIMUM_WAITQUEUE_OBJECTS );
+                assert( num_handles < bucket->max_objects );
                 InterlockedIncrement( &wait->refcount );
                 objects[num_handles] = wait;
                 handles[num_handles] = wait->u.wait.handle;
@@ -1315,9 +1358,26 @@ static void CALLBACK waitqueue_thread_proc( void *param )
         {
             handles[num_handles] = bucket->update_event;
             RtlLeaveCriticalSection( &waitqueue.cs );
-            status = NtWaitForMultipleObjects( num_handles + 1, handles, TRUE, bucket->alertable, &timeout );
+            if (bucket->wait_set)
+                status = waitqueue_wait_set_wait( bucket, num_handles + 1, &timeout, &index );
+            else
+                status = NtWaitForMultipleObjects( num_handles + 1, handles, TRUE, bucket->alertable, &timeout );
             RtlEnterCriticalSection( &waitqueue.cs );
 
+            if (bucket->wait_set && status == STATUS_NOT_IMPLEMENTED && index < num_handles)
+            {
+                /* The handle can't be waited for in a wait set, move the wait
+                 * object to a bucket that waits with NtWaitForMultipleObjects. */
+                wait = objects[index];
+                if (wait->u.wait.bucket == bucket && !tp_waitqueue_move( wait ))
+                {
+                    RtlLeaveCriticalSection( &waitqueue.cs );
+                    timeout.QuadPart = -100 * 10000;
+                    NtWaitForSingleObject( bucket->update_event, FALSE, &timeout );
+                    RtlEnterCriticalSection( &waitqueue.cs );
+                }
+            }
+
             if (status >= STATUS_WAIT_0 && status < STATUS_WAIT_0 + num_handles)
             {
                 wait = objects[status - STATUS_WAIT_0];
@@ -1356,13 +1416,14 @@ static void CALLBACK waitqueue_thread_proc( void *param )
 
         /* Try to merge bucket with other threads. */
         if (waitqueue.num_buckets > 1 && bucket->objcount &&
-            bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS * 1 / 3)
+            bucket->objcount <= bucket->max_objects * 1 / 3)
         {
             struct waitqueue_bucket *other_bucket;
             LIST_FOR_EACH_ENTRY( other_bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
             {
                 if (other_bucket != bucket && other_bucket->objcount && other_bucket->alertable == bucket->alertable &&
-                    other_bucket->objcount + bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS * 2 / 3)
+                    other_bucket->max_objects == bucket->max_objects &&
+                    other_bucket->objcount + bucket->objcount <= other_bucket->max_objects * 2 / 3)
                 {
                     other_bucket->objcount += bucket->objcount;
                     bucket->objcount = 0;
@@ -1407,90 +1468,150 @@ static void CALLBACK waitqueue_thread_proc( void *param )
     assert( bucket->objcount == 0 );
     assert( list_empty( &bucket->reserved ) );
     assert( list_empty( &bucket->waiting ) );
-    NtClose( bucket->update_event );
-
-    RtlFreeHeap( GetProcessHeap(), 0, bucket );
+    waitqueue_free_bucket( bucket );
     RtlExitUserThread( 0 );
 }
 
 /***********************************************************************
- *           tp_waitqueue_lock    (internal)
+ *           tp_waitqueue_get_bucket    (internal)
+ *
+ * Find a bucket with a free slot, or create a new bucket and its worker
+ * thread. Must be called with waitqueue.cs held.
  */
-static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
+static NTSTATUS tp_waitqueue_get_bucket( BOOL alertable, BOOL allow_wait_set,
+                                         struct waitqueue_bucket **ret )
 {
+#ifdef _WIN64
+    struct wait_set_params params = { 0 };
+#endif
     struct waitqueue_bucket *bucket;
     NTSTATUS status;
     HANDLE thread;
-    BOOL alertable = (wait->u.wait.flags & WT_EXECUTEINIOTHREAD) != 0;
-    assert( wait->type == TP_OBJECT_TYPE_WAIT );
-
-    wait->u.wait.signaled       = 0;
-    wait->u.wait.bucket         = NULL;
-    wait->u.wait.wait_pending   = FALSE;
-    wait->u.wait.timeout        = 0;
-    wait->u.wait.handle         = INVALID_HANDLE_VALUE;
-
-    RtlEnterCriticalSection( &waitqueue.cs );
 
     /* Try to assign to existing bucket if possible. */
     LIST_FOR_EACH_ENTRY( bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
     {
-        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS && bucket->alertable == alertable)
+        if (bucket->objcount < bucket->max_objects && bucket->alertable == alertable &&
+            (allow_wait_set || !bucket->wait_set))
         {
-            list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
-            wait->u.wait.bucket = bucket;
-            bucket->objcount++;
-
-            status = STATUS_SUCCESS;
-            goto out;
+            *ret = bucket;
+            return STATUS_SUCCESS;
         }
     }
 
     /* Create a new bucket and corresponding worker thread. */
-    bucket = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*bucket) );
+    bucket = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*bucket) );
     if (!bucket)
-    {
-        status = STATUS_NO_MEMORY;
-        goto out;
-    }
+        return STATUS_NO_MEMORY;
 
     bucket->objcount = 0;
+    bucket->max_objects = MAXIMUM_WAITQUEUE_OBJECTS;
     bucket->alertable = alertable;
     list_init( &bucket->reserved );
     list_init( &bucket->waiting );
 
+#ifdef _WIN64
+    /* Wait sets can't deliver user APCs, so alertable buckets never use them.
+     * They aren't available to wow64 processes. */
+    if (allow_wait_set && !alertable && !NTDLL_UNIX_CALL( wait_set_create, &params ))
+    {
+        bucket->wait_set = params.set;
+        bucket->max_objects = MAXIMUM_WAITQUEUE_BATCH_OBJECTS;
+    }
+#endif
+
+    bucket->objects = RtlAllocateHeap( GetProcessHeap(), 0, bucket->max_objects * sizeof(*bucket->objects) );
+    bucket->handles = RtlAllocateHeap( GetProcessHeap(), 0, (bucket->max_objects + 1) * sizeof(*bucket->handles) );
+    if (!bucket->objects || !bucket->handles)
+    {
+        waitqueue_free_bucket( bucket );
+        return STATUS_NO_MEMORY;
+    }
+
     status = NtCreateEvent( &bucket->update_event, EVENT_ALL_ACCESS,
                             NULL, SynchronizationEvent, FALSE );
     if (status)
     {
-        RtlFreeHeap( GetProcessHeap(), 0, bucket );
-        goto out;
+        waitqueue_free_bucket( bucket );
+        return status;
     }
 
     status = RtlCreateUserThread( GetCurrentProcess(), NULL, FALSE, 0, 0, 0,
                                   waitqueue_thread_proc, bucket, &thread, NULL );
-    if (status == STATUS_SUCCESS)
+    if (status)
     {
-        list_add_tail( &waitqueue.buckets, &bucket->bucket_entry );
-        waitqueue.num_buckets++;
+        waitqueue_free_bucket( bucket );
+        return status;
+    }
+
+    list_add_tail( &waitqueue.buckets, &bucket->bucket_entry );
+    waitqueue.num_buckets++;
+    NtClose( thread );
+
+    *ret = bucket;
+    return STATUS_SUCCESS;
+}
+
+/***********************************************************************
+ *           tp_waitqueue_lock    (internal)
+ */
+static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
+{
+    struct waitqueue_bucket *bucket;
+    NTSTATUS status;
+    BOOL alertable = (wait->u.wait.flags & WT_EXECUTEINIOTHREAD) != 0;
+    assert( wait->type == TP_OBJECT_TYPE_WAIT );
+
+    wait->u.wait.signaled       = 0;
+    wait->u.wait.bucket         = NULL;
+    wait->u.wait.wait_pending   = FALSE;
+    wait->u.wait.timeout        = 0;
+    wait->u.wait.handle         = INVALID_HANDLE_VALUE;
 
+    RtlEnterCriticalSection( &waitqueue.cs );
+
+    if (!(status = tp_waitqueue_get_bucket( alertable, TRUE, &bucket )))
+    {
         list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
         wait->u.wait.bucket = bucket;
         bucket->objcount++;
-
-        NtClose( thread );
-    }
-    else
-    {
-        NtClose( bucket->update_event );
-        RtlFreeHeap( GetProcessHeap(), 0, bucket );
     }
 
-out:
     RtlLeaveCriticalSection( &waitqueue.cs );
     return status;
 }
 
+/***********************************************************************
+ *           tp_waitqueue_move    (internal)
+ *
+ * Move a wait object out of a wait set bucket into a regular bucket.
+ * Must be called with waitqueue.cs held.
+ */
+static BOOL tp_waitqueue_move( struct threadpool_object *wait )
+{
+    struct waitqueue_bucket *bucket = wait->u.wait.bucket, *new_bucket;
+    NTSTATUS status;
+
+    assert( wait->type == TP_OBJECT_TYPE_WAIT );
+
+    if ((status = tp_waitqueue_get_bucket( bucket->alertable, FALSE, &new_bucket )))
+    {
+        ERR( "failed to move wait object %p to a new bucket, status %#lx\n", wait, status );
+        return FALSE;
+    }
+
+    TRACE( "moving wait object %p with handle %p to bucket %p\n", wait, wait->u.wait.handle, new_bucket );
+
+    list_remove( &wait->u.wait.wait_entry );
+    list_add_tail( &new_bucket->waiting, &wait->u.wait.wait_entry );
+    wait->u.wait.bucket = new_bucket;
+    bucket->objcount--;
+    new_bucket->objcount++;
+
+    NtSetEvent( new_bucket->update_event, NULL );
+    return TRUE;
+}
+
 /***********************************************************************
  *           tp_waitqueue_unlock    (internal)
  */
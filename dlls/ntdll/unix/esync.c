@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -35,6 +36,9 @@
 # include <sys/stat.h>
 #endif
 #include <poll.h>
+#ifdef HAVE_SYS_EPOLL_H
+# include <sys/epoll.h>
+#endif
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -1310,6 +1314,297 @@ NTSTATUS esync_signal_and_wait( HANDLE signal, HANDLE wait, BOOLEAN alertable,
     return esync_wait_objects( 1, &wait, TRUE, alertable, timeout );
 }
 
+/* Wait sets allow a single thread to wait for any of a large number of esync
+ * objects. The eventfds stay registered with a persistent epoll instance
+ * between waits, so a wait only costs a syscall for handles that were added or
+ * removed since the previous one.
+ *
+ * Each entry registers its own duplicate of the object's fd. The eventfd
+ * description is shared with the server and other handles, so an epoll
+ * registration of the object's fd itself could neither be removed once the
+ * handle is closed nor told apart from a new object reusing the fd number. */
+
+struct wait_set_entry
+{
+    int fd;         /* the object's fd, part of the key */
+    int dup_fd;     /* our duplicate registered with epoll, or -1 */
+    HANDLE handle;
+    void *shm;
+    DWORD index;
+};
+
+struct esync_wait_set
+{
+    int epoll_fd;
+    unsigned int count;                 /* number of registered entries */
+    unsigned int size;                  /* allocated size of the arrays */
+    struct wait_set_entry *registered;  /* registered entries, sorted by key */
+    struct wait_set_entry *pending;     /* entries for the current wait, sorted by key */
+};
+
+static int compare_wait_set_key( const void *a, const void *b )
+{
+    const struct wait_set_entry *entry1 = a, *entry2 = b;
+    if (entry1->fd != entry2->fd) return entry1->fd - entry2->fd;
+    if (entry1->handle != entry2->handle) return entry1->handle < entry2->handle ? -1 : 1;
+    return 0;
+}
+
+static int compare_wait_set_entry( const void *a, const void *b )
+{
+    const struct wait_set_entry *entry1 = a, *entry2 = b;
+    int ret;
+
+    if ((ret = compare_wait_set_key( a, b ))) return ret;
+    if (entry1->shm != entry2->shm) return entry1->shm < entry2->shm ? -1 : 1;
+    return 0;
+}
+
+static void wait_set_remove( struct esync_wait_set *set, struct wait_set_entry *entry )
+{
+    if (entry->dup_fd == -1) return;
+    epoll_ctl( set->epoll_fd, EPOLL_CTL_DEL, entry->dup_fd, NULL );
+    close( entry->dup_fd );
+    entry->dup_fd = -1;
+}
+
+NTSTATUS esync_wait_set_create( struct esync_wait_set **ret )
+{
+#ifdef HAVE_EPOLL_CREATE
+    struct esync_wait_set *set;
+
+    if (!do_esync()) return STATUS_NOT_SUPPORTED;
+
+    if (!(set = calloc( 1, sizeof(*set) ))) return STATUS_NO_MEMORY;
+    if ((set->epoll_fd = epoll_create( 1 )) == -1)
+    {
+        NTSTATUS status = errno_to_status( errno );
+        free( set );
+        return status;
+    }
+    fcntl( set->epoll_fd, F_SETFD, FD_CLOEXEC );
+
+    TRACE( "created wait set %p, epoll fd %d\n", set, set->epoll_fd );
+    *ret = set;
+    return STATUS_SUCCESS;
+#else
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
+
+void esync_wait_set_free( struct esync_wait_set *set )
+{
+    unsigned int i;
+
+    TRACE( "%p\n", set );
+
+    for (i = 0; i < set->count; i++)
+        if (set->registered[i].dup_fd != -1) close( set->registered[i].dup_fd );
+    close( set->epoll_fd );
+    free( set->registered );
+    free( set->pending );
+    free( set );
+}
+
+#ifdef HAVE_EPOLL_CREATE
+
+static NTSTATUS wait_set_grow( struct esync_wait_set *set, unsigned int count )
+{
+    struct wait_set_entry *registered, *pending;
+    unsigned int new_size = max( 64, set->size );
+
+    if (count <= set->size) return STATUS_SUCCESS;
+    while (new_size < count) new_size *= 2;
+
+    if (!(registered = realloc( set->registered, new_size * sizeof(*registered) )))
+        return STATUS_NO_MEMORY;
+    set->registered = registered;
+    if (!(pending = realloc( set->pending, new_size * sizeof(*pending) )))
+        return STATUS_NO_MEMORY;
+    set->pending = pending;
+    set->size = new_size;
+    return STATUS_SUCCESS;
+}
+
+/* Bring the epoll registrations in line with set->pending, which must be
+ * sorted. On failure, all registrations are dropped. */
+static NTSTATUS wait_set_update( struct esync_wait_set *set, unsigned int count )
+{
+    struct epoll_event event;
+    unsigned int i = 0, j = 0, k;
+    NTSTATUS status;
+    int cmp;
+
+    while (i < set->count || j < count)
+    {
+        struct wait_set_entry *old = i < set->count ? &set->registered[i] : NULL;
+        struct wait_set_entry *new = j < count ? &set->pending[j] : NULL;
+
+        cmp = old && new ? compare_wait_set_entry( old, new ) : 0;
+        if (old && new && !cmp && old->dup_fd != -1)
+        {
+            new->dup_fd = old->dup_fd;
+            i++;
+            j++;
+            continue;
+        }
+        if (old && (!new || cmp <= 0))
+        {
+            wait_set_remove( set, old );
+            i++;
+            continue;
+        }
+
+        if ((new->dup_fd = fcntl( new->fd, F_DUPFD_CLOEXEC, 0 )) == -1)
+            goto error;
+        event.events = EPOLLIN;
+        event.data.u64 = ((ULONG64)HandleToULong( new->handle ) << 32) | (unsigned int)new->fd;
+        if (epoll_ctl( set->epoll_fd, EPOLL_CTL_ADD, new->dup_fd, &event ) == -1)
+        {
+            close( new->dup_fd );
+            goto error;
+        }
+        j++;
+    }
+
+    memcpy( set->registered, set->pending, count * sizeof(*set->pending) );
+    set->count = count;
+    return STATUS_SUCCESS;
+
+error:
+    status = errno_to_status( errno );
+    ERR( "failed to register fd %d: %s\n", set->pending[j].fd, strerror( errno ) );
+    for (k = 0; k < j; k++) wait_set_remove( set, &set->pending[k] );
+    for (k = i; k < set->count; k++) wait_set_remove( set, &set->registered[k] );
+    set->count = 0;
+    return status;
+}
+
+#endif
+
+/* Waits for any of the handles to become signaled. STATUS_NOT_IMPLEMENTED
+ * means that the object at *index can't be waited on with esync, and the
+ * caller needs to wait for it in some other way. */
+NTSTATUS esync_wait_set_wait( struct esync_wait_set *set, DWORD count, const HANDLE *handles,
+                              const LARGE_INTEGER *timeout, DWORD *index )
+{
+#ifdef HAVE_EPOLL_CREATE
+    struct epoll_event events[64];
+    struct wait_set_entry key, *entry;
+    ULONGLONG end = 0;
+    LARGE_INTEGER now;
+    struct esync *obj;
+    int64_t value;
+    NTSTATUS ret;
+    int i, n, ms;
+
+    if ((ret = wait_set_grow( set, count ))) return ret;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((ret = get_object( handles[i], &obj )))
+        {
+            *index = i;
+            return ret;
+        }
+        if (obj->type == ESYNC_MUTEX && ((struct mutex *)obj->shm)->tid == GetCurrentThreadId())
+        {
+            ((struct mutex *)obj->shm)->count++;
+            return STATUS_WAIT_0 + i;
+        }
+        set->pending[i].fd = obj->fd;
+        set->pending[i].dup_fd = -1;
+        set->pending[i].handle = handles[i];
+        set->pending[i].shm = obj->shm;
+        set->pending[i].index = i;
+    }
+    qsort( set->pending, count, sizeof(*set->pending), compare_wait_set_entry );
+    if ((ret = wait_set_update( set, count ))) return ret;
+
+    if (timeout && timeout->QuadPart != TIMEOUT_INFINITE)
+    {
+        NtQuerySystemTime( &now );
+        end = timeout->QuadPart >= 0 ? timeout->QuadPart : now.QuadPart - timeout->QuadPart;
+    }
+    else timeout = NULL;
+
+    TRACE( "waiting for any of %u handles in set %p\n", (unsigned int)count, set );
+
+    for (;;)
+    {
+        if (timeout)
+        {
+            LONGLONG timeleft = update_timeout( end );
+            /* round up, so that we don't spin for sub-millisecond timeouts */
+            ms = min( (timeleft + TICKSPERMSEC - 1) / TICKSPERMSEC, INT_MAX );
+        }
+        else ms = -1;
+
+        n = epoll_wait( set->epoll_fd, events, ARRAY_SIZE(events), ms );
+        if (n == -1)
+        {
+            if (errno == EINTR) continue;
+            ERR( "epoll_wait failed: %s\n", strerror( errno ) );
+            return errno_to_status( errno );
+        }
+        if (!n)
+        {
+            if (timeout && !update_timeout( end ))
+            {
+                TRACE( "Wait timed out.\n" );
+                return STATUS_TIMEOUT;
+            }
+            continue;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            key.fd = (unsigned int)events[i].data.u64;
+            key.handle = ULongToHandle( events[i].data.u64 >> 32 );
+            if (!(entry = bsearch( &key, set->registered, set->count,
+                                   sizeof(*set->registered), compare_wait_set_key )))
+                continue;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                ERR( "Polling on fd %d returned %#x.\n", entry->fd, events[i].events );
+                return STATUS_INVALID_HANDLE;
+            }
+            if (!(obj = get_cached_object( entry->handle )) || obj->fd != entry->fd || obj->shm != entry->shm)
+            {
+                /* The handle was closed during the wait; stop watching the
+                 * old object, so that it doesn't wake us up again. */
+                TRACE( "Dropping stale handle %p [%u].\n", entry->handle, (unsigned int)entry->index );
+                wait_set_remove( set, entry );
+                continue;
+            }
+
+            if (obj->type == ESYNC_MANUAL_EVENT || obj->type == ESYNC_MANUAL_SERVER
+                    || obj->type == ESYNC_QUEUE)
+            {
+                struct pollfd pollfd = { .fd = obj->fd, .events = POLLIN };
+
+                /* The object may have been reset since epoll_wait() returned. */
+                if (poll( &pollfd, 1, 0 ) != 1) continue;
+                TRACE( "Woken up by handle %p [%u].\n", entry->handle, (unsigned int)entry->index );
+                return STATUS_WAIT_0 + entry->index;
+            }
+            if (read( obj->fd, &value, sizeof(value) ) == sizeof(value))
+            {
+                TRACE( "Woken up by handle %p [%u].\n", entry->handle, (unsigned int)entry->index );
+                if (update_grabbed_object( obj ))
+                    return STATUS_ABANDONED_WAIT_0 + entry->index;
+                return STATUS_WAIT_0 + entry->index;
+            }
+        }
+
+        /* Someone else grabbed the objects that woke us; keep waiting. */
+    }
+#else
+    return STATUS_NOT_SUPPORTED;
+#endif
+}
+
 void esync_init(void)
 {
     struct stat st;
@@ -50,6 +50,12 @@ extern NTSTATUS esync_wait_objects( DWORD count, const HANDLE *handles, BOOLEAN
 extern NTSTATUS esync_signal_and_wait( HANDLE signal, HANDLE wait, BOOLEAN alertable,
     const LARGE_INTEGER *timeout ) DECLSPEC_HIDDEN;
 
+struct esync_wait_set;
+extern NTSTATUS esync_wait_set_create( struct esync_wait_set **set ) DECLSPEC_HIDDEN;
+extern void esync_wait_set_free( struct esync_wait_set *set ) DECLSPEC_HIDDEN;
+extern NTSTATUS esync_wait_set_wait( struct esync_wait_set *set, DWORD count, const HANDLE *handles,
+                                     const LARGE_INTEGER *timeout, DWORD *index ) DECLSPEC_HIDDEN;
+
 
 /* We have to synchronize on the fd cache mutex so that our calls to receive_fd
  * don't race with theirs. It looks weird, I know.
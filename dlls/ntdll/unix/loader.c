@@ -2152,6 +2152,9 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     system_time_precise,
     is_pc_in_native_so,
     debugstr_pc,
+    wait_set_create,
+    wait_set_free,
+    wait_set_wait,
 };
 
 BOOL disable_sfn;
@@ -1789,6 +1789,51 @@ NTSTATUS system_time_precise( void *args )
 }
 
 
+/******************************************************************************
+ *              wait_set_create
+ *
+ * Create a set for waiting on a large number of handles at once; only
+ * supported with esync.
+ */
+NTSTATUS wait_set_create( void *args )
+{
+    struct wait_set_params *params = args;
+    struct esync_wait_set *set;
+    NTSTATUS status;
+
+    if (!do_esync()) return STATUS_NOT_SUPPORTED;
+    if (!(status = esync_wait_set_create( &set ))) params->set = (UINT_PTR)set;
+    return status;
+}
+
+
+/******************************************************************************
+ *              wait_set_free
+ */
+NTSTATUS wait_set_free( void *args )
+{
+    struct wait_set_params *params = args;
+
+    esync_wait_set_free( (struct esync_wait_set *)(UINT_PTR)params->set );
+    return STATUS_SUCCESS;
+}
+
+
+/******************************************************************************
+ *              wait_set_wait
+ *
+ * Wait for any of params->handles, without the MAXIMUM_WAIT_OBJECTS limit.
+ * The wait is not alertable.
+ */
+NTSTATUS wait_set_wait( void *args )
+{
+    struct wait_set_params *params = args;
+
+    return esync_wait_set_wait( (struct esync_wait_set *)(UINT_PTR)params->set, params->count,
+                                params->handles, params->timeout, &params->index );
+}
+
+
 /******************************************************************************
  *              NtCreateKeyedEvent (NTDLL.@)
  */
@@ -65,6 +65,10 @@
 #endif
 
 #include <sys/uio.h>
+#ifdef __linux__
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+#endif
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -159,6 +163,7 @@ static pthread_mutex_t virtual_mutex;
 static const UINT page_shift = 12;
 static const UINT_PTR page_mask = 0xfff;
 static const UINT_PTR granularity_mask = 0xffff;
+static size_t large_page_size;  /* transparent huge page size, 0 if not available */
 
 /* Note: these are Windows limits, you cannot change them. */
 #ifdef __i386__
@@ -209,6 +214,10 @@ static const size_t pages_vprot_shift = 20;
 static const size_t pages_vprot_mask = (1 << 20) - 1;
 static size_t pages_vprot_size;
 static BYTE **pages_vprot;
+/* per-directory flag set when all the pages of the directory have the same
+ * protection byte; the directory contents are not up to date in that case */
+static WORD *pages_vprot_uniform;
+#define VPROT_UNIFORM 0x100
 #else  /* on 32-bit we use a simple array with one byte per page */
 static BYTE *pages_vprot;
 #endif
@@ -218,6 +227,81 @@ static int pagemap_fd, pagemap_reset_fd, clear_refs_fd;
 #define PAGE_FLAGS_BUFFER_LENGTH 1024
 #define PM_SOFT_DIRTY_PAGE (1ull << 57)
 
+#ifdef __linux__
+
+/* userfaultfd asynchronous write protection and the PAGEMAP_SCAN ioctl (Linux 6.7).
+ * Writes to write-protected pages are resolved by the kernel without a fault
+ * reaching user space, and PAGEMAP_SCAN reports and re-protects written pages. */
+static int uffd_fd = -1;
+
+#define UFFD_API_VERSION                0xaa
+#define UFFD_FEATURE_WP_UNPOPULATED     (1 << 13)
+#define UFFD_FEATURE_WP_ASYNC           (1 << 15)
+#define UFFD_REGISTER_MODE_WP           (1 << 1)
+#define UFFD_WRITEPROTECT_MODE_WP       (1 << 0)
+
+struct uffd_range
+{
+    UINT64 start;
+    UINT64 len;
+};
+
+struct uffd_api
+{
+    UINT64 api;
+    UINT64 features;
+    UINT64 ioctls;
+};
+
+struct uffd_register
+{
+    struct uffd_range range;
+    UINT64 mode;
+    UINT64 ioctls;
+};
+
+struct uffd_writeprotect
+{
+    struct uffd_range range;
+    UINT64 mode;
+};
+
+#define UFFD_IOCTL_API              _IOWR( 0xaa, 0x3f, struct uffd_api )
+#define UFFD_IOCTL_REGISTER         _IOWR( 0xaa, 0x00, struct uffd_register )
+#define UFFD_IOCTL_WRITEPROTECT     _IOWR( 0xaa, 0x06, struct uffd_writeprotect )
+
+#define PM_PAGE_IS_WRITTEN          (1 << 1)
+#define PM_SCAN_WP_MATCHING         (1 << 0)
+#define PM_SCAN_CHECK_WPASYNC       (1 << 1)
+
+struct pm_page_region
+{
+    UINT64 start;
+    UINT64 end;
+    UINT64 categories;
+};
+
+struct pm_scan_arg
+{
+    UINT64 size;
+    UINT64 flags;
+    UINT64 start;
+    UINT64 end;
+    UINT64 walk_end;
+    UINT64 vec;
+    UINT64 vec_len;
+    UINT64 max_pages;
+    UINT64 category_inverted;
+    UINT64 category_mask;
+    UINT64 category_anyof_mask;
+    UINT64 return_mask;
+};
+
+#define PM_IOCTL_PAGEMAP_SCAN       _IOWR( 'f', 16, struct pm_scan_arg )
+
+#endif  /* __linux__ */
+
+static void register_write_watches( void *base, SIZE_T size );
 static void reset_write_watches( void *base, SIZE_T size );
 
 static struct file_view *view_block_start, *view_block_end, *next_free_view;
@@ -945,6 +1029,38 @@ static inline int is_view_valloc( const struct file_view *view )
     return !(view->protect & (SEC_FILE | SEC_RESERVE | SEC_COMMIT));
 }
 
+#ifdef _WIN64
+/***********************************************************************
+ *           get_vprot_dir
+ *
+ * Return the page protection bytes of a directory, filling them in first
+ * if the directory was uniform.
+ */
+static BYTE *get_vprot_dir( size_t dir )
+{
+    if (pages_vprot_uniform[dir])
+    {
+        memset( pages_vprot[dir], (BYTE)pages_vprot_uniform[dir], pages_vprot_mask + 1 );
+        pages_vprot_uniform[dir] = 0;
+    }
+    return pages_vprot[dir];
+}
+
+
+/***********************************************************************
+ *           set_vprot_dir_uniform
+ *
+ * Mark a whole directory as having the same protection byte.
+ */
+static void set_vprot_dir_uniform( size_t dir, BYTE vprot )
+{
+    /* release the memory used by the byte array, it will be filled again if needed */
+    if (!pages_vprot_uniform[dir]) madvise( pages_vprot[dir], pages_vprot_mask + 1, MADV_DONTNEED );
+    pages_vprot_uniform[dir] = VPROT_UNIFORM | vprot;
+}
+#endif
+
+
 /***********************************************************************
  *           get_page_vprot
  *
@@ -957,6 +1073,7 @@ static BYTE get_page_vprot( const void *addr )
 #ifdef _WIN64
     if ((idx >> pages_vprot_shift) >= pages_vprot_size) return 0;
     if (!pages_vprot[idx >> pages_vprot_shift]) return 0;
+    if (pages_vprot_uniform[idx >> pages_vprot_shift]) return (BYTE)pages_vprot_uniform[idx >> pages_vprot_shift];
     return pages_vprot[idx >> pages_vprot_shift][idx & pages_vprot_mask];
 #else
     return pages_vprot[idx];
@@ -976,7 +1093,7 @@ static SIZE_T get_vprot_range_size( char *base, SIZE_T size, BYTE mask, BYTE *vp
 {
     static const UINT_PTR word_from_byte = (UINT_PTR)0x101010101010101;
     static const UINT_PTR index_align_mask = sizeof(UINT_PTR) - 1;
-    SIZE_T curr_idx, start_idx, end_idx, aligned_start_idx;
+    SIZE_T curr_idx, start_idx, end_idx, chunk_end_idx;
     UINT_PTR vprot_word, mask_word;
     const BYTE *vprot_ptr;
 
@@ -985,37 +1102,38 @@ static SIZE_T get_vprot_range_size( char *base, SIZE_T size, BYTE mask, BYTE *vp
     curr_idx = start_idx = (size_t)base >> page_shift;
     end_idx = start_idx + (size >> page_shift);
 
-    aligned_start_idx = (start_idx + index_align_mask) & ~index_align_mask;
-    if (aligned_start_idx > end_idx) aligned_start_idx = end_idx;
-
-#ifdef _WIN64
-    vprot_ptr = pages_vprot[curr_idx >> pages_vprot_shift] + (curr_idx & pages_vprot_mask);
-#else
-    vprot_ptr = pages_vprot + curr_idx;
-#endif
-    *vprot = *vprot_ptr;
-
-    /* Page count page table is at least the multiples of sizeof(UINT_PTR)
-     * so we don't have to worry about crossing the boundary on unaligned idx values. */
-
-    for (; curr_idx < aligned_start_idx; ++curr_idx, ++vprot_ptr)
-        if ((*vprot ^ *vprot_ptr) & mask) return (curr_idx - start_idx) << page_shift;
-
+    *vprot = get_page_vprot( base );
     vprot_word = word_from_byte * *vprot;
     mask_word = word_from_byte * mask;
-    for (; curr_idx < end_idx; curr_idx += sizeof(UINT_PTR), vprot_ptr += sizeof(UINT_PTR))
+
+    while (curr_idx < end_idx)
     {
 #ifdef _WIN64
-        if (!(curr_idx & pages_vprot_mask)) vprot_ptr = pages_vprot[curr_idx >> pages_vprot_shift];
-#endif
-        if ((vprot_word ^ *(UINT_PTR *)vprot_ptr) & mask_word)
+        size_t dir = curr_idx >> pages_vprot_shift;
+
+        chunk_end_idx = min( end_idx, (dir + 1) << pages_vprot_shift );
+        if (pages_vprot_uniform[dir])
         {
-            for (; curr_idx < end_idx; ++curr_idx, ++vprot_ptr)
-                if ((*vprot ^ *vprot_ptr) & mask) break;
-            return (curr_idx - start_idx) << page_shift;
+            /* the whole directory matches or differs at once */
+            if ((*vprot ^ pages_vprot_uniform[dir]) & mask) break;
+            curr_idx = chunk_end_idx;
+            continue;
         }
+        vprot_ptr = pages_vprot[dir] + (curr_idx & pages_vprot_mask);
+#else
+        chunk_end_idx = end_idx;
+        vprot_ptr = pages_vprot + curr_idx;
+#endif
+        for (; curr_idx < chunk_end_idx && (curr_idx & index_align_mask); ++curr_idx, ++vprot_ptr)
+            if ((*vprot ^ *vprot_ptr) & mask) return (curr_idx - start_idx) << page_shift;
+
+        for (; curr_idx + sizeof(UINT_PTR) <= chunk_end_idx; curr_idx += sizeof(UINT_PTR), vprot_ptr += sizeof(UINT_PTR))
+            if ((vprot_word ^ *(UINT_PTR *)vprot_ptr) & mask_word) break;
+
+        for (; curr_idx < chunk_end_idx; ++curr_idx, ++vprot_ptr)
+            if ((*vprot ^ *vprot_ptr) & mask) return (curr_idx - start_idx) << page_shift;
     }
-    return size;
+    return min( size, (curr_idx - start_idx) << page_shift );
 }
 
 /***********************************************************************
@@ -1029,13 +1147,15 @@ static void set_page_vprot( const void *addr, size_t size, BYTE vprot )
     size_t end = ((size_t)addr + size + page_mask) >> page_shift;
 
 #ifdef _WIN64
-    while (idx >> pages_vprot_shift != end >> pages_vprot_shift)
+    while (idx < end)
     {
-        size_t dir_size = pages_vprot_mask + 1 - (idx & pages_vprot_mask);
-        memset( pages_vprot[idx >> pages_vprot_shift] + (idx & pages_vprot_mask), vprot, dir_size );
+        size_t dir = idx >> pages_vprot_shift;
+        size_t dir_size = min( pages_vprot_mask + 1 - (idx & pages_vprot_mask), end - idx );
+
+        if (dir_size == pages_vprot_mask + 1) set_vprot_dir_uniform( dir, vprot );
+        else memset( get_vprot_dir( dir ) + (idx & pages_vprot_mask), vprot, dir_size );
         idx += dir_size;
     }
-    memset( pages_vprot[idx >> pages_vprot_shift] + (idx & pages_vprot_mask), vprot, end - idx );
 #else
     memset( pages_vprot + idx, vprot, end - idx );
 #endif
@@ -1049,18 +1169,37 @@ static void set_page_vprot( const void *addr, size_t size, BYTE vprot )
  */
 static void set_page_vprot_bits( const void *addr, size_t size, BYTE set, BYTE clear )
 {
+    static const UINT_PTR word_from_byte = (UINT_PTR)0x101010101010101;
+    UINT_PTR set_word = word_from_byte * set, clear_word = word_from_byte * clear;
     size_t idx = (size_t)addr >> page_shift;
     size_t end = ((size_t)addr + size + page_mask) >> page_shift;
+    size_t chunk_end;
+    BYTE *ptr;
 
-#ifdef _WIN64
-    for ( ; idx < end; idx++)
+    while (idx < end)
     {
-        BYTE *ptr = pages_vprot[idx >> pages_vprot_shift] + (idx & pages_vprot_mask);
-        *ptr = (*ptr & ~clear) | set;
-    }
+#ifdef _WIN64
+        size_t dir = idx >> pages_vprot_shift;
+
+        chunk_end = min( end, (dir + 1) << pages_vprot_shift );
+        if (pages_vprot_uniform[dir] && chunk_end - idx == pages_vprot_mask + 1)
+        {
+            pages_vprot_uniform[dir] = VPROT_UNIFORM | (((BYTE)pages_vprot_uniform[dir] & ~clear) | set);
+            idx = chunk_end;
+            continue;
+        }
+        ptr = get_vprot_dir( dir ) + (idx & pages_vprot_mask);
 #else
-    for ( ; idx < end; idx++) pages_vprot[idx] = (pages_vprot[idx] & ~clear) | set;
+        chunk_end = end;
+        ptr = pages_vprot + idx;
 #endif
+        for (; idx < chunk_end && (idx & (sizeof(UINT_PTR) - 1)); idx++, ptr++)
+            *ptr = (*ptr & ~clear) | set;
+        for (; idx + sizeof(UINT_PTR) <= chunk_end; idx += sizeof(UINT_PTR), ptr += sizeof(UINT_PTR))
+            *(UINT_PTR *)ptr = (*(UINT_PTR *)ptr & ~clear_word) | set_word;
+        for (; idx < chunk_end; idx++, ptr++)
+            *ptr = (*ptr & ~clear) | set;
+    }
 }
 
 
@@ -1642,6 +1781,7 @@ static NTSTATUS create_view( struct file_view **view_ret, void *base, size_t siz
     if (vprot & VPROT_WRITEWATCH && use_kernel_writewatch)
     {
         madvise( view->base, view->size, MADV_NOHUGEPAGE );
+        register_write_watches( view->base, view->size );
         reset_write_watches( view->base, view->size );
     }
 
@@ -1820,6 +1960,31 @@ static void update_write_watches( void *base, size_t size, size_t accessed_size
 }
 
 
+/***********************************************************************
+ *           register_write_watches
+ *
+ * Register a memory range for kernel write tracking. This needs to be
+ * done again every time the range is remapped.
+ */
+static void register_write_watches( void *base, SIZE_T size )
+{
+#ifdef __linux__
+    if (uffd_fd != -1)
+    {
+        struct uffd_register reg;
+
+        reg.range.start = (ULONG_PTR)base;
+        reg.range.len = size;
+        reg.mode = UFFD_REGISTER_MODE_WP;
+        reg.ioctls = 0;
+        if (ioctl( uffd_fd, UFFD_IOCTL_REGISTER, &reg ) == -1)
+            ERR( "Could not register %p-%p for write protection, error %s.\n",
+                 base, (char *)base + size, strerror(errno) );
+    }
+#endif
+}
+
+
 /***********************************************************************
  *           reset_write_watches
  *
@@ -1827,6 +1992,20 @@ static void update_write_watches( void *base, size_t size, size_t accessed_size
  */
 static void reset_write_watches( void *base, SIZE_T size )
 {
+#ifdef __linux__
+    if (uffd_fd != -1)
+    {
+        struct uffd_writeprotect wp;
+
+        wp.range.start = (ULONG_PTR)base;
+        wp.range.len = size;
+        wp.mode = UFFD_WRITEPROTECT_MODE_WP;
+        if (ioctl( uffd_fd, UFFD_IOCTL_WRITEPROTECT, &wp ) == -1)
+            ERR( "Could not write protect %p-%p, error %s.\n",
+                 base, (char *)base + size, strerror(errno) );
+        return;
+    }
+#endif
     if (use_kernel_writewatch)
     {
         char buffer[17];
@@ -2395,7 +2574,10 @@ static NTSTATUS decommit_pages( struct file_view *view, size_t start, size_t siz
     if (anon_mmap_fixed( (char *)view->base + start, size, PROT_NONE, 0 ) != MAP_FAILED)
     {
         if (use_kernel_writewatch && view->protect & VPROT_WRITEWATCH)
+        {
             madvise( view->base, view->size, MADV_NOHUGEPAGE );
+            register_write_watches( (char *)view->base + start, size );
+        }
 
         set_page_vprot_bits( (char *)view->base + start, size, 0, VPROT_COMMITTED );
         return STATUS_SUCCESS;
@@ -2968,6 +3150,135 @@ static int alloc_virtual_heap( void *base, SIZE_T size, void *arg )
     return (alloc->base != MAP_FAILED);
 }
 
+#ifdef __linux__
+/***********************************************************************
+ *           init_uffd_writewatch
+ *
+ * Check for userfaultfd asynchronous write protection and PAGEMAP_SCAN.
+ */
+static BOOL init_uffd_writewatch(void)
+{
+#ifdef __NR_userfaultfd
+    struct uffd_api api;
+    struct pm_scan_arg arg;
+    int fd;
+
+    if ((fd = syscall( __NR_userfaultfd, O_CLOEXEC | O_NONBLOCK )) == -1)
+    {
+        TRACE( "userfaultfd not available, error %s.\n", strerror(errno) );
+        return FALSE;
+    }
+    api.api = UFFD_API_VERSION;
+    api.features = UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED;
+    api.ioctls = 0;
+    if (ioctl( fd, UFFD_IOCTL_API, &api ) == -1 ||
+        (api.features & (UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED)) !=
+                        (UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED))
+    {
+        TRACE( "userfaultfd async write protection not supported.\n" );
+        close( fd );
+        return FALSE;
+    }
+
+    if ((pagemap_fd = open( "/proc/self/pagemap", O_RDONLY | O_CLOEXEC )) == -1)
+    {
+        close( fd );
+        return FALSE;
+    }
+
+    /* an empty scan fails with ENOTTY if PAGEMAP_SCAN isn't supported */
+    memset( &arg, 0, sizeof(arg) );
+    arg.size = sizeof(arg);
+    if (ioctl( pagemap_fd, PM_IOCTL_PAGEMAP_SCAN, &arg ) == -1)
+    {
+        TRACE( "PAGEMAP_SCAN not supported, error %s.\n", strerror(errno) );
+        close( pagemap_fd );
+        close( fd );
+        return FALSE;
+    }
+
+    uffd_fd = fd;
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+/***********************************************************************
+ *           get_uffd_write_watches
+ *
+ * Retrieve written pages with PAGEMAP_SCAN, optionally protecting them again.
+ * virtual_mutex must be held by caller.
+ */
+static NTSTATUS get_uffd_write_watches( char *base, char *end, BOOL reset, void **addresses, ULONG_PTR *count )
+{
+    static struct pm_page_region regions[PAGE_FLAGS_BUFFER_LENGTH];
+    struct pm_scan_arg arg;
+    ULONG_PTR pos = 0;
+    char *addr;
+    int i, ret;
+
+    while (pos < *count && base < end)
+    {
+        memset( &arg, 0, sizeof(arg) );
+        arg.size = sizeof(arg);
+        arg.flags = reset ? PM_SCAN_WP_MATCHING | PM_SCAN_CHECK_WPASYNC : 0;
+        arg.start = (ULONG_PTR)base;
+        arg.end = (ULONG_PTR)end;
+        arg.vec = (ULONG_PTR)regions;
+        arg.vec_len = ARRAY_SIZE(regions);
+        arg.max_pages = *count - pos;
+        arg.category_mask = PM_PAGE_IS_WRITTEN;
+        arg.return_mask = PM_PAGE_IS_WRITTEN;
+
+        if ((ret = ioctl( pagemap_fd, PM_IOCTL_PAGEMAP_SCAN, &arg )) == -1)
+        {
+            ERR( "PAGEMAP_SCAN failed for %p-%p, error %s.\n", base, end, strerror(errno) );
+            return STATUS_INVALID_ADDRESS;
+        }
+        for (i = 0; i < ret; i++)
+        {
+            for (addr = (char *)(ULONG_PTR)regions[i].start; addr < (char *)(ULONG_PTR)regions[i].end; addr += page_size)
+            {
+                assert( pos < *count );
+                addresses[pos++] = addr;
+            }
+        }
+        if (arg.walk_end <= (ULONG_PTR)base) break;
+        base = (char *)(ULONG_PTR)arg.walk_end;
+    }
+    *count = pos;
+    return STATUS_SUCCESS;
+}
+#endif  /* __linux__ */
+
+/***********************************************************************
+ *           init_large_pages
+ *
+ * Find the transparent huge page size, used for MEM_LARGE_PAGES.
+ */
+static void init_large_pages(void)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    char buffer[64];
+    FILE *f;
+
+    if (!(f = fopen( "/sys/kernel/mm/transparent_hugepage/enabled", "r" ))) return;
+    if (!fgets( buffer, sizeof(buffer), f )) buffer[0] = 0;
+    fclose( f );
+    if (!buffer[0] || strstr( buffer, "[never]" )) return;
+
+    if (!(f = fopen( "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r" ))) return;
+    if (fgets( buffer, sizeof(buffer), f )) large_page_size = strtoul( buffer, NULL, 10 );
+    fclose( f );
+
+    /* only use sizes that are a multiple of the allocation granularity */
+    if (large_page_size & (large_page_size - 1) || large_page_size <= granularity_mask)
+        large_page_size = 0;
+    TRACE( "large page size %#zx\n", large_page_size );
+#endif
+}
+
 static int disable_kernel_ww( int argc, char *argv[] )
 {
     const char *env_var;
@@ -2994,6 +3305,8 @@ void virtual_init( int argc, char *argv[] )
     pthread_mutex_init( &virtual_mutex, &attr );
     pthread_mutexattr_destroy( &attr );
 
+    init_large_pages();
+
     if (!disable_kernel_ww( argc, argv ) && (pagemap_reset_fd = open("/proc/self/pagemap_reset", O_RDONLY | O_CLOEXEC)) != -1)
     {
         use_kernel_writewatch = TRUE;
@@ -3010,6 +3323,13 @@ void virtual_init( int argc, char *argv[] )
         if (ERR_ON(virtual))
             MESSAGE("wine: using kernel write watches (experimental).\n");
     }
+#ifdef __linux__
+    else if (!disable_kernel_ww( argc, argv ) && init_uffd_writewatch())
+    {
+        use_kernel_writewatch = TRUE;
+        TRACE( "using userfaultfd write protection for write watches.\n" );
+    }
+#endif
 
     if (preload_info && *preload_info)
         for (i = 0; (*preload_info)[i].size; i++)
@@ -3034,7 +3354,8 @@ void virtual_init( int argc, char *argv[] )
     /* try to find space in a reserved area for the views and pages protection table */
 #ifdef _WIN64
     pages_vprot_size = ((size_t)address_space_limit >> page_shift >> pages_vprot_shift) + 1;
-    alloc_views.size = 2 * view_block_size + pages_vprot_size * sizeof(*pages_vprot);
+    alloc_views.size = 2 * view_block_size + pages_vprot_size * sizeof(*pages_vprot) +
+                       pages_vprot_size * sizeof(*pages_vprot_uniform);
 #else
     alloc_views.size = 2 * view_block_size + (1U << (32 - page_shift));
 #endif
@@ -3048,6 +3369,9 @@ void virtual_init( int argc, char *argv[] )
     view_block_end = view_block_start + view_block_size / sizeof(*view_block_start);
     free_ranges = (void *)((char *)alloc_views.base + view_block_size);
     pages_vprot = (void *)((char *)alloc_views.base + 2 * view_block_size);
+#ifdef _WIN64
+    pages_vprot_uniform = (void *)(pages_vprot + pages_vprot_size);
+#endif
     wine_rb_init( &views_tree, compare_view );
 
     free_ranges[0].base = (void *)0;
@@ -3074,6 +3398,11 @@ ULONG_PTR get_system_affinity_mask(void)
 /***********************************************************************
  *           virtual_get_system_info
  */
+ULONG virtual_get_large_page_size(void)
+{
+    return large_page_size;
+}
+
 void virtual_get_system_info( SYSTEM_BASIC_INFORMATION *info, BOOL wow64 )
 {
 #if defined(HAVE_SYSINFO) \
@@ -4156,6 +4485,15 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
             return STATUS_NOT_SUPPORTED;
     }
 
+    if (type & MEM_LARGE_PAGES)
+    {
+        if ((type & (MEM_RESERVE | MEM_COMMIT)) != (MEM_RESERVE | MEM_COMMIT)) return STATUS_INVALID_PARAMETER;
+        if (!large_page_size) return STATUS_NOT_SUPPORTED;
+        if ((size & (large_page_size - 1)) || ((UINT_PTR)*ret & (large_page_size - 1)))
+            return STATUS_INVALID_PARAMETER;
+        align = max( align, large_page_size );
+    }
+
     /* Round parameters to a page boundary */
 
     if (is_beyond_limit( 0, size, working_set_limit )) return STATUS_WORKING_SET_LIMIT_RANGE;
@@ -4218,6 +4556,12 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
                                     align ? align - 1 : granularity_mask );
 
             if (status == STATUS_SUCCESS) base = view->base;
+#ifdef MADV_HUGEPAGE
+            /* large page aligned reservations are backed by transparent huge pages */
+            if (status == STATUS_SUCCESS && large_page_size && align >= large_page_size &&
+                !(vprot & VPROT_WRITEWATCH))
+                madvise( base, size, MADV_HUGEPAGE );
+#endif
         }
     }
     else if (type & MEM_RESET)
@@ -4267,7 +4611,8 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 NTSTATUS WINAPI NtAllocateVirtualMemory( HANDLE process, PVOID *ret, ULONG_PTR zero_bits,
                                          SIZE_T *size_ptr, ULONG type, ULONG protect )
 {
-    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH | MEM_RESET;
+    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH | MEM_RESET
+                                   | MEM_LARGE_PAGES;
     ULONG_PTR limit;
 
     TRACE("%p %p %08lx %x %08x\n", process, *ret, *size_ptr, (int)type, (int)protect );
@@ -4328,7 +4673,8 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
                                            ULONG count )
 {
     static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH
-                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER;
+                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER
+                                   | MEM_LARGE_PAGES;
     ULONG_PTR limit = 0;
     ULONG_PTR align = 0;
 
@@ -5623,6 +5969,14 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
         char *addr = base;
         char *end = addr + size;
 
+#ifdef __linux__
+        if (uffd_fd != -1)
+        {
+            status = get_uffd_write_watches( addr, end, flags & WRITE_WATCH_FLAG_RESET, addresses, count );
+            *granularity = page_size;
+            goto done;
+        }
+#endif
         if (use_kernel_writewatch)
         {
             static UINT64 buffer[PAGE_FLAGS_BUFFER_LENGTH];
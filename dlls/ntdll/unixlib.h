@@ -45,6 +45,15 @@ struct debugstr_pc_args
     unsigned int size;
 };
 
+struct wait_set_params
+{
+    UINT64                      set;
+    DWORD                       count;
+    const HANDLE               *handles;
+    const LARGE_INTEGER        *timeout;
+    DWORD                       index;
+};
+
 enum ntdll_unix_funcs
 {
     unix_load_so_dll,
@@ -52,6 +61,9 @@ enum ntdll_unix_funcs
     unix_system_time_precise,
     unix_is_pc_in_native_so,
     unix_debugstr_pc,
+    unix_wait_set_create,
+    unix_wait_set_free,
+    unix_wait_set_wait,
 };
 
 extern unixlib_handle_t ntdll_unix_handle;
@@ -4796,7 +4796,7 @@ static void test_UnregisterDeviceNotification(void)
 
 static void test_SendInput(void)
 {
-    INPUT input[16];
+    INPUT input[16], many[200];
     UINT res, i;
     HWND hwnd;
     MSG msg;
@@ -4900,6 +4900,27 @@ static void test_SendInput(void)
     ok( !res, "SendInput triggered unexpected message %#x\n", msg.message );
     empty_message_queue();
 
+    /* large batches are delivered in order */
+    memset( many, 0, sizeof(many) );
+    for (i = 0; i < ARRAY_SIZE(many); ++i)
+    {
+        many[i].type = INPUT_KEYBOARD;
+        many[i].ki.wVk = 'A';
+        many[i].ki.dwFlags = (i & 1) ? KEYEVENTF_KEYUP : 0;
+    }
+    SetLastError( 0xdeadbeef );
+    res = SendInput( ARRAY_SIZE(many), many, sizeof(*many) );
+    ok( res == ARRAY_SIZE(many) && GetLastError() == 0xdeadbeef, "SendInput returned %u, error %#lx\n", res, GetLastError() );
+    for (i = 0; i < ARRAY_SIZE(many); ++i)
+    {
+        while ((res = wait_for_message( &msg )) && msg.message == WM_TIMER) DispatchMessageA( &msg );
+        ok( res, "%u: missing message\n", i );
+        if (!res) break;
+        ok( msg.message == ((i & 1) ? WM_KEYUP : WM_KEYDOWN), "%u: got message %#x\n", i, msg.message );
+        ok( msg.wParam == 'A', "%u: got wparam %#Ix\n", i, msg.wParam );
+    }
+    empty_message_queue();
+
     trace( "done\n" );
     DestroyWindow( hwnd );
 }
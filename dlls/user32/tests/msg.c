@@ -17378,6 +17378,54 @@ static void test_PostMessage(void)
     flush_events();
 }
 
+static DWORD WINAPI post_message_thread( void *arg )
+{
+    DWORD tid = *(DWORD *)arg;
+    int i;
+
+    for (i = 0; i < 1000; i++)
+        ok( PostThreadMessageA( tid, WM_USER, i, 0 ), "PostThreadMessage failed, error %lu\n", GetLastError() );
+
+    /* make sure the receiver is blocked when the next one is posted */
+    Sleep( 100 );
+    ok( PostThreadMessageA( tid, WM_USER + 1, 0, 0 ), "PostThreadMessage failed, error %lu\n", GetLastError() );
+    return 0;
+}
+
+static void test_PostMessage_other_thread(void)
+{
+    DWORD tid = GetCurrentThreadId(), ret, status;
+    HANDLE thread;
+    int count = 0;
+    MSG msg;
+
+    flush_events();
+
+    thread = CreateThread( NULL, 0, post_message_thread, &tid, 0, NULL );
+    ok( thread != NULL, "CreateThread failed, error %lu\n", GetLastError() );
+
+    while (count < 1000)
+    {
+        ret = GetMessageA( &msg, 0, WM_USER, WM_USER );
+        ok( ret, "GetMessage failed\n" );
+        ok( !msg.hwnd, "got hwnd %p\n", msg.hwnd );
+        ok( msg.wParam == count, "got wparam %Iu, expected %u\n", msg.wParam, count );
+        if (msg.wParam != count) break;
+        count++;
+    }
+
+    ret = MsgWaitForMultipleObjects( 0, NULL, FALSE, 5000, QS_POSTMESSAGE );
+    ok( ret == WAIT_OBJECT_0, "MsgWaitForMultipleObjects returned %lx\n", ret );
+    status = GetQueueStatus( QS_POSTMESSAGE );
+    ok( HIWORD(status) & QS_POSTMESSAGE, "got status %08lx\n", status );
+    ret = PeekMessageA( &msg, 0, WM_USER + 1, WM_USER + 1, PM_REMOVE );
+    ok( ret, "PeekMessage failed\n" );
+    ok( !PeekMessageA( &msg, 0, WM_USER, WM_USER + 1, PM_REMOVE ), "got message %04x\n", msg.message );
+
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+}
+
 static WPARAM g_broadcast_wparam;
 static LRESULT WINAPI broadcast_test_proc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
@@ -19626,6 +19674,7 @@ START_TEST(msg)
     test_SetFocus();
     test_SetParent();
     test_PostMessage();
+    test_PostMessage_other_thread();
     test_broadcast();
     test_ShowWindow();
     test_PeekMessage();
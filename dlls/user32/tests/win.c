@@ -12857,6 +12857,101 @@ static void test_other_process_window(const char *argv0)
     DestroyWindow(hwnd);
 }
 
+static void other_process_window_info_proc(HWND child)
+{
+    HANDLE window_ready_event, test_done_event;
+    DWORD tid, pid, ret;
+    RECT rect, expect;
+    HWND hwnd;
+
+    window_ready_event = OpenEventA(EVENT_ALL_ACCESS, FALSE, "test_owi_window");
+    ok(!!window_ready_event, "OpenEvent failed.\n");
+    test_done_event = OpenEventA(EVENT_ALL_ACCESS, FALSE, "test_owi_test");
+    ok(!!test_done_event, "OpenEvent failed.\n");
+
+    ok(IsWindow(child), "IsWindow failed.\n");
+    hwnd = GetParent(child);
+    ok(hwnd == (HWND)GetWindowLongPtrA(child, GWLP_USERDATA), "Unexpected parent %p.\n", hwnd);
+    ok(GetAncestor(child, GA_PARENT) == hwnd, "Unexpected ancestor %p.\n", GetAncestor(child, GA_PARENT));
+
+    pid = 0;
+    tid = GetWindowThreadProcessId(child, &pid);
+    ok(tid == GetWindowThreadProcessId(hwnd, NULL), "Unexpected thread %#lx.\n", tid);
+    ok(pid != GetCurrentProcessId(), "Unexpected process %#lx.\n", pid);
+    ok(pid == GetWindowLongPtrA(hwnd, GWLP_USERDATA), "Unexpected process %#lx.\n", pid);
+
+    ok(GetWindowLongPtrA(child, GWLP_ID) == 0x1234, "Unexpected id %#Ix.\n", GetWindowLongPtrA(child, GWLP_ID));
+    ret = GetWindowLongA(child, GWL_STYLE);
+    ok((ret & (WS_CHILD | WS_POPUP | WS_VISIBLE)) == (WS_CHILD | WS_VISIBLE), "Unexpected style %#lx.\n", ret);
+    ret = GetWindowLongA(hwnd, GWL_EXSTYLE);
+    ok(ret & WS_EX_TOOLWINDOW, "Unexpected exstyle %#lx.\n", ret);
+
+    GetWindowRect(hwnd, &rect);
+    SetRect(&expect, 100, 100, 200, 200);
+    ok(EqualRect(&rect, &expect), "Unexpected rect %s.\n", wine_dbgstr_rect(&rect));
+    GetWindowRect(child, &rect);
+    SetRect(&expect, 110, 120, 140, 160);
+    ok(EqualRect(&rect, &expect), "Unexpected rect %s.\n", wine_dbgstr_rect(&rect));
+    GetClientRect(child, &rect);
+    SetRect(&expect, 0, 0, 30, 40);
+    ok(EqualRect(&rect, &expect), "Unexpected rect %s.\n", wine_dbgstr_rect(&rect));
+
+    /* the parent process destroys the windows */
+    SetEvent(test_done_event);
+    ret = WaitForSingleObject(window_ready_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+    ok(!IsWindow(child), "IsWindow succeeded.\n");
+    ok(!IsWindow(hwnd), "IsWindow succeeded.\n");
+    SetLastError(0xdeadbeef);
+    ok(!GetWindowRect(child, &rect), "GetWindowRect succeeded.\n");
+    ok(GetLastError() == ERROR_INVALID_WINDOW_HANDLE, "Unexpected error %lu.\n", GetLastError());
+
+    CloseHandle(window_ready_event);
+    CloseHandle(test_done_event);
+}
+
+static void test_other_process_window_info(const char *argv0)
+{
+    HANDLE window_ready_event, test_done_event;
+    PROCESS_INFORMATION info;
+    STARTUPINFOA startup;
+    char cmd[MAX_PATH];
+    HWND hwnd, child;
+    DWORD ret;
+
+    hwnd = CreateWindowExA(WS_EX_TOOLWINDOW, "static", NULL, WS_POPUP,
+            100, 100, 100, 100, 0, 0, NULL, NULL);
+    ok(!!hwnd, "CreateWindowEx failed.\n");
+    child = CreateWindowExA(0, "static", NULL, WS_CHILD | WS_VISIBLE,
+            10, 20, 30, 40, hwnd, (HMENU)0x1234, NULL, NULL);
+    ok(!!child, "CreateWindowEx failed.\n");
+    SetWindowLongPtrA(hwnd, GWLP_USERDATA, GetCurrentProcessId());
+    SetWindowLongPtrA(child, GWLP_USERDATA, (LONG_PTR)hwnd);
+
+    window_ready_event = CreateEventA(NULL, FALSE, FALSE, "test_owi_window");
+    ok(!!window_ready_event, "CreateEvent failed.\n");
+    test_done_event = CreateEventA(NULL, FALSE, FALSE, "test_owi_test");
+    ok(!!test_done_event, "CreateEvent failed.\n");
+
+    sprintf(cmd, "%s win test_other_process_window_info %p", argv0, child);
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+
+    ok(CreateProcessA(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL,
+            &startup, &info), "CreateProcess failed.\n");
+
+    ret = WaitForSingleObject(test_done_event, 5000);
+    ok(ret == WAIT_OBJECT_0, "Unexpected ret %lx.\n", ret);
+    DestroyWindow(hwnd);
+    SetEvent(window_ready_event);
+
+    wait_child_process(info.hProcess);
+    CloseHandle(window_ready_event);
+    CloseHandle(test_done_event);
+    CloseHandle(info.hProcess);
+    CloseHandle(info.hThread);
+}
+
 static void test_cancel_mode(void)
 {
     HWND hwnd1, hwnd2, child;
@@ -13076,6 +13171,11 @@ START_TEST(win)
             other_process_proc(hwnd);
             return;
         }
+        else if (!strcmp(argv[2], "test_other_process_window_info"))
+        {
+            other_process_window_info_proc(hwnd);
+            return;
+        }
     }
 
     if (argc == 3 && !strcmp(argv[2], "winproc_limit"))
@@ -13214,6 +13314,7 @@ START_TEST(win)
     test_window_placement();
     test_arrange_iconic_windows();
     test_other_process_window(argv[0]);
+    test_other_process_window_info(argv[0]);
     test_SC_SIZE();
     test_cancel_mode();
     test_DragDetect();
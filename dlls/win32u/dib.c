@@ -1706,6 +1706,19 @@ error:
 }
 
 
+/***********************************************************************
+ *           bitmapobj_has_private_bits
+ *
+ * Whether the bits of a bitmap can only be accessed through GDI. DIB section
+ * bits live in the application's address space, where they can be freed or
+ * protected at any time, so only DDBs qualify.
+ */
+BOOL bitmapobj_has_private_bits( const BITMAPOBJ *bmp )
+{
+    return !is_bitmapobj_dib( bmp );
+}
+
+
 /***********************************************************************
  *           NtGdiDdDDIDestroyDCFromMemory    (win32u.@)
  */
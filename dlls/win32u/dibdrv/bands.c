@@ -0,0 +1,338 @@
+/*
+ * DIB driver parallel execution of large operations
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#if 0
+#pragma makedep unix
+#endif
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "ntgdi_private.h"
+#include "dibdrv.h"
+
+#include "wine/debug.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(dib);
+
+/*
+ * Large operations are split into horizontal bands that are processed by a
+ * small pool of worker threads together with the calling thread. Only
+ * operations on bits that we allocated ourselves are split, a fault on
+ * application memory has to be raised on the calling thread.
+ */
+
+#define MAX_BANDS        8
+#define MIN_BAND_PIXELS  (128 * 1024)  /* don't bother splitting smaller operations */
+
+struct band_job
+{
+    void (*func)( void *ctx, int band );
+    void  *ctx;
+    int    count;    /* number of bands */
+    int    next;     /* next band to process */
+    int    pending;  /* bands not yet completed */
+};
+
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;   /* only one job at a time */
+static pthread_mutex_t band_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects current_job */
+static pthread_cond_t band_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static struct band_job *current_job;
+static int band_threads;
+
+static void CALLBACK band_worker( void *arg )
+{
+    struct band_job *job;
+    int band;
+
+    pthread_mutex_lock( &band_mutex );
+    for (;;)
+    {
+        while (!(job = current_job) || job->next >= job->count) pthread_cond_wait( &band_cond, &band_mutex );
+        band = job->next++;
+        pthread_mutex_unlock( &band_mutex );
+
+        job->func( job->ctx, band );
+
+        pthread_mutex_lock( &band_mutex );
+        if (!--job->pending) pthread_cond_signal( &done_cond );
+    }
+}
+
+static void start_band_workers(void)
+{
+    int count = min( system_info.NumberOfProcessors, MAX_BANDS ) - 1;
+    HANDLE handle;
+
+    /* wow64 threads can't start in Unix code */
+    if (NtCurrentTeb()->WowTebOffset) return;
+
+    for (band_threads = 0; band_threads < count; band_threads++)
+    {
+        if (NtCreateThreadEx( &handle, THREAD_ALL_ACCESS, NULL, GetCurrentProcess(), band_worker, NULL,
+                              THREAD_CREATE_FLAGS_HIDE_FROM_DEBUGGER, 0, 0, 256 * 1024, NULL )) break;
+        NtClose( handle );
+    }
+
+    TRACE( "started %d worker threads\n", band_threads );
+}
+
+/***********************************************************************
+ *           get_band_count
+ *
+ * Return the number of bands an operation touching that many pixels should be split into.
+ */
+int get_band_count( ULONGLONG pixels )
+{
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+    if (pixels < 2 * MIN_BAND_PIXELS) return 1;
+    pthread_once( &once, start_band_workers );
+    return min( pixels / MIN_BAND_PIXELS, band_threads + 1 );
+}
+
+/***********************************************************************
+ *           run_bands
+ *
+ * Call func for each band, spread over the worker threads, and wait for completion.
+ */
+void run_bands( void (*func)( void *ctx, int band ), void *ctx, int count )
+{
+    struct band_job job = { func, ctx, count, 0, count };
+    int band;
+
+    /* if another thread is already using the workers, do it all ourselves */
+    if (count <= 1 || pthread_mutex_trylock( &job_mutex ))
+    {
+        for (band = 0; band < count; band++) func( ctx, band );
+        return;
+    }
+
+    pthread_mutex_lock( &band_mutex );
+    current_job = &job;
+    pthread_cond_broadcast( &band_cond );
+    while (job.next < job.count)
+    {
+        band = job.next++;
+        pthread_mutex_unlock( &band_mutex );
+        func( ctx, band );
+        pthread_mutex_lock( &band_mutex );
+        job.pending--;
+    }
+    while (job.pending) pthread_cond_wait( &done_cond, &band_mutex );
+    current_job = NULL;
+    pthread_mutex_unlock( &band_mutex );
+    pthread_mutex_unlock( &job_mutex );
+}
+
+/* a set of rectangles split into horizontal bands */
+struct rect_bands
+{
+    int   count;            /* number of bands */
+    int   num[MAX_BANDS];   /* number of rectangles in each band */
+    int   max;              /* rectangles allocated per band */
+    RECT *rects;
+};
+
+static inline const RECT *get_band_rects( const struct rect_bands *bands, int band )
+{
+    return bands->rects + band * bands->max;
+}
+
+/* split the rectangles into bands, return FALSE if it's not worth it */
+static BOOL split_rects( int num, const RECT *rects, struct rect_bands *bands )
+{
+    ULONGLONG pixels = 0;
+    RECT bounds, band_rect;
+    int i, band, height;
+
+    if (num <= 0) return FALSE;
+
+    bounds = rects[0];
+    for (i = 0; i < num; i++)
+    {
+        pixels += (ULONGLONG)(rects[i].right - rects[i].left) * (rects[i].bottom - rects[i].top);
+        union_rect( &bounds, &bounds, &rects[i] );
+    }
+    height = bounds.bottom - bounds.top;
+    if ((bands->count = min( get_band_count( pixels ), height )) <= 1) return FALSE;
+    if (!(bands->rects = malloc( bands->count * num * sizeof(RECT) ))) return FALSE;
+    bands->max = num;
+
+    band_rect.left = bounds.left;
+    band_rect.right = bounds.right;
+    for (band = 0; band < bands->count; band++)
+    {
+        RECT *dst = bands->rects + band * bands->max;
+
+        band_rect.top = bounds.top + (LONGLONG)height * band / bands->count;
+        band_rect.bottom = bounds.top + (LONGLONG)height * (band + 1) / bands->count;
+        bands->num[band] = 0;
+        for (i = 0; i < num; i++)
+            if (intersect_rect( &dst[bands->num[band]], &rects[i], &band_rect )) bands->num[band]++;
+    }
+    return TRUE;
+}
+
+struct solid_rects_ctx
+{
+    const dib_info   *dib;
+    struct rect_bands bands;
+    DWORD             and, xor;
+};
+
+static void solid_rects_band( void *arg, int band )
+{
+    struct solid_rects_ctx *ctx = arg;
+
+    if (ctx->bands.num[band])
+        ctx->dib->funcs->solid_rects( ctx->dib, ctx->bands.num[band], get_band_rects( &ctx->bands, band ),
+                                      ctx->and, ctx->xor );
+}
+
+void parallel_solid_rects( const dib_info *dib, int num, const RECT *rects, DWORD and, DWORD xor )
+{
+    struct solid_rects_ctx ctx;
+
+    if (!can_split_dib( dib ) || !split_rects( num, rects, &ctx.bands ))
+    {
+        dib->funcs->solid_rects( dib, num, rects, and, xor );
+        return;
+    }
+    ctx.dib = dib;
+    ctx.and = and;
+    ctx.xor = xor;
+    run_bands( solid_rects_band, &ctx, ctx.bands.count );
+    free( ctx.bands.rects );
+}
+
+struct pattern_rects_ctx
+{
+    const dib_info      *dib;
+    struct rect_bands    bands;
+    const POINT         *origin;
+    const dib_info      *brush;
+    const rop_mask_bits *bits;
+};
+
+static void pattern_rects_band( void *arg, int band )
+{
+    struct pattern_rects_ctx *ctx = arg;
+
+    if (ctx->bands.num[band])
+        ctx->dib->funcs->pattern_rects( ctx->dib, ctx->bands.num[band], get_band_rects( &ctx->bands, band ),
+                                        ctx->origin, ctx->brush, ctx->bits );
+}
+
+void parallel_pattern_rects( const dib_info *dib, int num, const RECT *rects, const POINT *origin,
+                             const dib_info *brush, const rop_mask_bits *bits )
+{
+    struct pattern_rects_ctx ctx;
+
+    if (!can_split_dib( dib ) || !split_rects( num, rects, &ctx.bands ))
+    {
+        dib->funcs->pattern_rects( dib, num, rects, origin, brush, bits );
+        return;
+    }
+    ctx.dib = dib;
+    ctx.origin = origin;
+    ctx.brush = brush;
+    ctx.bits = bits;
+    run_bands( pattern_rects_band, &ctx, ctx.bands.count );
+    free( ctx.bands.rects );
+}
+
+struct blend_rects_ctx
+{
+    const dib_info   *dst;
+    struct rect_bands bands;
+    const dib_info   *src;
+    const POINT      *offset;
+    BLENDFUNCTION     blend;
+};
+
+static void blend_rects_band( void *arg, int band )
+{
+    struct blend_rects_ctx *ctx = arg;
+
+    if (ctx->bands.num[band])
+        ctx->dst->funcs->blend_rects( ctx->dst, ctx->bands.num[band], get_band_rects( &ctx->bands, band ),
+                                      ctx->src, ctx->offset, ctx->blend );
+}
+
+void parallel_blend_rects( const dib_info *dst, int num, const RECT *rects, const dib_info *src,
+                           const POINT *offset, BLENDFUNCTION blend )
+{
+    struct blend_rects_ctx ctx;
+
+    if (!can_split_dib( dst ) || !can_split_dib( src ) || !split_rects( num, rects, &ctx.bands ))
+    {
+        dst->funcs->blend_rects( dst, num, rects, src, offset, blend );
+        return;
+    }
+    ctx.dst = dst;
+    ctx.src = src;
+    ctx.offset = offset;
+    ctx.blend = blend;
+    run_bands( blend_rects_band, &ctx, ctx.bands.count );
+    free( ctx.bands.rects );
+}
+
+struct gradient_rects_ctx
+{
+    const dib_info   *dib;
+    struct rect_bands bands;
+    const TRIVERTEX  *v;
+    int               mode;
+    BOOL              ret[MAX_BANDS];
+};
+
+static void gradient_rects_band( void *arg, int band )
+{
+    struct gradient_rects_ctx *ctx = arg;
+    const RECT *rects = get_band_rects( &ctx->bands, band );
+    int i;
+
+    ctx->ret[band] = TRUE;
+    for (i = 0; i < ctx->bands.num[band]; i++)
+        if (!(ctx->ret[band] = ctx->dib->funcs->gradient_rect( ctx->dib, &rects[i], ctx->v, ctx->mode ))) break;
+}
+
+BOOL parallel_gradient_rects( const dib_info *dib, int num, const RECT *rects, const TRIVERTEX *v, int mode )
+{
+    struct gradient_rects_ctx ctx;
+    BOOL ret = TRUE;
+    int i;
+
+    if (!can_split_dib( dib ) || !split_rects( num, rects, &ctx.bands ))
+    {
+        for (i = 0; i < num; i++)
+            if (!(ret = dib->funcs->gradient_rect( dib, &rects[i], v, mode ))) break;
+        return ret;
+    }
+    ctx.dib = dib;
+    ctx.v = v;
+    ctx.mode = mode;
+    run_bands( gradient_rects_band, &ctx, ctx.bands.count );
+    for (i = 0; i < ctx.bands.count; i++) ret = ret && ctx.ret[i];
+    free( ctx.bands.rects );
+    return ret;
+}
@@ -595,7 +595,7 @@ static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *sr
 
     offset.x = src_rect->left - dst_rect->left;
     offset.y = src_rect->top  - dst_rect->top;
-    dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
+    parallel_blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
 
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
@@ -682,15 +682,11 @@ static void get_gradient_triangle_vertices( const GRADIENT_TRIANGLE *tri, const
 
 static BOOL gradient_rect( dib_info *dib, TRIVERTEX *v, int mode, HRGN clip, const RECT *bounds )
 {
-    int i;
     struct clipped_rects clipped_rects;
-    BOOL ret = TRUE;
+    BOOL ret;
 
     if (!get_clipped_rects( dib, bounds, clip, &clipped_rects )) return TRUE;
-    for (i = 0; i < clipped_rects.count; i++)
-    {
-        if (!(ret = dib->funcs->gradient_rect( dib, &clipped_rects.rects[i], v, mode ))) break;
-    }
+    ret = parallel_gradient_rects( dib, clipped_rects.count, clipped_rects.rects, v, mode );
     free_clipped_rects( &clipped_rects );
     return ret;
 }
@@ -1109,6 +1105,8 @@ update_format:
  * and add the additional dy - dx error term by passing this as the bias.
  *
  */
+#define MAX_STRETCH_BANDS 8
+
 static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_start, INT dst_vis_end,
                                      INT src_start, INT src_length, INT src_vis_start, INT src_vis_end,
                                      LONG *dst_clipped_start, LONG *src_clipped_start,
@@ -1198,20 +1196,129 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
+/* position of the vertical stretching at the start of a band of rows */
+struct stretch_rows_pos
+{
+    POINT dst_start;
+    POINT src_start;
+    int   err;
+    int   index;      /* iteration index in the vertical stretch */
+};
+
+struct stretch_rows_ctx
+{
+    dib_info *dst_dib;
+    dib_info *src_dib;
+    void (*row_fn)( const dib_info *dst_dib, const POINT *dst_start, const dib_info *src_dib,
+                    const POINT *src_start, const struct stretch_params *params, int mode, BOOL keep_dst );
+    const struct stretch_params *v_params;
+    const struct stretch_params *h_params;
+    int   mode;
+    BOOL  vstretch;
+    int   width;      /* width of the destination rows */
+    int   count;      /* number of bands */
+    struct stretch_rows_pos start[MAX_STRETCH_BANDS + 1];
+};
+
+/* advance the vertical stretching by one iteration, return TRUE if the next one starts a new row */
+static BOOL next_stretch_row( const struct stretch_rows_ctx *ctx, struct stretch_rows_pos *pos )
+{
+    const struct stretch_params *v_params = ctx->v_params;
+    BOOL new_row;
+
+    if (ctx->vstretch)
+    {
+        new_row = pos->err > 0;
+        if (new_row) pos->src_start.y += v_params->src_inc;
+        pos->dst_start.y += v_params->dst_inc;
+    }
+    else
+    {
+        new_row = pos->err > 0;
+        if (new_row) pos->dst_start.y += v_params->dst_inc;
+        pos->src_start.y += v_params->src_inc;
+    }
+    pos->err += new_row ? v_params->err_add_1 : v_params->err_add_2;
+    pos->index++;
+    /* when stretching every iteration is a separate destination row */
+    return ctx->vstretch || new_row;
+}
+
+/* compute the starting positions of the bands, return the number of bands */
+static int split_stretch_rows( struct stretch_rows_ctx *ctx, int count )
+{
+    struct stretch_rows_pos pos = ctx->start[0];
+    int length = ctx->v_params->length, band = 1;
+
+    count = min( count, MAX_STRETCH_BANDS );
+    if (count > 1)
+    {
+        while (pos.index < length && band < count)
+        {
+            if (next_stretch_row( ctx, &pos ) && pos.index >= (LONGLONG)length * band / count)
+                ctx->start[band++] = pos;
+        }
+    }
+    ctx->start[band].index = length;
+    return band;
+}
+
+static void stretch_rows_band( void *arg, int band )
+{
+    struct stretch_rows_ctx *ctx = arg;
+    struct stretch_rows_pos pos = ctx->start[band];
+    int end = ctx->start[band + 1].index;
+    RECT last_row, this_row;
+    BOOL need_row = TRUE;
+    int merged_rows = 0;
+
+    last_row.left = 0;
+    last_row.right = ctx->width;
+
+    while (pos.index < end)
+    {
+        if (ctx->vstretch)
+        {
+            /* the first row of a band is always drawn, the previous one belongs to another band */
+            if (need_row)
+            {
+                ctx->row_fn( ctx->dst_dib, &pos.dst_start, ctx->src_dib, &pos.src_start,
+                             ctx->h_params, ctx->mode, FALSE );
+                need_row = FALSE;
+            }
+            else
+            {
+                last_row.top = pos.dst_start.y - ctx->v_params->dst_inc;
+                last_row.bottom = last_row.top + 1;
+                this_row = last_row;
+                OffsetRect( &this_row, 0, ctx->v_params->dst_inc );
+                copy_rect( ctx->dst_dib, &this_row, ctx->dst_dib, &last_row, NULL, R2_COPYPEN );
+            }
+            if (pos.err > 0) need_row = TRUE;
+            next_stretch_row( ctx, &pos );
+        }
+        else
+        {
+            if (ctx->mode != STRETCH_DELETESCANS || !merged_rows)
+                ctx->row_fn( ctx->dst_dib, &pos.dst_start, ctx->src_dib, &pos.src_start,
+                             ctx->h_params, ctx->mode, merged_rows != 0 );
+            merged_rows++;
+            if (next_stretch_row( ctx, &pos )) merged_rows = 0;
+        }
+    }
+}
+
 DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                           const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
-                          INT mode )
+                          INT mode, BOOL private_bits )
 {
     dib_info src_dib, dst_dib;
     POINT dst_start, src_start, dst_end, src_end;
     RECT rect;
     BOOL hstretch, vstretch;
     struct stretch_params v_params, h_params;
-    int err;
+    struct stretch_rows_ctx ctx;
     DWORD ret;
-    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
-                    const dib_info *src_dib, const POINT *src_start,
-                    const struct stretch_params *params, int mode, BOOL keep_dst);
 
     TRACE("dst %d, %d - %d x %d visrect %s src %d, %d - %d x %d visrect %s\n",
           dst->x, dst->y, dst->width, dst->height, wine_dbgstr_rect(&dst->visrect),
@@ -1251,64 +1358,27 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     dst_start.x -= dst->visrect.left;
     dst_start.y -= dst->visrect.top;
 
-    err = v_params.err_start;
-
-    row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
-
-    if (vstretch)
-    {
-        BOOL need_row = TRUE;
-        RECT last_row, this_row;
-        if (hstretch) mode = STRETCH_DELETESCANS;
-        last_row.left = 0;
-        last_row.right = dst->visrect.right - dst->visrect.left;
-
-        while (v_params.length--)
-        {
-            if (need_row)
-            {
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, FALSE );
-                need_row = FALSE;
-            }
-            else
-            {
-                last_row.top = dst_start.y - v_params.dst_inc;
-                last_row.bottom = last_row.top + 1;
-                this_row = last_row;
-                OffsetRect( &this_row, 0, v_params.dst_inc );
-                copy_rect( &dst_dib, &this_row, &dst_dib, &last_row, NULL, R2_COPYPEN );
-            }
-
-            if (err > 0)
-            {
-                src_start.y += v_params.src_inc;
-                need_row = TRUE;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            dst_start.y += v_params.dst_inc;
-        }
-    }
-    else
-    {
-        int merged_rows = 0;
-
-        while (v_params.length--)
-        {
-            if (mode != STRETCH_DELETESCANS || !merged_rows)
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, merged_rows != 0 );
-            merged_rows++;
-
-            if (err > 0)
-            {
-                dst_start.y += v_params.dst_inc;
-                merged_rows = 0;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            src_start.y += v_params.src_inc;
-        }
-    }
+    ctx.dst_dib = &dst_dib;
+    ctx.src_dib = &src_dib;
+    ctx.row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
+    ctx.v_params = &v_params;
+    ctx.h_params = &h_params;
+    ctx.mode = (vstretch && hstretch) ? STRETCH_DELETESCANS : mode;
+    ctx.vstretch = vstretch;
+    ctx.width = dst->visrect.right - dst->visrect.left;
+
+    ctx.start[0].dst_start = dst_start;
+    ctx.start[0].src_start = src_start;
+    ctx.start[0].err = v_params.err_start;
+    ctx.start[0].index = 0;
+    /* the destination is always a private buffer, the source may belong to the application */
+    src_dib.private_bits = private_bits;
+    dst_dib.private_bits = TRUE;
+    ctx.count = 1;
+    if (can_split_dib( &src_dib ) && can_split_dib( &dst_dib ))
+        ctx.count = get_band_count( (ULONGLONG)ctx.width * v_params.length );
+    ctx.count = split_stretch_rows( &ctx, ctx.count );
+    run_bands( stretch_rows_band, &ctx, ctx.count );
 
 done:
     /* update coordinates, the destination rectangle is always stored at 0,0 */
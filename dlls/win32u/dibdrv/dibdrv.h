@@ -34,6 +34,7 @@ typedef struct
     DWORD color_table_size;
 
     const struct primitive_funcs *funcs;
+    BOOL private_bits; /* bits are allocated by us and can be accessed from any thread */
 } dib_info;
 
 typedef struct
@@ -223,6 +224,18 @@ extern const primitive_funcs funcs_4    DECLSPEC_HIDDEN;
 extern const primitive_funcs funcs_1    DECLSPEC_HIDDEN;
 extern const primitive_funcs funcs_null DECLSPEC_HIDDEN;
 
+/* row kernels for the 32bpp formats, vectorized according to the CPU features */
+typedef struct simd_funcs
+{
+    void           (* blend_argb)(DWORD *dst, const DWORD *src, int len);
+    void     (* blend_argb_alpha)(DWORD *dst, const DWORD *src, int len, DWORD alpha);
+    void  (* blend_constant_alpha)(DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or);
+    void               (* rop_32)(DWORD *dst, int len, DWORD and, DWORD xor);
+    void      (* convert_24_to_32)(DWORD *dst, const BYTE *src, int len);
+} simd_funcs;
+
+extern const simd_funcs *dib_simd DECLSPEC_HIDDEN;
+
 struct rop_codes
 {
     DWORD a1, a2, x1, x2;
@@ -264,6 +277,22 @@ extern int clip_line(const POINT *start, const POINT *end, const RECT *clip,
                      const bres_params *params, POINT *pt1, POINT *pt2) DECLSPEC_HIDDEN;
 extern void release_cached_font( struct cached_font *font ) DECLSPEC_HIDDEN;
 extern BOOL fill_with_pixel( DC *dc, dib_info *dib, DWORD pixel, int num, const RECT *rects, INT rop ) DECLSPEC_HIDDEN;
+extern int get_band_count( ULONGLONG pixels ) DECLSPEC_HIDDEN;
+extern void run_bands( void (*func)( void *ctx, int band ), void *ctx, int count ) DECLSPEC_HIDDEN;
+extern void parallel_solid_rects( const dib_info *dib, int num, const RECT *rects, DWORD and, DWORD xor ) DECLSPEC_HIDDEN;
+extern void parallel_pattern_rects( const dib_info *dib, int num, const RECT *rects, const POINT *origin,
+                                    const dib_info *brush, const rop_mask_bits *bits ) DECLSPEC_HIDDEN;
+extern void parallel_blend_rects( const dib_info *dst, int num, const RECT *rects, const dib_info *src,
+                                  const POINT *offset, BLENDFUNCTION blend ) DECLSPEC_HIDDEN;
+extern BOOL parallel_gradient_rects( const dib_info *dib, int num, const RECT *rects,
+                                     const TRIVERTEX *v, int mode ) DECLSPEC_HIDDEN;
+
+/* operations can only be split into bands if the bits can't fault, and the primitives
+ * don't need to report unsupported formats */
+static inline BOOL can_split_dib( const dib_info *dib )
+{
+    return dib->private_bits && dib->funcs != &funcs_null;
+}
 
 static inline void init_clipped_rects( struct clipped_rects *clip_rects )
 {
@@ -290,6 +319,51 @@ static inline const RGBQUAD *get_dib_color_table( const dib_info *dib )
     return dib->color_table ? dib->color_table : get_default_color_table( dib->bit_count );
 }
 
+static inline BYTE blend_color(BYTE dst, BYTE src, DWORD alpha)
+{
+    return (src * alpha + dst * (255 - alpha) + 127) / 255;
+}
+
+static inline DWORD blend_argb_constant_alpha( DWORD dst, DWORD src, DWORD alpha )
+{
+    return (blend_color( dst, src, alpha ) |
+            blend_color( dst >> 8, src >> 8, alpha ) << 8 |
+            blend_color( dst >> 16, src >> 16, alpha ) << 16 |
+            blend_color( dst >> 24, src >> 24, alpha ) << 24);
+}
+
+static inline DWORD blend_argb_no_src_alpha( DWORD dst, DWORD src, DWORD alpha )
+{
+    return (blend_color( dst, src, alpha ) |
+            blend_color( dst >> 8, src >> 8, alpha ) << 8 |
+            blend_color( dst >> 16, src >> 16, alpha ) << 16 |
+            blend_color( dst >> 24, 255, alpha ) << 24);
+}
+
+static inline DWORD blend_argb( DWORD dst, DWORD src )
+{
+    BYTE b = (BYTE)src;
+    BYTE g = (BYTE)(src >> 8);
+    BYTE r = (BYTE)(src >> 16);
+    DWORD alpha  = (BYTE)(src >> 24);
+    return ((b     + ((BYTE)dst         * (255 - alpha) + 127) / 255) |
+            (g     + ((BYTE)(dst >> 8)  * (255 - alpha) + 127) / 255) << 8 |
+            (r     + ((BYTE)(dst >> 16) * (255 - alpha) + 127) / 255) << 16 |
+            (alpha + ((BYTE)(dst >> 24) * (255 - alpha) + 127) / 255) << 24);
+}
+
+static inline DWORD blend_argb_alpha( DWORD dst, DWORD src, DWORD alpha )
+{
+    BYTE b = ((BYTE)src         * alpha + 127) / 255;
+    BYTE g = ((BYTE)(src >> 8)  * alpha + 127) / 255;
+    BYTE r = ((BYTE)(src >> 16) * alpha + 127) / 255;
+    alpha  = ((BYTE)(src >> 24) * alpha + 127) / 255;
+    return ((b     + ((BYTE)dst         * (255 - alpha) + 127) / 255) |
+            (g     + ((BYTE)(dst >> 8)  * (255 - alpha) + 127) / 255) << 8 |
+            (r     + ((BYTE)(dst >> 16) * (255 - alpha) + 127) / 255) << 16 |
+            (alpha + ((BYTE)(dst >> 24) * (255 - alpha) + 127) / 255) << 24);
+}
+
 struct osmesa_funcs
 {
     void (*get_gl_funcs)( struct opengl_funcs *funcs );
@@ -0,0 +1,482 @@
+/*
+ * DIB driver vectorized row primitives.
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#if 0
+#pragma makedep unix
+#endif
+
+#include "config.h"
+
+#include "ntgdi_private.h"
+#include "dibdrv.h"
+
+#include "wine/debug.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && (__GNUC__ >= 5 || defined(__clang__))
+#define HAVE_DIB_SSE2
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define HAVE_DIB_NEON
+#include <arm_neon.h>
+#endif
+
+WINE_DEFAULT_DEBUG_CHANNEL(dib);
+
+/*
+ * The vector versions must produce exactly the same results as the C versions.
+ * Divisions of the form (x + 127) / 255 are computed as (t + (t >> 8)) >> 8
+ * with t = x + 128, which is exact for any x up to 255 * 255.
+ */
+
+static void blend_argb_c( DWORD *dst, const DWORD *src, int len )
+{
+    int x;
+
+    for (x = 0; x < len; x++) dst[x] = blend_argb( dst[x], src[x] );
+}
+
+static void blend_argb_alpha_c( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    int x;
+
+    for (x = 0; x < len; x++) dst[x] = blend_argb_alpha( dst[x], src[x], alpha );
+}
+
+static void blend_constant_alpha_c( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    int x;
+
+    for (x = 0; x < len; x++) dst[x] = blend_argb_constant_alpha( dst[x], src[x] | src_or, alpha );
+}
+
+static void rop_32_c( DWORD *dst, int len, DWORD and, DWORD xor )
+{
+    int x;
+
+    for (x = 0; x < len; x++) dst[x] = (dst[x] & and) ^ xor;
+}
+
+static void convert_24_to_32_c( DWORD *dst, const BYTE *src, int len )
+{
+    int x;
+
+    for (x = 0; x < len; x++, src += 3) dst[x] = src[2] << 16 | src[1] << 8 | src[0];
+}
+
+static const simd_funcs simd_c =
+{
+    blend_argb_c,
+    blend_argb_alpha_c,
+    blend_constant_alpha_c,
+    rop_32_c,
+    convert_24_to_32_c
+};
+
+#ifdef HAVE_DIB_SSE2
+
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+
+static inline SSE2 __m128i div255_sse2( __m128i x )
+{
+    x = _mm_add_epi16( x, _mm_set1_epi16( 128 ));
+    return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 )), 8 );
+}
+
+static inline SSE2 __m128i alpha_sse2( __m128i x )
+{
+    return _mm_shufflehi_epi16( _mm_shufflelo_epi16( x, 0xff ), 0xff );
+}
+
+static inline SSE2 BOOL overflow_sse2( __m128i lo, __m128i hi )
+{
+    __m128i high_bytes = _mm_and_si128( _mm_or_si128( lo, hi ), _mm_set1_epi16( 0xff00 ));
+    return _mm_movemask_epi8( _mm_cmpeq_epi16( high_bytes, _mm_setzero_si128() )) != 0xffff;
+}
+
+/* blend two 16-bit per channel premultiplied pixels */
+static inline SSE2 __m128i blend_argb_sse2( __m128i dst, __m128i src )
+{
+    __m128i inv = _mm_sub_epi16( _mm_set1_epi16( 255 ), alpha_sse2( src ));
+    return _mm_add_epi16( src, div255_sse2( _mm_mullo_epi16( dst, inv )));
+}
+
+static SSE2 void blend_argb_sse2_row( DWORD *dst, const DWORD *src, int len )
+{
+    const __m128i zero = _mm_setzero_si128(), opaque = _mm_set1_epi32( 0xff000000 );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) ), d, lo, hi;
+
+        if (_mm_movemask_epi8( _mm_cmpeq_epi32( s, zero )) == 0xffff) continue;
+        if (_mm_movemask_epi8( _mm_cmpeq_epi32( _mm_and_si128( s, opaque ), opaque )) == 0xffff)
+        {
+            _mm_storeu_si128( (__m128i *)(dst + x), s );
+            continue;
+        }
+        d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        lo = blend_argb_sse2( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ));
+        hi = blend_argb_sse2( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ));
+        /* the C code lets channels carry over when the source isn't premultiplied */
+        if (overflow_sse2( lo, hi )) blend_argb_c( dst + x, src + x, 4 );
+        else _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    blend_argb_c( dst + x, src + x, len - x );
+}
+
+static SSE2 void blend_argb_alpha_sse2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const __m128i zero = _mm_setzero_si128(), a = _mm_set1_epi16( alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = div255_sse2( _mm_mullo_epi16( _mm_unpacklo_epi8( s, zero ), a ));
+        __m128i hi = div255_sse2( _mm_mullo_epi16( _mm_unpackhi_epi8( s, zero ), a ));
+
+        lo = blend_argb_sse2( _mm_unpacklo_epi8( d, zero ), lo );
+        hi = blend_argb_sse2( _mm_unpackhi_epi8( d, zero ), hi );
+        if (overflow_sse2( lo, hi )) blend_argb_alpha_c( dst + x, src + x, 4, alpha );
+        else _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    blend_argb_alpha_c( dst + x, src + x, len - x, alpha );
+}
+
+static inline SSE2 __m128i blend_constant_sse2( __m128i dst, __m128i src, __m128i alpha, __m128i inv )
+{
+    return div255_sse2( _mm_add_epi16( _mm_mullo_epi16( src, alpha ), _mm_mullo_epi16( dst, inv )));
+}
+
+static SSE2 void blend_constant_alpha_sse2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    const __m128i zero = _mm_setzero_si128(), mask = _mm_set1_epi32( src_or );
+    const __m128i a = _mm_set1_epi16( alpha ), inv = _mm_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_or_si128( _mm_loadu_si128( (const __m128i *)(src + x) ), mask );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = blend_constant_sse2( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ), a, inv );
+        __m128i hi = blend_constant_sse2( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ), a, inv );
+
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    blend_constant_alpha_c( dst + x, src + x, len - x, alpha, src_or );
+}
+
+static SSE2 void rop_32_sse2_row( DWORD *dst, int len, DWORD and, DWORD xor )
+{
+    const __m128i a = _mm_set1_epi32( and ), x = _mm_set1_epi32( xor );
+    int i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + i) );
+        _mm_storeu_si128( (__m128i *)(dst + i), _mm_xor_si128( _mm_and_si128( d, a ), x ));
+    }
+    rop_32_c( dst + i, len - i, and, xor );
+}
+
+static const simd_funcs simd_sse2 =
+{
+    blend_argb_sse2_row,
+    blend_argb_alpha_sse2_row,
+    blend_constant_alpha_sse2_row,
+    rop_32_sse2_row,
+    convert_24_to_32_c
+};
+
+static inline AVX2 __m256i div255_avx2( __m256i x )
+{
+    x = _mm256_add_epi16( x, _mm256_set1_epi16( 128 ));
+    return _mm256_srli_epi16( _mm256_add_epi16( x, _mm256_srli_epi16( x, 8 )), 8 );
+}
+
+static inline AVX2 BOOL overflow_avx2( __m256i lo, __m256i hi )
+{
+    return !_mm256_testz_si256( _mm256_or_si256( lo, hi ), _mm256_set1_epi16( 0xff00 ));
+}
+
+static inline AVX2 __m256i blend_argb_avx2( __m256i dst, __m256i src )
+{
+    __m256i alpha = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( src, 0xff ), 0xff );
+    __m256i inv = _mm256_sub_epi16( _mm256_set1_epi16( 255 ), alpha );
+    return _mm256_add_epi16( src, div255_avx2( _mm256_mullo_epi16( dst, inv )));
+}
+
+static AVX2 void blend_argb_avx2_row( DWORD *dst, const DWORD *src, int len )
+{
+    const __m256i zero = _mm256_setzero_si256(), opaque = _mm256_set1_epi32( 0xff000000 );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_loadu_si256( (const __m256i *)(src + x) ), d, lo, hi;
+
+        if (_mm256_testz_si256( s, s )) continue;
+        if (_mm256_testc_si256( s, opaque ))
+        {
+            _mm256_storeu_si256( (__m256i *)(dst + x), s );
+            continue;
+        }
+        d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        lo = blend_argb_avx2( _mm256_unpacklo_epi8( d, zero ), _mm256_unpacklo_epi8( s, zero ));
+        hi = blend_argb_avx2( _mm256_unpackhi_epi8( d, zero ), _mm256_unpackhi_epi8( s, zero ));
+        if (overflow_avx2( lo, hi )) blend_argb_c( dst + x, src + x, 8 );
+        else _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    blend_argb_sse2_row( dst + x, src + x, len - x );
+}
+
+static AVX2 void blend_argb_alpha_avx2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const __m256i zero = _mm256_setzero_si256(), a = _mm256_set1_epi16( alpha );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_loadu_si256( (const __m256i *)(src + x) );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = div255_avx2( _mm256_mullo_epi16( _mm256_unpacklo_epi8( s, zero ), a ));
+        __m256i hi = div255_avx2( _mm256_mullo_epi16( _mm256_unpackhi_epi8( s, zero ), a ));
+
+        lo = blend_argb_avx2( _mm256_unpacklo_epi8( d, zero ), lo );
+        hi = blend_argb_avx2( _mm256_unpackhi_epi8( d, zero ), hi );
+        if (overflow_avx2( lo, hi )) blend_argb_alpha_c( dst + x, src + x, 8, alpha );
+        else _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    blend_argb_alpha_sse2_row( dst + x, src + x, len - x, alpha );
+}
+
+static AVX2 void blend_constant_alpha_avx2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    const __m256i zero = _mm256_setzero_si256(), mask = _mm256_set1_epi32( src_or );
+    const __m256i a = _mm256_set1_epi16( alpha ), inv = _mm256_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_or_si256( _mm256_loadu_si256( (const __m256i *)(src + x) ), mask );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpacklo_epi8( s, zero ), a ),
+                                       _mm256_mullo_epi16( _mm256_unpacklo_epi8( d, zero ), inv ));
+        __m256i hi = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpackhi_epi8( s, zero ), a ),
+                                       _mm256_mullo_epi16( _mm256_unpackhi_epi8( d, zero ), inv ));
+
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( div255_avx2( lo ), div255_avx2( hi )));
+    }
+    blend_constant_alpha_sse2_row( dst + x, src + x, len - x, alpha, src_or );
+}
+
+static AVX2 void rop_32_avx2_row( DWORD *dst, int len, DWORD and, DWORD xor )
+{
+    const __m256i a = _mm256_set1_epi32( and ), x = _mm256_set1_epi32( xor );
+    int i;
+
+    for (i = 0; i + 8 <= len; i += 8)
+    {
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + i) );
+        _mm256_storeu_si256( (__m256i *)(dst + i), _mm256_xor_si256( _mm256_and_si256( d, a ), x ));
+    }
+    rop_32_sse2_row( dst + i, len - i, and, xor );
+}
+
+static AVX2 void convert_24_to_32_avx2_row( DWORD *dst, const BYTE *src, int len )
+{
+    const __m128i shuffle = _mm_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+    int x;
+
+    /* each load reads 16 bytes for 4 pixels, stop early enough to not read past the row */
+    for (x = 0; x + 6 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x * 3) );
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_shuffle_epi8( s, shuffle ));
+    }
+    convert_24_to_32_c( dst + x, src + x * 3, len - x );
+}
+
+static const simd_funcs simd_avx2 =
+{
+    blend_argb_avx2_row,
+    blend_argb_alpha_avx2_row,
+    blend_constant_alpha_avx2_row,
+    rop_32_avx2_row,
+    convert_24_to_32_avx2_row
+};
+
+#endif  /* HAVE_DIB_SSE2 */
+
+#ifdef HAVE_DIB_NEON
+
+static inline uint16x8_t div255_neon( uint16x8_t x )
+{
+    x = vaddq_u16( x, vdupq_n_u16( 128 ));
+    return vshrq_n_u16( vsraq_n_u16( x, x, 8 ), 8 );
+}
+
+/* blend 8 premultiplied pixels, return FALSE if a channel overflows */
+static inline BOOL blend_argb_neon( uint8x8x4_t *dst, uint8x8x4_t src )
+{
+    uint8x8_t inv = vmvn_u8( src.val[3] );
+    uint16x8_t res[4], all;
+    int i;
+
+    for (i = 0; i < 4; i++) res[i] = vaddw_u8( div255_neon( vmull_u8( dst->val[i], inv )), src.val[i] );
+    all = vorrq_u16( vorrq_u16( res[0], res[1] ), vorrq_u16( res[2], res[3] ));
+    if (vmaxvq_u16( all ) > 255) return FALSE;
+    for (i = 0; i < 4; i++) dst->val[i] = vmovn_u16( res[i] );
+    return TRUE;
+}
+
+static void blend_argb_neon_row( DWORD *dst, const DWORD *src, int len )
+{
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        uint8x8x4_t s = vld4_u8( (const uint8_t *)(src + x) );
+        uint8x8x4_t d = vld4_u8( (const uint8_t *)(dst + x) );
+
+        if (blend_argb_neon( &d, s )) vst4_u8( (uint8_t *)(dst + x), d );
+        else blend_argb_c( dst + x, src + x, 8 );
+    }
+    blend_argb_c( dst + x, src + x, len - x );
+}
+
+static void blend_argb_alpha_neon_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const uint8x8_t a = vdup_n_u8( alpha );
+    int i, x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        uint8x8x4_t s = vld4_u8( (const uint8_t *)(src + x) );
+        uint8x8x4_t d = vld4_u8( (const uint8_t *)(dst + x) );
+
+        for (i = 0; i < 4; i++) s.val[i] = vmovn_u16( div255_neon( vmull_u8( s.val[i], a )));
+        if (blend_argb_neon( &d, s )) vst4_u8( (uint8_t *)(dst + x), d );
+        else blend_argb_alpha_c( dst + x, src + x, 8, alpha );
+    }
+    blend_argb_alpha_c( dst + x, src + x, len - x, alpha );
+}
+
+static void blend_constant_alpha_neon_row( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    const uint8x8_t a = vdup_n_u8( alpha ), inv = vdup_n_u8( 255 - alpha );
+    int i, x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        uint8x8x4_t s = vld4_u8( (const uint8_t *)(src + x) );
+        uint8x8x4_t d = vld4_u8( (const uint8_t *)(dst + x) );
+
+        for (i = 0; i < 4; i++)
+        {
+            uint8x8_t src_chan = vorr_u8( s.val[i], vdup_n_u8( src_or >> (8 * i) ));
+            d.val[i] = vmovn_u16( div255_neon( vmlal_u8( vmull_u8( src_chan, a ), d.val[i], inv )));
+        }
+        vst4_u8( (uint8_t *)(dst + x), d );
+    }
+    blend_constant_alpha_c( dst + x, src + x, len - x, alpha, src_or );
+}
+
+static void rop_32_neon_row( DWORD *dst, int len, DWORD and, DWORD xor )
+{
+    const uint32x4_t a = vdupq_n_u32( and ), x = vdupq_n_u32( xor );
+    int i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+        vst1q_u32( dst + i, veorq_u32( vandq_u32( vld1q_u32( dst + i ), a ), x ));
+    rop_32_c( dst + i, len - i, and, xor );
+}
+
+static void convert_24_to_32_neon_row( DWORD *dst, const BYTE *src, int len )
+{
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        uint8x8x3_t s = vld3_u8( src + x * 3 );
+        uint8x8x4_t d;
+
+        d.val[0] = s.val[0];
+        d.val[1] = s.val[1];
+        d.val[2] = s.val[2];
+        d.val[3] = vdup_n_u8( 0 );
+        vst4_u8( (uint8_t *)(dst + x), d );
+    }
+    convert_24_to_32_c( dst + x, src + x * 3, len - x );
+}
+
+static const simd_funcs simd_neon =
+{
+    blend_argb_neon_row,
+    blend_argb_alpha_neon_row,
+    blend_constant_alpha_neon_row,
+    rop_32_neon_row,
+    convert_24_to_32_neon_row
+};
+
+#endif  /* HAVE_DIB_NEON */
+
+const simd_funcs *dib_simd = &simd_c;
+
+#ifdef HAVE_DIB_SSE2
+/* The CPUID feature bits don't tell whether the OS saves the YMM registers;
+ * check that XCR0 has both the SSE and AVX state enabled. */
+static BOOL os_has_avx_state( ULONG features )
+{
+    unsigned int eax, edx;
+
+    if (!(features & CPU_FEATURE_XSAVE)) return FALSE;  /* OSXSAVE */
+    __asm__ __volatile__( "xgetbv" : "=a" (eax), "=d" (edx) : "c" (0) );
+    return (eax & 6) == 6;
+}
+#endif
+
+void init_dib_simd(void)
+{
+#ifdef HAVE_DIB_SSE2
+    SYSTEM_CPU_INFORMATION cpu_info;
+    const ULONG avx2 = CPU_FEATURE_AVX | CPU_FEATURE_AVX2;
+
+    if (NtQuerySystemInformation( SystemCpuInformation, &cpu_info, sizeof(cpu_info), NULL ))
+        return;
+
+    if ((cpu_info.ProcessorFeatureBits & avx2) == avx2 && os_has_avx_state( cpu_info.ProcessorFeatureBits ))
+    {
+        TRACE( "using AVX2 primitives\n" );
+        dib_simd = &simd_avx2;
+    }
+    else if (cpu_info.ProcessorFeatureBits & CPU_FEATURE_SSE2)
+    {
+        TRACE( "using SSE2 primitives\n" );
+        dib_simd = &simd_sse2;
+    }
+#elif defined(HAVE_DIB_NEON)
+    TRACE( "using NEON primitives\n" );
+    dib_simd = &simd_neon;
+#endif
+}
@@ -49,6 +49,9 @@ WINE_DEFAULT_DEBUG_CHANNEL(font);
 
 static HKEY wine_fonts_key;
 static HKEY wine_fonts_cache_key;
+static HANDLE font_mutex;  /* serializes font cache updates across processes */
+static unsigned int font_cache_lock_count;  /* recursion count of the font mutex */
+static BOOL font_index_invalidated;  /* the index is already gone while we hold the font mutex */
 HKEY hkcu_key;
 
 struct font_physdev
@@ -198,6 +201,8 @@ static struct font_gamma_ramp font_gamma_ramp;
 
 static void add_face_to_cache( struct gdi_font_face *face );
 static void remove_face_from_cache( struct gdi_font_face *face );
+static void lock_font_cache(void);
+static void unlock_font_cache(void);
 
 static CPTABLEINFO utf8_cp;
 static CPTABLEINFO oem_cp;
@@ -1059,6 +1064,7 @@ static int remove_font( const WCHAR *file, DWORD flags )
     int count = 0;
 
     pthread_mutex_lock( &font_lock );
+    if (flags & ADDFONT_ADD_TO_CACHE) lock_font_cache();
     WINE_RB_FOR_EACH_ENTRY_DESTRUCTOR( family, family_next, &family_name_tree, struct gdi_font_family, name_entry )
     {
         family->refcount++;
@@ -1075,6 +1081,7 @@ static int remove_font( const WCHAR *file, DWORD flags )
 	}
         release_family( family );
     }
+    if (flags & ADDFONT_ADD_TO_CACHE) unlock_font_cache();
     pthread_mutex_unlock( &font_lock );
     return count;
 }
@@ -1340,16 +1347,393 @@ static void load_font_list_from_cache(void)
     }
 }
 
+/* shared font index
+ *
+ * The font list built by the first process of the session is stored in a named
+ * section, in the same order as the family tree, so that other processes can
+ * recreate it without scanning the font directories and the registry cache.
+ * The serial of the current index is stored in the "Index" value of the cache key.
+ */
+
+#define FONT_INDEX_MAGIC     0x78646966  /* "fidx" */
+#define FONT_INDEX_VERSION   1
+#define FONT_INDEX_NO_STRING (~0u)
+
+struct font_index_header
+{
+    DWORD magic;
+    DWORD version;
+    DWORD size;             /* total size of the index */
+    DWORD family_count;
+    DWORD face_count;
+    DWORD strings_size;     /* size of the string pool in WCHARs */
+    /* struct font_index_family families[family_count]; */
+    /* struct font_index_face   faces[face_count]; */
+    /* WCHAR                    strings[strings_size]; */
+};
+
+struct font_index_family
+{
+    DWORD name;             /* offsets in the string pool */
+    DWORD second_name;
+    DWORD first_face;
+    DWORD face_count;
+};
+
+struct font_index_face
+{
+    DWORD                   style_name;
+    DWORD                   full_name;
+    DWORD                   file;
+    DWORD                   index;
+    DWORD                   flags;
+    DWORD                   ntmflags;
+    DWORD                   version;
+    DWORD                   scalable;
+    DWORD                   extra_refs;     /* times the face was added again */
+    DWORD                   full_name_entry; /* face is the one found by full name */
+    struct bitmap_font_size size;
+    FONTSIGNATURE           fs;
+};
+
+static const WCHAR font_index_valueW[] = {'I','n','d','e','x',0};
+
+static void get_font_index_name( DWORD serial, UNICODE_STRING *str, WCHAR *buffer )
+{
+    char name[64];
+
+    sprintf( name, "\\??\\__wine_font_index_%08x", (int)serial );
+    str->Buffer = buffer;
+    str->Length = asciiz_to_unicode( buffer, name ) - sizeof(WCHAR);
+    str->MaximumLength = str->Length + sizeof(WCHAR);
+}
+
+static DWORD get_font_index_serial(void)
+{
+    char buffer[FIELD_OFFSET(KEY_VALUE_PARTIAL_INFORMATION, Data[sizeof(DWORD)])];
+    KEY_VALUE_PARTIAL_INFORMATION *info = (void *)buffer;
+
+    if (query_reg_value( wine_fonts_cache_key, font_index_valueW, info, sizeof(buffer) ) != sizeof(DWORD) ||
+        info->Type != REG_DWORD)
+        return 0;
+    return *(DWORD *)info->Data;
+}
+
+static inline const WCHAR *get_font_index_string( const struct font_index_header *header, DWORD offset )
+{
+    const struct font_index_family *families = (const struct font_index_family *)(header + 1);
+    const struct font_index_face *faces = (const struct font_index_face *)(families + header->family_count);
+
+    if (offset == FONT_INDEX_NO_STRING) return NULL;
+    return (const WCHAR *)(faces + header->face_count) + offset;
+}
+
+static BOOL is_valid_font_index( const struct font_index_header *header, SIZE_T size )
+{
+    const struct font_index_family *families = (const struct font_index_family *)(header + 1);
+    const struct font_index_face *faces = (const struct font_index_face *)(families + header->family_count);
+    ULONGLONG total;
+    DWORD i;
+
+#define CHECK_STRING(offset) \
+    ((offset) == FONT_INDEX_NO_STRING || (offset) < header->strings_size)
+
+    if (size < sizeof(*header) || header->magic != FONT_INDEX_MAGIC ||
+        header->version != FONT_INDEX_VERSION || header->size > size)
+        return FALSE;
+
+    total = sizeof(*header) + (ULONGLONG)header->family_count * sizeof(*families) +
+            (ULONGLONG)header->face_count * sizeof(*faces) + (ULONGLONG)header->strings_size * sizeof(WCHAR);
+    if (total != header->size || !header->strings_size) return FALSE;
+    /* this ensures that all strings are terminated */
+    if (get_font_index_string( header, header->strings_size - 1 )[0]) return FALSE;
+
+    for (i = 0; i < header->family_count; i++)
+    {
+        if (families[i].name == FONT_INDEX_NO_STRING || !CHECK_STRING( families[i].name ) ||
+            !CHECK_STRING( families[i].second_name ) || families[i].first_face > header->face_count ||
+            families[i].face_count > header->face_count - families[i].first_face)
+            return FALSE;
+    }
+    for (i = 0; i < header->face_count; i++)
+    {
+        if (faces[i].style_name == FONT_INDEX_NO_STRING || !CHECK_STRING( faces[i].style_name ) ||
+            faces[i].file == FONT_INDEX_NO_STRING || !CHECK_STRING( faces[i].file ) ||
+            !CHECK_STRING( faces[i].full_name ) || (faces[i].scalable && faces[i].full_name == FONT_INDEX_NO_STRING))
+            return FALSE;
+    }
+    return TRUE;
+
+#undef CHECK_STRING
+}
+
+static void load_face_from_index( const struct font_index_header *header, struct gdi_font_family *family,
+                                  const struct font_index_face *index_face )
+{
+    struct gdi_font_face *face;
+    struct wine_rb_entry *entry;
+
+    if (!(face = create_face( family, get_font_index_string( header, index_face->style_name ),
+                              get_font_index_string( header, index_face->full_name ),
+                              get_font_index_string( header, index_face->file ), NULL, 0,
+                              index_face->index, index_face->fs, index_face->ntmflags, index_face->version,
+                              index_face->flags, index_face->scalable ? NULL : &index_face->size )))
+        return;
+
+    face->refcount += index_face->extra_refs;
+
+    /* make sure lookups by full name return the same face as in the original list */
+    if (index_face->full_name_entry && !face_is_in_full_name_tree( face ) &&
+        (entry = wine_rb_get( &face_full_name_tree, face->full_name )))
+    {
+        wine_rb_replace( &face_full_name_tree, entry, &face->full_name_entry );
+        memset( entry, 0, sizeof(*entry) );
+    }
+    else if (!index_face->full_name_entry && face_is_in_full_name_tree( face ))
+    {
+        wine_rb_remove( &face_full_name_tree, &face->full_name_entry );
+        memset( &face->full_name_entry, 0, sizeof(face->full_name_entry) );
+    }
+    release_face( face );
+}
+
+static BOOL load_font_list_from_index(void)
+{
+    const struct font_index_header *header = NULL;
+    const struct font_index_family *families;
+    const struct font_index_face *faces;
+    struct gdi_font_family *family;
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    WCHAR buffer[64];
+    const WCHAR *family_name;
+    SIZE_T size = 0;
+    HANDLE handle;
+    DWORD i, j, serial;
+    BOOL ret;
+
+    if (!(serial = get_font_index_serial())) return FALSE;
+
+    get_font_index_name( serial, &name, buffer );
+    InitializeObjectAttributes( &attr, &name, 0, NULL, NULL );
+    if (NtOpenSection( &handle, SECTION_MAP_READ, &attr )) return FALSE;
+    ret = !NtMapViewOfSection( handle, GetCurrentProcess(), (void **)&header, 0, 0, NULL,
+                               &size, ViewShare, 0, PAGE_READONLY );
+    NtClose( handle );
+    if (!ret) return FALSE;
+
+    if ((ret = is_valid_font_index( header, size )))
+    {
+        families = (const struct font_index_family *)(header + 1);
+        faces = (const struct font_index_face *)(families + header->family_count);
+
+        for (i = 0; i < header->family_count; i++)
+        {
+            family_name = get_font_index_string( header, families[i].name );
+            if ((family = find_family_from_name( family_name ))) family->refcount++;
+            else family = create_family( family_name, get_font_index_string( header, families[i].second_name ));
+
+            for (j = 0; j < families[i].face_count; j++)
+                load_face_from_index( header, family, &faces[families[i].first_face + j] );
+            release_family( family );
+        }
+        TRACE( "loaded %u families and %u faces from index %08x\n",
+               (int)header->family_count, (int)header->face_count, (int)serial );
+    }
+    else WARN( "invalid font index %08x\n", (int)serial );
+
+    NtUnmapViewOfSection( GetCurrentProcess(), (void *)header );
+    return ret;
+}
+
+static inline BOOL face_can_be_indexed( const struct gdi_font_face *face )
+{
+    return face->file && !face->data_ptr;
+}
+
+static DWORD add_font_index_string( WCHAR *strings, DWORD *pos, const WCHAR *str )
+{
+    DWORD ret = *pos, len;
+
+    if (!str) return FONT_INDEX_NO_STRING;
+    len = lstrlenW( str ) + 1;
+    if (strings) memcpy( strings + ret, str, len * sizeof(WCHAR) );
+    *pos += len;
+    return ret;
+}
+
+/* walk the font list, filling the index if the arrays are not NULL */
+static void fill_font_index( struct font_index_family *families, struct font_index_face *faces,
+                             WCHAR *strings, DWORD *family_count, DWORD *face_count, DWORD *strings_size )
+{
+    struct gdi_font_family *family;
+    struct gdi_font_face *face;
+    DWORD first;
+
+    *family_count = *face_count = *strings_size = 0;
+
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+    {
+        first = *face_count;
+        LIST_FOR_EACH_ENTRY( face, &family->faces, struct gdi_font_face, entry )
+        {
+            struct font_index_face *index_face = faces ? &faces[*face_count] : NULL;
+            DWORD style_name, full_name, file;
+
+            if (!face_can_be_indexed( face )) continue;
+            style_name = add_font_index_string( strings, strings_size, face->style_name );
+            full_name = add_font_index_string( strings, strings_size, face->full_name );
+            file = add_font_index_string( strings, strings_size, face->file );
+            (*face_count)++;
+            if (!index_face) continue;
+
+            memset( index_face, 0, sizeof(*index_face) );
+            index_face->style_name = style_name;
+            index_face->full_name = full_name;
+            index_face->file = file;
+            index_face->index = face->face_index;
+            index_face->flags = face->flags;
+            index_face->ntmflags = face->ntmFlags;
+            index_face->version = face->version;
+            index_face->scalable = face->scalable;
+            index_face->extra_refs = face->refcount - 1;
+            index_face->full_name_entry = face_is_in_full_name_tree( face );
+            if (!face->scalable) index_face->size = face->size;
+            index_face->fs = face->fs;
+        }
+        if (*face_count == first) continue;
+
+        if (families)
+        {
+            families[*family_count].name = add_font_index_string( strings, strings_size, family->family_name );
+            families[*family_count].second_name = add_font_index_string( strings, strings_size, family->second_name );
+            families[*family_count].first_face = first;
+            families[*family_count].face_count = *face_count - first;
+        }
+        else
+        {
+            add_font_index_string( NULL, strings_size, family->family_name );
+            add_font_index_string( NULL, strings_size, family->second_name );
+        }
+        (*family_count)++;
+    }
+}
+
+static void create_font_index(void)
+{
+    struct font_index_header *header = NULL;
+    struct font_index_family *families;
+    struct font_index_face *faces;
+    DWORD family_count, face_count, strings_size, serial, i;
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    LARGE_INTEGER size_l;
+    WCHAR buffer[64];
+    unsigned int status;
+    HANDLE handle;
+    SIZE_T size;
+
+    fill_font_index( NULL, NULL, NULL, &family_count, &face_count, &strings_size );
+    if (!family_count) return;
+
+    size = sizeof(*header) + family_count * sizeof(*families) + face_count * sizeof(*faces) +
+           strings_size * sizeof(WCHAR);
+    if (size > 0x7fffffff) return;
+    size_l.QuadPart = size;
+
+    /* the section stays around as long as the cache key, until it gets invalidated */
+    serial = NtGetTickCount();
+    for (i = 0; i < 16; i++, serial++)
+    {
+        if (!serial) serial++;
+        get_font_index_name( serial, &name, buffer );
+        InitializeObjectAttributes( &attr, &name, OBJ_PERMANENT, NULL, NULL );
+        status = NtCreateSection( &handle, SECTION_ALL_ACCESS, &attr, &size_l, PAGE_READWRITE, SEC_COMMIT, NULL );
+        if (status != STATUS_OBJECT_NAME_COLLISION) break;
+    }
+    if (status)
+    {
+        WARN( "failed to create font index section, status %#x\n", status );
+        return;
+    }
+
+    size = 0;
+    if ((status = NtMapViewOfSection( handle, GetCurrentProcess(), (void **)&header, 0, 0, NULL,
+                                      &size, ViewShare, 0, PAGE_READWRITE )))
+    {
+        WARN( "failed to map font index section, status %#x\n", status );
+        NtMakeTemporaryObject( handle );
+        NtClose( handle );
+        return;
+    }
+
+    families = (struct font_index_family *)(header + 1);
+    faces = (struct font_index_face *)(families + family_count);
+    fill_font_index( families, faces, (WCHAR *)(faces + face_count),
+                     &header->family_count, &header->face_count, &header->strings_size );
+    header->size = size_l.QuadPart;
+    header->version = FONT_INDEX_VERSION;
+    header->magic = FONT_INDEX_MAGIC;
+    NtUnmapViewOfSection( GetCurrentProcess(), header );
+    NtClose( handle );
+
+    set_reg_value( wine_fonts_cache_key, font_index_valueW, REG_DWORD, &serial, sizeof(serial) );
+    TRACE( "created index %08x with %u families and %u faces\n", (int)serial, (int)family_count, (int)face_count );
+}
+
+/* the font list changed, make other processes rebuild it the slow way */
+static void invalidate_font_index(void)
+{
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    WCHAR buffer[64];
+    HANDLE handle;
+    DWORD serial;
+
+    /* nobody can publish a new index until the font mutex is released */
+    if (font_index_invalidated) return;
+    font_index_invalidated = TRUE;
+
+    if (!(serial = get_font_index_serial())) return;
+
+    reg_delete_value( wine_fonts_cache_key, font_index_valueW );
+    get_font_index_name( serial, &name, buffer );
+    InitializeObjectAttributes( &attr, &name, 0, NULL, NULL );
+    if (NtOpenSection( &handle, DELETE, &attr )) return;
+    NtMakeTemporaryObject( handle );
+    NtClose( handle );
+}
+
+/* another process may be building the index from the cache key */
+static void lock_font_cache(void)
+{
+    if (!font_mutex) return;
+    NtWaitForSingleObject( font_mutex, FALSE, NULL );
+    font_cache_lock_count++;
+}
+
+static void unlock_font_cache(void)
+{
+    if (!font_mutex) return;
+    if (!--font_cache_lock_count) font_index_invalidated = FALSE;
+    NtReleaseMutant( font_mutex, NULL );
+}
+
 static void add_face_to_cache( struct gdi_font_face *face )
 {
     HKEY hkey_family, hkey_face;
     DWORD len, buffer[1024];
     struct cached_face *cached = (struct cached_face *)buffer;
 
+    lock_font_cache();
+    invalidate_font_index();
     if (!(hkey_family = reg_create_key( wine_fonts_cache_key, face->family->family_name,
                                         lstrlenW( face->family->family_name ) * sizeof(WCHAR),
                                         REG_OPTION_VOLATILE, NULL )))
+    {
+        unlock_font_cache();
         return;
+    }
 
     if (face->family->second_name[0])
         set_reg_value( hkey_family, NULL, REG_SZ, face->family->second_name,
@@ -1384,15 +1768,22 @@ static void add_face_to_cache( struct gdi_font_face *face )
 
     if (hkey_face != hkey_family) NtClose( hkey_face );
     NtClose( hkey_family );
+    unlock_font_cache();
 }
 
 static void remove_face_from_cache( struct gdi_font_face *face )
 {
     HKEY hkey_family, hkey;
 
+    lock_font_cache();
+    invalidate_font_index();
+
     if (!(hkey_family = reg_open_key( wine_fonts_cache_key, face->family->family_name,
                                       lstrlenW( face->family->family_name ) * sizeof(WCHAR) )))
+    {
+        unlock_font_cache();
         return;
+    }
 
     if (!face->scalable)
     {
@@ -1409,6 +1800,7 @@ static void remove_face_from_cache( struct gdi_font_face *face )
     else reg_delete_value( hkey_family, face->style_name );
 
     NtClose( hkey_family );
+    unlock_font_cache();
 }
 
 /* font links */
@@ -3867,11 +4259,16 @@ static DWORD get_glyph_outline( struct gdi_font *font, UINT glyph, UINT format,
     if (format == GGO_METRICS && !mat && get_gdi_font_glyph_metrics( font, index, &gm, &abc ))
         goto done;
 
+    if (!mat && get_shared_glyph( font, index, format, tategaki, &gm, &abc, buflen, buf, &ret ))
+        goto done;
+
     ret = font_funcs->get_glyph_outline( font, index, format, &gm, &abc, buflen, buf, mat, tategaki );
     if (ret == GDI_ERROR) return ret;
 
     if (format == GGO_METRICS && !mat)
         set_gdi_font_glyph_metrics( font, index, &gm, &abc );
+    else if (!mat && buf && buflen)
+        put_shared_glyph( font, index, format, tategaki, &gm, &abc, ret, buf );
 
 done:
     if (gm_ret) *gm_ret = gm;
@@ -4811,6 +5208,13 @@ static UINT init_font_options(void)
         antialias_fakes = (wcschr( valsW, *(const WCHAR *)info->Data ) != NULL);
     }
 
+    if (query_reg_ascii_value( wine_fonts_key, "SharedGlyphCache",
+                               info, sizeof(value_buffer) ) && info->Type == REG_SZ)
+    {
+        static const WCHAR valsW[] = {'y','Y','t','T','1',0};
+        if (wcschr( valsW, *(const WCHAR *)info->Data )) init_shared_glyph_cache();
+    }
+
     if ((key = reg_open_hkcu_key( "Control Panel\\Desktop" )))
     {
         /* FIXME: handle vertical orientations even though Windows doesn't */
@@ -6486,7 +6890,10 @@ static int add_font_resource( LPCWSTR file, DWORD flags )
 
         if (!(flags & FR_PRIVATE)) addfont_flags |= ADDFONT_ADD_TO_CACHE;
         pthread_mutex_lock( &font_lock );
+        /* invalidate the index only once for all the faces of the file */
+        if (addfont_flags & ADDFONT_ADD_TO_CACHE) lock_font_cache();
         ret = font_funcs->add_font( file, addfont_flags );
+        if (addfont_flags & ADDFONT_ADD_TO_CACHE) unlock_font_cache();
         pthread_mutex_unlock( &font_lock );
     }
     else if (!wcschr( file, '\\' ))
@@ -6807,34 +7214,42 @@ UINT font_init(void)
     if (!(font_funcs = init_freetype_lib()))
         return dpi;
 
-    load_system_bitmap_fonts();
-    load_file_system_fonts();
-    font_funcs->load_fonts();
-
     attr.Attributes = OBJ_OPENIF;
     attr.ObjectName = &name;
     name.Buffer = wine_font_mutexW;
     name.Length = name.MaximumLength = sizeof(wine_font_mutexW);
 
-    if (NtCreateMutant( &mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0) return dpi;
+    if (NtCreateMutant( &mutex, MUTEX_ALL_ACCESS, &attr, FALSE ) < 0)
+    {
+        load_system_bitmap_fonts();
+        load_file_system_fonts();
+        font_funcs->load_fonts();
+        return dpi;
+    }
     NtWaitForSingleObject( mutex, FALSE, NULL );
 
     wine_fonts_cache_key = reg_create_key( wine_fonts_key, cacheW, sizeof(cacheW),
                                            REG_OPTION_VOLATILE, &disposition );
 
-    if (disposition == REG_CREATED_NEW_KEY)
+    /* the font list is built only once per session, other processes load it from the index */
+    if (disposition == REG_CREATED_NEW_KEY || !load_font_list_from_index())
     {
+        /* the font mutex is held during the whole scan, so the faces added
+         * to the cache only need to invalidate the index once */
+        invalidate_font_index();
+        load_system_bitmap_fonts();
+        load_file_system_fonts();
+        font_funcs->load_fonts();
+
         load_registry_fonts();
-        update_external_font_keys();
+        if (disposition == REG_CREATED_NEW_KEY) update_external_font_keys();
+        else load_font_list_from_cache();
+        create_font_index();
+        font_index_invalidated = FALSE;
     }
 
     NtReleaseMutant( mutex, NULL );
-
-    if (disposition != REG_CREATED_NEW_KEY)
-    {
-        load_registry_fonts();
-        load_font_list_from_cache();
-    }
+    font_mutex = mutex;
 
     reorder_font_list();
     load_gdi_font_subst();
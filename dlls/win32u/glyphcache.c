@@ -0,0 +1,349 @@
+/*
+ * Glyph bitmap cache shared between processes
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#if 0
+#pragma makedep unix
+#endif
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winbase.h"
+#include "winternl.h"
+#include "ntgdi_private.h"
+#include "wine/debug.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(font);
+
+/*
+ * The cache is a set-associative hash table of fixed size entries living in a
+ * named section. Lookups don't take any lock: each entry has a sequence number
+ * which is odd while the entry is being written, and readers treat a sequence
+ * change during the copy as a miss. Writers claim an entry by making its
+ * sequence odd, replacing the least recently used entry of the set.
+ * Glyphs that don't fit in an entry are not cached.
+ */
+
+#define GLYPH_CACHE_MAGIC       0x68636c67  /* "glch" */
+#define GLYPH_CACHE_VERSION     1
+#define GLYPH_CACHE_SIZE        (16 * 1024 * 1024)
+#define GLYPH_CACHE_ENTRY_SIZE  2048
+#define GLYPH_CACHE_WAYS        8
+
+struct shared_glyph_header
+{
+    LONG         seq;          /* odd while being written, 0 if never used */
+    LONG         last_use;     /* cache clock at the last lookup */
+    UINT64       font_key[2];
+    UINT         index;
+    UINT         format;
+    UINT         tategaki;
+    DWORD        size;         /* size of the bitmap, also the glyph outline return value */
+    GLYPHMETRICS gm;
+    ABC          abc;
+};
+
+struct shared_glyph
+{
+    struct shared_glyph_header hdr;
+    BYTE                       bits[GLYPH_CACHE_ENTRY_SIZE - sizeof(struct shared_glyph_header)];
+};
+
+struct shared_glyph_cache
+{
+    LONG  magic;
+    DWORD version;
+    DWORD set_count;
+    LONG  clock;
+    BYTE  padding[GLYPH_CACHE_ENTRY_SIZE - 4 * sizeof(DWORD)];
+    struct shared_glyph glyphs[1];
+};
+
+#define GLYPH_CACHE_SETS ((GLYPH_CACHE_SIZE - offsetof( struct shared_glyph_cache, glyphs )) / \
+                          sizeof(struct shared_glyph) / GLYPH_CACHE_WAYS)
+
+static struct shared_glyph_cache *glyph_cache;
+
+/* FNV-1a */
+static UINT64 hash_bytes( UINT64 hash, const void *data, SIZE_T size )
+{
+    const BYTE *ptr = data;
+    while (size--) hash = (hash ^ *ptr++) * 0x100000001b3ull;
+    return hash;
+}
+
+static void hash_font( struct gdi_font *font, UINT64 key[2] )
+{
+    struct
+    {
+        FILETIME writetime;
+        LOGFONTW lf;
+        FMAT2    matrix;
+        UINT     face_index;
+        ULONG    ttc_item_offset;
+        INT      scale_y;
+        INT      ave_width;
+        INT      ppem;
+        UINT     ntm_flags;
+        UINT     ntm_avg_width;
+        UINT     aa_flags;
+        UINT     charset;
+        UINT     flags;
+    } data;
+
+    memset( &data, 0, sizeof(data) );
+    data.writetime       = font->writetime;
+    data.lf              = font->lf;
+    data.matrix          = font->matrix;
+    data.face_index      = font->face_index;
+    data.ttc_item_offset = font->ttc_item_offset;
+    data.scale_y         = font->scale_y;
+    data.ave_width       = font->aveWidth;
+    data.ppem            = font->ppem;
+    data.ntm_flags       = font->ntmFlags;
+    data.ntm_avg_width   = font->ntmAvgWidth;
+    data.aa_flags        = font->aa_flags;
+    data.charset         = font->charset;
+    data.flags           = font->can_use_bitmap | font->fake_italic << 1 | font->fake_bold << 2 |
+                           font->scalable << 3;
+    /* the face name doesn't change the rendering, ignore it so that aliases share glyphs */
+    memset( data.lf.lfFaceName, 0, sizeof(data.lf.lfFaceName) );
+
+    key[0] = hash_bytes( key[0], &data, sizeof(data) );
+    key[0] = hash_bytes( key[0], font->file, lstrlenW( font->file ) * sizeof(WCHAR) );
+    key[1] = hash_bytes( key[1], font->file, lstrlenW( font->file ) * sizeof(WCHAR) );
+    key[1] = hash_bytes( key[1], &data, sizeof(data) );
+}
+
+/* compute the key identifying the rendering of the font, return FALSE if it can't be shared */
+static BOOL get_font_key( struct gdi_font *font, UINT64 key[2] )
+{
+    if (font->data_ptr) return FALSE;  /* memory fonts are private to the process */
+    if (font->base_font && font->base_font->data_ptr) return FALSE;
+
+    if (!font->shared_key[0] && !font->shared_key[1])
+    {
+        UINT64 hash[2] = { 0xcbf29ce484222325ull, 0x84222325cbf29ce4ull };
+
+        hash_font( font, hash );
+        /* linked fonts use some of the base font metrics */
+        if (font->base_font) hash_font( font->base_font, hash );
+        font->shared_key[1] = hash[1];
+        font->shared_key[0] = hash[0];
+    }
+    key[0] = font->shared_key[0];
+    key[1] = font->shared_key[1];
+    return TRUE;
+}
+
+static BOOL is_cacheable_format( UINT format )
+{
+    switch (format & ~GGO_UNHINTED)
+    {
+    case GGO_BITMAP:
+    case GGO_GRAY2_BITMAP:
+    case GGO_GRAY4_BITMAP:
+    case GGO_GRAY8_BITMAP:
+    case WINE_GGO_GRAY16_BITMAP:
+    case WINE_GGO_HRGB_BITMAP:
+    case WINE_GGO_HBGR_BITMAP:
+    case WINE_GGO_VRGB_BITMAP:
+    case WINE_GGO_VBGR_BITMAP:
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static struct shared_glyph *get_glyph_set( const UINT64 key[2], UINT index, UINT format )
+{
+    UINT64 hash = key[0] ^ ((UINT64)index * 0x9e3779b97f4a7c15ull) ^ format;
+    return &glyph_cache->glyphs[(hash % GLYPH_CACHE_SETS) * GLYPH_CACHE_WAYS];
+}
+
+static inline BOOL glyph_matches( const struct shared_glyph_header *hdr, const UINT64 key[2],
+                                  UINT index, UINT format, BOOL tategaki )
+{
+    return hdr->font_key[0] == key[0] && hdr->font_key[1] == key[1] &&
+           hdr->index == index && hdr->format == format && hdr->tategaki == tategaki;
+}
+
+/***********************************************************************
+ *           get_shared_glyph
+ *
+ * Look up a glyph bitmap in the shared cache, with the same semantics as the
+ * backend get_glyph_outline(). Return FALSE if it's not found.
+ */
+BOOL get_shared_glyph( struct gdi_font *font, UINT index, UINT format, BOOL tategaki,
+                       GLYPHMETRICS *gm, ABC *abc, DWORD buflen, void *buf, DWORD *ret )
+{
+    struct shared_glyph *set, *glyph;
+    UINT64 key[2];
+    LONG seq;
+    DWORD size;
+    UINT i;
+
+    if (!glyph_cache || !is_cacheable_format( format ) || !get_font_key( font, key )) return FALSE;
+
+    set = get_glyph_set( key, index, format );
+    for (i = 0; i < GLYPH_CACHE_WAYS; i++)
+    {
+        glyph = &set[i];
+        seq = __atomic_load_n( &glyph->hdr.seq, __ATOMIC_ACQUIRE );
+        if (!seq || (seq & 1)) continue;
+        if (!glyph_matches( &glyph->hdr, key, index, format, tategaki )) continue;
+
+        size = glyph->hdr.size;
+        if (size > sizeof(glyph->bits)) return FALSE;
+        /* let the backend fail the same way */
+        if (buf && buflen && size > buflen) return FALSE;
+        *gm = glyph->hdr.gm;
+        *abc = glyph->hdr.abc;
+        if (buf && buflen)
+        {
+            memset( buf, 0, buflen );
+            memcpy( buf, glyph->bits, size );
+        }
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        /* the entry was replaced while we were reading it */
+        if (__atomic_load_n( &glyph->hdr.seq, __ATOMIC_RELAXED ) != seq) return FALSE;
+
+        glyph->hdr.last_use = __atomic_load_n( &glyph_cache->clock, __ATOMIC_RELAXED );
+        *ret = size;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/***********************************************************************
+ *           put_shared_glyph
+ *
+ * Store a glyph bitmap returned by the backend in the shared cache.
+ */
+void put_shared_glyph( struct gdi_font *font, UINT index, UINT format, BOOL tategaki,
+                       const GLYPHMETRICS *gm, const ABC *abc, DWORD size, const void *bits )
+{
+    struct shared_glyph *set, *glyph = NULL;
+    ULONG age, oldest = 0;
+    LONG seq, clock;
+    UINT64 key[2];
+    UINT i;
+
+    if (!glyph_cache || !is_cacheable_format( format ) || !get_font_key( font, key )) return;
+    if (size > sizeof(glyph->bits)) return;
+
+    clock = __atomic_add_fetch( &glyph_cache->clock, 1, __ATOMIC_RELAXED );
+    set = get_glyph_set( key, index, format );
+    for (i = 0; i < GLYPH_CACHE_WAYS; i++)
+    {
+        seq = __atomic_load_n( &set[i].hdr.seq, __ATOMIC_ACQUIRE );
+        if (seq & 1) continue;  /* being written by someone else */
+        if (!seq)
+        {
+            glyph = &set[i];
+            break;
+        }
+        if (glyph_matches( &set[i].hdr, key, index, format, tategaki )) return;
+        age = (ULONG)clock - (ULONG)set[i].hdr.last_use;
+        if (!glyph || age > oldest)
+        {
+            oldest = age;
+            glyph = &set[i];
+        }
+    }
+    if (!glyph) return;
+
+    seq = __atomic_load_n( &glyph->hdr.seq, __ATOMIC_RELAXED );
+    if ((seq & 1) || !__atomic_compare_exchange_n( &glyph->hdr.seq, &seq, seq + 1, FALSE,
+                                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ))
+        return;
+
+    glyph->hdr.font_key[0] = key[0];
+    glyph->hdr.font_key[1] = key[1];
+    glyph->hdr.index       = index;
+    glyph->hdr.format      = format;
+    glyph->hdr.tategaki    = tategaki;
+    glyph->hdr.size        = size;
+    glyph->hdr.gm          = *gm;
+    glyph->hdr.abc         = *abc;
+    glyph->hdr.last_use    = clock;
+    memcpy( glyph->bits, bits, size );
+
+    __atomic_store_n( &glyph->hdr.seq, seq + 2, __ATOMIC_RELEASE );
+}
+
+/***********************************************************************
+ *           init_shared_glyph_cache
+ */
+void init_shared_glyph_cache(void)
+{
+    static const WCHAR glyph_cacheW[] =
+        {'\\','?','?','\\','_','_','w','i','n','e','_','g','l','y','p','h','_','c','a','c','h','e',0};
+    struct shared_glyph_cache *cache = NULL;
+    UNICODE_STRING name;
+    OBJECT_ATTRIBUTES attr;
+    LARGE_INTEGER size_l;
+    unsigned int status;
+    HANDLE handle;
+    SIZE_T size = 0;
+    LONG magic = 0;
+
+    RtlInitUnicodeString( &name, glyph_cacheW );
+    InitializeObjectAttributes( &attr, &name, OBJ_OPENIF | OBJ_PERMANENT, NULL, NULL );
+    size_l.QuadPart = GLYPH_CACHE_SIZE;
+    status = NtCreateSection( &handle, SECTION_ALL_ACCESS, &attr, &size_l, PAGE_READWRITE, SEC_COMMIT, NULL );
+    if (status && status != STATUS_OBJECT_NAME_EXISTS)
+    {
+        WARN( "failed to create glyph cache section, status %#x\n", status );
+        return;
+    }
+    status = NtMapViewOfSection( handle, GetCurrentProcess(), (void **)&cache, 0, 0, NULL,
+                                 &size, ViewShare, 0, PAGE_READWRITE );
+    NtClose( handle );
+    if (status)
+    {
+        WARN( "failed to map glyph cache section, status %#x\n", status );
+        return;
+    }
+
+    if (size >= GLYPH_CACHE_SIZE)
+    {
+        /* all processes write the same values, the magic is set last */
+        if (!__atomic_load_n( &cache->magic, __ATOMIC_ACQUIRE ))
+        {
+            cache->version = GLYPH_CACHE_VERSION;
+            cache->set_count = GLYPH_CACHE_SETS;
+            __atomic_compare_exchange_n( &cache->magic, &magic, GLYPH_CACHE_MAGIC, FALSE,
+                                         __ATOMIC_RELEASE, __ATOMIC_RELAXED );
+        }
+        if (__atomic_load_n( &cache->magic, __ATOMIC_ACQUIRE ) == GLYPH_CACHE_MAGIC &&
+            cache->version == GLYPH_CACHE_VERSION && cache->set_count == GLYPH_CACHE_SETS)
+        {
+            TRACE( "using shared glyph cache %p, %u sets\n", cache, (int)cache->set_count );
+            glyph_cache = cache;
+            return;
+        }
+    }
+
+    WARN( "incompatible glyph cache, not using it\n" );
+    NtUnmapViewOfSection( GetCurrentProcess(), cache );
+}
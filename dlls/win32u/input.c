@@ -657,9 +657,9 @@ static void update_mouse_coords( INPUT *input )
  */
 UINT WINAPI NtUserSendInput( UINT count, INPUT *inputs, int size )
 {
-    UINT i;
-    NTSTATUS status = STATUS_SUCCESS;
-    RAWINPUT rawinput;
+    UINT i, j, sent;
+    NTSTATUS status;
+    INPUT batch[64];
 
     if (size != sizeof(INPUT))
     {
@@ -679,28 +679,36 @@ UINT WINAPI NtUserSendInput( UINT count, INPUT *inputs, int size )
         return 0;
     }
 
-    for (i = 0; i < count; i++)
+    for (i = 0; i < count; i += j)
     {
-        INPUT input = inputs[i];
-        switch (input.type)
+        /* send consecutive mouse and keyboard inputs together */
+        for (j = 0; j < ARRAY_SIZE(batch) && i + j < count; j++)
         {
-        case INPUT_MOUSE:
-            /* we need to update the coordinates to what the server expects */
-            update_mouse_coords( &input );
-            /* fallthrough */
-        case INPUT_KEYBOARD:
-            status = send_hardware_message( 0, &input, &rawinput, SEND_HWMSG_INJECTED );
-            break;
-        case INPUT_HARDWARE:
-            RtlSetLastWin32Error( ERROR_CALL_NOT_IMPLEMENTED );
-            return 0;
+            batch[j] = inputs[i + j];
+            if (batch[j].type == INPUT_MOUSE)
+                /* we need to update the coordinates to what the server expects */
+                update_mouse_coords( &batch[j] );
+            else if (batch[j].type != INPUT_KEYBOARD)
+                break;
         }
 
-        if (status)
+        if (j)
         {
-            RtlSetLastWin32Error( RtlNtStatusToDosError(status) );
-            break;
+            sent = send_hardware_messages( batch, j, SEND_HWMSG_INJECTED | SEND_HWMSG_RAWINPUT, &status );
+            if (status)
+            {
+                RtlSetLastWin32Error( RtlNtStatusToDosError(status) );
+                return i + sent;
+            }
+            continue;
         }
+
+        if (inputs[i].type == INPUT_HARDWARE)
+        {
+            RtlSetLastWin32Error( ERROR_CALL_NOT_IMPLEMENTED );
+            return 0;
+        }
+        j = 1;  /* unknown input types are ignored */
     }
 
     return i;
@@ -841,7 +849,7 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
         ret = MAKELONG( reply->changed_bits & flags, reply->wake_bits & flags );
     }
     SERVER_END_REQ;
-    return ret;
+    return ret | get_post_ring_status( flags );
 }
 
 /***********************************************************************
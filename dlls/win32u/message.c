@@ -25,6 +25,7 @@
 #endif
 
 #include <assert.h>
+#include <pthread.h>
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
 #include "win32u_private.h"
@@ -35,6 +36,7 @@
 #include "dde.h"
 #include "immdev.h"
 #include "wine/server.h"
+#include "wine/rbtree.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msg);
@@ -1883,6 +1885,354 @@ static BOOL process_hardware_message( MSG *msg, UINT hw_id, const struct hardwar
     return ret;
 }
 
+/* Messages posted between threads of the same process bypass the server: they are
+ * appended to a lock-free ring owned by the receiving thread, which drains it before
+ * asking the server for its posted messages. The server is only involved to wake
+ * the receiver up when it is blocked waiting on its queue. */
+
+#define POST_RING_SIZE 256  /* must be a power of two */
+
+struct post_ring_entry
+{
+    LONG  seq;          /* entry sequence, position + 1 once written */
+    MSG   msg;
+};
+
+struct posted_message
+{
+    struct list entry;
+    MSG         msg;
+};
+
+struct post_ring
+{
+    struct wine_rb_entry   entry;      /* entry in the process ring tree */
+    DWORD                  tid;        /* owner thread */
+    volatile struct queue_shared_memory *shared; /* owner queue shared memory */
+    LONG                   enabled;    /* producers may append to the ring */
+    LONG                   dde;        /* a DDE message went through the server, never re-enable */
+    LONG                   waiting;    /* owner is waiting on its server queue */
+    LONG                   tail;       /* next position to be reserved by producers */
+    LONG                   head;       /* next position to be read by the owner */
+    LONG                   seen;       /* tail position when the owner last cleared its changed bits */
+    struct list            pending;    /* messages taken from the ring, in posting order */
+    struct post_ring_entry entries[POST_RING_SIZE];
+};
+
+static int post_ring_compare( const void *key, const struct wine_rb_entry *entry )
+{
+    const struct post_ring *ring = WINE_RB_ENTRY_VALUE( entry, const struct post_ring, entry );
+    DWORD tid = *(const DWORD *)key;
+
+    if (tid < ring->tid) return -1;
+    if (tid > ring->tid) return 1;
+    return 0;
+}
+
+/* producers hold the read lock while looking up a ring and posting, either to the
+ * ring or to the server, so that the owner can enable it while no post is in flight */
+static pthread_rwlock_t post_rings_lock = PTHREAD_RWLOCK_INITIALIZER;
+static struct wine_rb_tree post_rings = { post_ring_compare };
+
+static struct post_ring *find_post_ring( DWORD tid )
+{
+    struct wine_rb_entry *entry;
+
+    if (!(entry = wine_rb_get( &post_rings, &tid ))) return NULL;
+    return WINE_RB_ENTRY_VALUE( entry, struct post_ring, entry );
+}
+
+static void free_post_ring( struct post_ring *ring )
+{
+    struct posted_message *posted, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( posted, next, &ring->pending, struct posted_message, entry )
+        free( posted );
+    free( ring );
+}
+
+/* try to enable the ring of the current thread, called once the server queue exists */
+static void enable_post_ring( volatile struct queue_shared_memory *shared )
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct post_ring *ring = thread_info->post_ring, *stale;
+    UINT wake_bits;
+    int i;
+
+    if (ring && (ring->enabled || ring->dde)) return;
+
+    if (!ring)
+    {
+        if (!(ring = malloc( sizeof(*ring) ))) return;
+        ring->tid = GetCurrentThreadId();
+        ring->shared = shared;
+        ring->enabled = ring->dde = ring->waiting = 0;
+        ring->tail = ring->head = ring->seen = 0;
+        list_init( &ring->pending );
+        for (i = 0; i < POST_RING_SIZE; i++) ring->entries[i].seq = i;
+        thread_info->post_ring = ring;
+
+        pthread_rwlock_wrlock( &post_rings_lock );
+        /* the tid of a thread that didn't detach may have been reused, nobody can post to
+         * its ring anymore since its queue is gone, and nobody will ever read it */
+        if ((stale = find_post_ring( ring->tid )))
+        {
+            wine_rb_remove( &post_rings, &stale->entry );
+            free_post_ring( stale );
+        }
+        wine_rb_put( &post_rings, &ring->tid, &ring->entry );
+        pthread_rwlock_unlock( &post_rings_lock );
+    }
+
+    /* messages are only taken from the ring before the server queue, so it may only be
+     * used once every message posted through the server by this process is retrieved */
+    pthread_rwlock_wrlock( &post_rings_lock );
+    SHARED_READ_BEGIN( &shared->seq )
+    {
+        wake_bits = shared->wake_bits;
+    }
+    SHARED_READ_END( &shared->seq );
+    if (!(wake_bits & (QS_POSTMESSAGE | QS_ALLPOSTMESSAGE))) ring->enabled = 1;
+    pthread_rwlock_unlock( &post_rings_lock );
+
+    TRACE( "thread %04x ring %p enabled %d\n", (int)ring->tid, ring, (int)ring->enabled );
+}
+
+/***********************************************************************
+ *           destroy_post_ring
+ *
+ * Release the posted message ring of an exiting thread.
+ */
+void destroy_post_ring(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct post_ring *ring = thread_info->post_ring;
+
+    if (!ring) return;
+
+    pthread_rwlock_wrlock( &post_rings_lock );
+    if (find_post_ring( ring->tid ) == ring) wine_rb_remove( &post_rings, &ring->entry );
+    pthread_rwlock_unlock( &post_rings_lock );
+
+    free_post_ring( ring );
+    thread_info->post_ring = NULL;
+}
+
+/* append a message to a ring, fails if it is full; called with the read lock held */
+static BOOL push_post_ring( struct post_ring *ring, const MSG *msg )
+{
+    struct post_ring_entry *slot;
+    ULONG pos = ReadAcquire( &ring->tail ), seq, prev;
+
+    for (;;)
+    {
+        slot = &ring->entries[pos % POST_RING_SIZE];
+        seq = ReadAcquire( &slot->seq );
+        if (seq == pos)
+        {
+            if ((prev = InterlockedCompareExchange( &ring->tail, pos + 1, pos )) == pos) break;
+            pos = prev;
+        }
+        else if ((LONG)(seq - pos) < 0) return FALSE;
+        else pos = ReadAcquire( &ring->tail );
+    }
+
+    slot->msg = *msg;
+    WriteRelease( &slot->seq, pos + 1 );
+    return TRUE;
+}
+
+/* move the messages written to the ring of the current thread to its pending list */
+static void drain_post_ring( struct post_ring *ring )
+{
+    struct post_ring_entry *slot;
+    struct posted_message *posted;
+    ULONG pos = ring->head;
+
+    for (;;)
+    {
+        slot = &ring->entries[pos % POST_RING_SIZE];
+        if (ReadAcquire( &slot->seq ) != pos + 1) break;
+        if ((posted = malloc( sizeof(*posted) )))
+        {
+            posted->msg = slot->msg;
+            list_add_tail( &ring->pending, &posted->entry );
+        }
+        WriteRelease( &slot->seq, pos + POST_RING_SIZE );
+        ring->head = ++pos;
+    }
+}
+
+/* post a message to the ring of a thread of the current process; called with the read lock held */
+static BOOL post_message_to_ring( const struct send_message_info *info )
+{
+    volatile struct desktop_shared_memory *desktop;
+    struct post_ring *ring;
+    int created;
+    MSG msg;
+
+    if (info->msg & 0x80000000) return FALSE;  /* internal messages are handled by the server path */
+    if (!(ring = find_post_ring( info->dest_tid )) || !ReadAcquire( &ring->enabled )) return FALSE;
+    if (!(desktop = get_desktop_shared_memory())) return FALSE;
+
+    /* the owner may have been terminated without detaching, its tid may even have been reused */
+    SHARED_READ_BEGIN( &ring->shared->seq )
+    {
+        created = ring->shared->created;
+    }
+    SHARED_READ_END( &ring->shared->seq );
+    if (!created) return FALSE;
+
+    msg.hwnd    = get_full_window_handle( info->hwnd );
+    msg.message = info->msg;
+    msg.wParam  = info->wparam;
+    msg.lParam  = info->lparam;
+    msg.time    = NtGetTickCount();
+    SHARED_READ_BEGIN( &desktop->seq )
+    {
+        msg.pt.x = desktop->cursor.x;
+        msg.pt.y = desktop->cursor.y;
+    }
+    SHARED_READ_END( &desktop->seq );
+
+    if (!push_post_ring( ring, &msg ))
+    {
+        /* keep posting order, everything goes through the server until the owner catches up */
+        TRACE( "ring of thread %04x is full\n", (int)info->dest_tid );
+        WriteRelease( &ring->enabled, 0 );
+        return FALSE;
+    }
+
+    /* pairs with the barrier in begin_post_ring_wait */
+    MemoryBarrier();
+    if (ReadAcquire( &ring->waiting ))
+    {
+        SERVER_START_REQ( wake_posted_queue )
+        {
+            req->id = info->dest_tid;
+            wine_server_call( req );
+        }
+        SERVER_END_REQ;
+    }
+    return TRUE;
+}
+
+/* stop using the ring of a thread for good, once a DDE message is posted to it through the server */
+static void disable_post_ring( DWORD tid )
+{
+    struct post_ring *ring;
+
+    pthread_rwlock_rdlock( &post_rings_lock );
+    if ((ring = find_post_ring( tid )))
+    {
+        WriteRelease( &ring->dde, 1 );
+        WriteRelease( &ring->enabled, 0 );
+    }
+    pthread_rwlock_unlock( &post_rings_lock );
+}
+
+static BOOL match_posted_window( HWND filter, HWND hwnd )
+{
+    if (!filter) return TRUE;
+    if (filter == (HWND)-1 || filter == (HWND)1) return !hwnd;
+    if (hwnd == filter) return TRUE;
+    return hwnd && is_child( filter, hwnd );
+}
+
+/* retrieve a posted message from the ring of the current thread */
+static BOOL get_ring_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags,
+                              volatile struct queue_shared_memory *shared )
+{
+    struct post_ring *ring = get_user_thread_info()->post_ring;
+    struct posted_message *posted, *next;
+    UINT wake_bits;
+
+    if (!ring) return FALSE;
+
+    ring->seen = ReadAcquire( &ring->tail );
+    drain_post_ring( ring );
+    if (list_empty( &ring->pending )) return FALSE;
+
+    /* pending sent messages have to be processed first */
+    SHARED_READ_BEGIN( &shared->seq )
+    {
+        wake_bits = shared->wake_bits;
+    }
+    SHARED_READ_END( &shared->seq );
+    if (wake_bits & QS_SENDMESSAGE) return FALSE;
+
+    if (hwnd && hwnd != (HWND)-1 && hwnd != (HWND)1) hwnd = get_full_window_handle( hwnd );
+
+    LIST_FOR_EACH_ENTRY_SAFE( posted, next, &ring->pending, struct posted_message, entry )
+    {
+        if (posted->msg.hwnd && !is_window( posted->msg.hwnd ))
+        {
+            /* the server drops the posted messages of destroyed windows */
+            list_remove( &posted->entry );
+            free( posted );
+            continue;
+        }
+        if (posted->msg.message < first || posted->msg.message > last) continue;
+        if (!match_posted_window( hwnd, posted->msg.hwnd )) continue;
+
+        *msg = posted->msg;
+        if (flags & PM_REMOVE)
+        {
+            list_remove( &posted->entry );
+            free( posted );
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* check whether the ring satisfies a queue wait, and let producers wake us up otherwise */
+static BOOL begin_post_ring_wait( DWORD wake_mask, DWORD changed_mask )
+{
+    struct post_ring *ring = get_user_thread_info()->post_ring;
+    ULONG tail;
+
+    if (!ring || !((wake_mask | changed_mask) & (QS_POSTMESSAGE | QS_ALLPOSTMESSAGE))) return FALSE;
+
+    InterlockedExchange( &ring->waiting, 1 );
+    tail = ReadAcquire( &ring->tail );
+    if ((changed_mask & (QS_POSTMESSAGE | QS_ALLPOSTMESSAGE)) && tail != ring->seen) goto signaled;
+    if ((wake_mask & (QS_POSTMESSAGE | QS_ALLPOSTMESSAGE)) &&
+        (tail != ring->head || !list_empty( &ring->pending ))) goto signaled;
+    return FALSE;
+
+signaled:
+    WriteRelease( &ring->waiting, 0 );
+    return TRUE;
+}
+
+static void end_post_ring_wait(void)
+{
+    struct post_ring *ring = get_user_thread_info()->post_ring;
+    if (ring) WriteRelease( &ring->waiting, 0 );
+}
+
+/***********************************************************************
+ *           get_post_ring_status
+ *
+ * Queue status bits of the posted message ring of the current thread.
+ */
+DWORD get_post_ring_status( UINT flags )
+{
+    struct post_ring *ring = get_user_thread_info()->post_ring;
+    UINT bits = QS_POSTMESSAGE | QS_ALLPOSTMESSAGE;
+    ULONG tail;
+    DWORD ret = 0;
+
+    if (!ring || !(flags & bits)) return 0;
+
+    tail = ReadAcquire( &ring->tail );
+    if (tail != ring->seen) ret |= bits;
+    if (tail != ring->head || !list_empty( &ring->pending )) ret |= bits << 16;
+    ring->seen = tail;
+    return ret & MAKELONG( flags, flags );
+}
+
 /***********************************************************************
  *           peek_message
  *
@@ -1911,7 +2261,7 @@ static int peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags,
         NTSTATUS res;
         size_t size = 0;
         const message_data_t *msg_data = buffer;
-        BOOL needs_unpack = FALSE;
+        BOOL needs_unpack = FALSE, from_ring = FALSE, use_ring;
         UINT wake_mask = changed_mask & (QS_SENDMESSAGE | QS_SMRESULT);
         DWORD clear_bits = 0, filter = flags >> 16 ? flags >> 16 : QS_ALLINPUT;
         if (filter & QS_POSTMESSAGE)
@@ -1943,10 +2293,15 @@ static int peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags,
         }
         SHARED_READ_END( &shared->seq );
 
+        /* the ring comes before the server posted messages, but the server still has to be
+         * asked for sent messages, and regularly enough for the queue not to look hung */
+        use_ring = (filter & QS_POSTMESSAGE) && shared &&
+                   get_ring_message( &info.msg, hwnd, first, last, flags & ~PM_REMOVE, shared );
+
         if (skip) res = STATUS_PENDING;
         else SERVER_START_REQ( get_message )
         {
-            req->flags     = flags;
+            req->flags     = use_ring ? LOWORD(flags) | (QS_SENDMESSAGE << 16) : flags;
             req->get_win   = wine_server_user_handle( hwnd );
             req->get_first = first;
             req->get_last  = last;
@@ -1972,13 +2327,23 @@ static int peek_message( MSG *msg, HWND hwnd, UINT first, UINT last, UINT flags,
         }
         SERVER_END_REQ;
 
+        if (res == STATUS_PENDING && use_ring)
+        {
+            /* the window of the message may have been destroyed meanwhile, start over */
+            if (!get_ring_message( &info.msg, hwnd, first, last, flags, shared )) continue;
+            info.type = MSG_POSTED;
+            from_ring = TRUE;
+            res = 0;
+        }
+
         /* force refreshing hooks */
-        thread_info->active_hooks = 0;
+        if (!from_ring) thread_info->active_hooks = 0;
 
         if (res)
         {
             if (res == STATUS_PENDING)
             {
+                if ((filter & QS_POSTMESSAGE) && shared && shared->created) enable_post_ring( shared );
                 thread_info->wake_mask = changed_mask & (QS_SENDMESSAGE | QS_SMRESULT);
                 thread_info->changed_mask = changed_mask;
                 if (buffer != buffer_init) free( buffer );
@@ -2332,7 +2697,24 @@ static DWORD wait_objects( DWORD count, const HANDLE *handles, DWORD timeout,
         thread_info->changed_mask = changed_mask;
     }
 
-    ret = wait_message( count, handles, timeout, changed_mask, flags );
+    /* messages posted to the ring only wake the server queue while we are waiting on it */
+    if (!begin_post_ring_wait( wake_mask, changed_mask ))
+    {
+        ret = wait_message( count, handles, timeout, changed_mask, flags );
+        end_post_ring_wait();
+    }
+    else if (!(flags & MWMO_WAITALL)) ret = count - 1;
+    else
+    {
+        /* the other handles have to be signaled too, let the server queue reflect the ring */
+        SERVER_START_REQ( wake_posted_queue )
+        {
+            req->id = GetCurrentThreadId();
+            wine_server_call( req );
+        }
+        SERVER_END_REQ;
+        ret = wait_message( count, handles, timeout, changed_mask, flags );
+    }
 
     if (ret != WAIT_TIMEOUT) thread_info->wake_mask = thread_info->changed_mask = 0;
     return ret;
@@ -2561,6 +2943,8 @@ static BOOL put_message_in_queue( const struct send_message_info *info, size_t *
         void *ret_ptr;
         ULONG ret_len;
 
+        disable_post_ring( info->dest_tid );
+
         params.hwnd     = info->hwnd;
         params.msg      = info->msg;
         params.wparam   = info->wparam;
@@ -2570,6 +2954,16 @@ static BOOL put_message_in_queue( const struct send_message_info *info, size_t *
         return KeUserModeCallback( NtUserPostDDEMessage, &params, sizeof(params), &ret_ptr, &ret_len );
     }
 
+    if (info->type == MSG_POSTED)
+    {
+        pthread_rwlock_rdlock( &post_rings_lock );
+        if (post_message_to_ring( info ))
+        {
+            pthread_rwlock_unlock( &post_rings_lock );
+            return TRUE;
+        }
+    }
+
     SERVER_START_REQ( send_message )
     {
         req->id      = info->dest_tid;
@@ -2593,6 +2987,7 @@ static BOOL put_message_in_queue( const struct send_message_info *info, size_t *
         }
     }
     SERVER_END_REQ;
+    if (info->type == MSG_POSTED) pthread_rwlock_unlock( &post_rings_lock );
     return !res;
 }
 
@@ -2866,6 +3261,94 @@ NTSTATUS send_hardware_message( HWND hwnd, const INPUT *input, const RAWINPUT *r
     return ret;
 }
 
+/***********************************************************************
+ *           send_hardware_messages
+ *
+ * Send a batch of mouse and keyboard inputs to the server in as few requests as possible.
+ * Return the number of inputs that were processed.
+ */
+UINT send_hardware_messages( const INPUT *inputs, UINT count, UINT flags, NTSTATUS *status )
+{
+    struct send_message_info info;
+    hw_input_t batch[64];
+    int prev_x, prev_y, new_x, new_y;
+    UINT i, done = 0, batch_count;
+    BOOL wait;
+
+    info.type     = MSG_HARDWARE;
+    info.dest_tid = 0;
+    info.hwnd     = 0;
+    info.flags    = 0;
+    info.timeout  = 0;
+    info.params   = NULL;
+
+    *status = STATUS_SUCCESS;
+    while (done < count)
+    {
+        for (i = 0; i < ARRAY_SIZE(batch) && done + i < count; i++)
+        {
+            const INPUT *input = &inputs[done + i];
+
+            if (input->type == INPUT_MOUSE && (input->mi.dwFlags & (MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_RIGHTDOWN)))
+            {
+                /* the clipping has to be updated before sending the button press */
+                if (i) break;
+                clip_fullscreen_window( 0, FALSE );
+            }
+
+            memset( &batch[i], 0, sizeof(batch[i]) );
+            batch[i].type = input->type;
+            switch (input->type)
+            {
+            case INPUT_MOUSE:
+                batch[i].mouse.x     = input->mi.dx;
+                batch[i].mouse.y     = input->mi.dy;
+                batch[i].mouse.data  = input->mi.mouseData;
+                batch[i].mouse.flags = input->mi.dwFlags;
+                batch[i].mouse.time  = input->mi.time;
+                batch[i].mouse.info  = input->mi.dwExtraInfo;
+                break;
+            case INPUT_KEYBOARD:
+                batch[i].kbd.vkey  = input->ki.wVk;
+                batch[i].kbd.scan  = input->ki.wScan;
+                batch[i].kbd.flags = input->ki.dwFlags;
+                batch[i].kbd.time  = input->ki.time;
+                batch[i].kbd.info  = input->ki.dwExtraInfo;
+                break;
+            }
+        }
+        batch_count = i;
+
+        SERVER_START_REQ( send_hardware_messages )
+        {
+            req->flags = flags;
+            wine_server_add_data( req, batch, batch_count * sizeof(batch[0]) );
+            if (!(*status = wine_server_call( req ))) batch_count = reply->count;
+            wait   = reply->wait;
+            prev_x = reply->prev_x;
+            prev_y = reply->prev_y;
+            new_x  = reply->new_x;
+            new_y  = reply->new_y;
+        }
+        SERVER_END_REQ;
+
+        if (*status) break;
+        done += batch_count;
+
+        if ((flags & SEND_HWMSG_INJECTED) && (prev_x != new_x || prev_y != new_y))
+            user_driver->pSetCursorPos( new_x, new_y );
+
+        /* the server stops after a message sent to a low-level hook, wait for it before going on */
+        if (wait)
+        {
+            LRESULT ignored;
+            wait_message_reply( 0 );
+            retrieve_reply( &info, 0, &ignored );
+        }
+    }
+    return done;
+}
+
 /**********************************************************************
  *           NtUserDispatchMessage  (win32u.@)
  */
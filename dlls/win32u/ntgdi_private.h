@@ -190,13 +190,14 @@ extern BOOL fill_color_table_from_pal_colors( BITMAPINFO *info, HDC hdc ) DECLSP
 extern const RGBQUAD *get_default_color_table( int bpp ) DECLSPEC_HIDDEN;
 extern void fill_default_color_table( BITMAPINFO *info ) DECLSPEC_HIDDEN;
 extern void get_ddb_bitmapinfo( BITMAPOBJ *bmp, BITMAPINFO *info ) DECLSPEC_HIDDEN;
+extern BOOL bitmapobj_has_private_bits( const BITMAPOBJ *bmp ) DECLSPEC_HIDDEN;
 extern BITMAPINFO *copy_packed_dib( const BITMAPINFO *src_info, UINT usage ) DECLSPEC_HIDDEN;
 extern DWORD convert_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                                  const BITMAPINFO *dst_info, void *dst_bits ) DECLSPEC_HIDDEN;
 
 extern DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                                  const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
-                                 INT mode ) DECLSPEC_HIDDEN;
+                                 INT mode, BOOL private_bits ) DECLSPEC_HIDDEN;
 extern DWORD blend_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                                const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                                BLENDFUNCTION blend ) DECLSPEC_HIDDEN;
@@ -217,6 +218,7 @@ extern UINT set_dib_dc_color_table( HDC hdc, UINT startpos, UINT entries,
                                     const RGBQUAD *colors ) DECLSPEC_HIDDEN;
 extern void dibdrv_set_window_surface( DC *dc, struct window_surface *surface ) DECLSPEC_HIDDEN;
 extern struct opengl_funcs *dibdrv_get_wgl_driver(void) DECLSPEC_HIDDEN;
+extern void init_dib_simd(void) DECLSPEC_HIDDEN;
 
 /* driver.c */
 extern const struct gdi_dc_funcs null_driver DECLSPEC_HIDDEN;
@@ -288,6 +290,7 @@ struct gdi_font
     void                  *data_ptr;
     SIZE_T                 data_size;
     FILETIME               writetime;
+    UINT64                 shared_key[2];      /* key in the shared glyph cache, 0 until computed */
     WCHAR                  file[1];
 };
 
@@ -341,6 +344,13 @@ extern int add_gdi_face( const WCHAR *family_name, const WCHAR *second_name,
 extern UINT font_init(void) DECLSPEC_HIDDEN;
 extern const struct font_backend_funcs *init_freetype_lib(void) DECLSPEC_HIDDEN;
 
+/* glyphcache.c */
+extern BOOL get_shared_glyph( struct gdi_font *font, UINT index, UINT format, BOOL tategaki,
+                              GLYPHMETRICS *gm, ABC *abc, DWORD buflen, void *buf, DWORD *ret ) DECLSPEC_HIDDEN;
+extern void put_shared_glyph( struct gdi_font *font, UINT index, UINT format, BOOL tategaki,
+                              const GLYPHMETRICS *gm, const ABC *abc, DWORD size, const void *bits ) DECLSPEC_HIDDEN;
+extern void init_shared_glyph_cache(void) DECLSPEC_HIDDEN;
+
 /* opentype.c */
 
 struct ttc_sfnt_v1;
@@ -5716,6 +5716,7 @@ static void thread_detach(void)
 
     destroy_thread_windows();
     cleanup_imm_thread();
+    destroy_post_ring();
     NtClose( thread_info->server_queue );
 
     if (thread_info->desktop_shared_memory)
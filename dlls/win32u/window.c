@@ -175,6 +175,30 @@ HWND get_hwnd_message_parent(void)
     return UlongToHandle( thread_info->msg_window );
 }
 
+/***********************************************************************
+ *           get_shared_window_info
+ *
+ * Read the state of a window from the window shared memory. Return FALSE if
+ * the shared memory is unavailable, info->handle is 0 if the window is invalid.
+ */
+static BOOL get_shared_window_info( HWND hwnd, struct window_shared_memory *info )
+{
+    volatile struct window_shared_memory *shared;
+    UINT handle = HandleToUlong( hwnd );
+
+    if (!(shared = get_window_shared_memory( hwnd ))) return FALSE;
+
+    SHARED_READ_BEGIN( &shared->seq )
+    {
+        *info = *shared;
+    }
+    SHARED_READ_END( &shared->seq );
+
+    if (LOWORD(info->handle) != LOWORD(handle)) info->handle = 0;
+    else if (HIWORD(handle) && HIWORD(handle) != 0xffff && info->handle != handle) info->handle = 0;
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_full_window_handle
  *
@@ -182,6 +206,7 @@ HWND get_hwnd_message_parent(void)
  */
 HWND get_full_window_handle( HWND hwnd )
 {
+    struct window_shared_memory info;
     WND *win;
 
     if (!hwnd || (ULONG_PTR)hwnd >> 16) return hwnd;
@@ -202,7 +227,12 @@ HWND get_full_window_handle( HWND hwnd )
         hwnd = win->obj.handle;
         release_win_ptr( win );
     }
-    else  /* may belong to another process */
+    else if (get_shared_window_info( hwnd, &info ))  /* may belong to another process */
+    {
+        if (info.handle) hwnd = UlongToHandle( info.handle );
+        else RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+    }
+    else
     {
         SERVER_START_REQ( get_window_info )
         {
@@ -289,6 +319,7 @@ HWND is_current_process_window( HWND hwnd )
 /* see IsWindow */
 BOOL is_window( HWND hwnd )
 {
+    struct window_shared_memory info;
     WND *win;
     BOOL ret;
 
@@ -302,6 +333,12 @@ BOOL is_window( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_shared_window_info( hwnd, &info ))
+    {
+        if (!info.handle) RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+        return !!info.handle;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -314,6 +351,7 @@ BOOL is_window( HWND hwnd )
 /* see GetWindowThreadProcessId */
 DWORD get_window_thread( HWND hwnd, DWORD *process )
 {
+    struct window_shared_memory info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -333,6 +371,17 @@ DWORD get_window_thread( HWND hwnd, DWORD *process )
     }
 
     /* check other processes */
+    if (ptr == WND_OTHER_PROCESS && get_shared_window_info( hwnd, &info ))
+    {
+        if (!info.handle)
+        {
+            RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+            return 0;
+        }
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -349,6 +398,7 @@ DWORD get_window_thread( HWND hwnd, DWORD *process )
 /* see GetParent */
 HWND get_parent( HWND hwnd )
 {
+    struct window_shared_memory info;
     HWND retval = 0;
     WND *win;
 
@@ -358,7 +408,13 @@ HWND get_parent( HWND hwnd )
         return 0;
     }
     if (win == WND_DESKTOP) return 0;
-    if (win == WND_OTHER_PROCESS)
+    if (win == WND_OTHER_PROCESS && get_shared_window_info( hwnd, &info ))
+    {
+        if (!info.handle) RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+        else if (info.style & WS_POPUP) retval = UlongToHandle( info.owner );
+        else if (info.style & WS_CHILD) retval = UlongToHandle( info.parent );
+    }
+    else if (win == WND_OTHER_PROCESS)
     {
         LONG style = get_window_long( hwnd, GWL_STYLE );
         if (style & (WS_POPUP | WS_CHILD))
@@ -1003,6 +1059,7 @@ BOOL is_zoomed( HWND hwnd )
 
 static LONG_PTR get_window_long_size( HWND hwnd, INT offset, UINT size, BOOL ansi )
 {
+    struct window_shared_memory info;
     LONG_PTR retval = 0;
     WND *win;
 
@@ -1049,6 +1106,25 @@ static LONG_PTR get_window_long_size( HWND hwnd, INT offset, UINT size, BOOL ans
             RtlSetLastWin32Error( ERROR_ACCESS_DENIED );
             return 0;
         }
+        switch (offset)
+        {
+        case GWL_STYLE:
+        case GWL_EXSTYLE:
+        case GWLP_ID:
+        case GWLP_HINSTANCE:
+        case GWLP_USERDATA:
+            if (!get_shared_window_info( hwnd, &info )) break;
+            if (!info.handle)
+            {
+                RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+                return 0;
+            }
+            if (offset == GWL_STYLE) return info.style;
+            if (offset == GWL_EXSTYLE) return info.ex_style;
+            if (offset == GWLP_ID) return info.id;
+            if (offset == GWLP_HINSTANCE) return (ULONG_PTR)wine_server_get_ptr( info.instance );
+            return info.user_data;
+        }
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -1567,6 +1643,82 @@ static void mirror_rect( const RECT *window_rect, RECT *rect )
     rect->right = width - tmp;
 }
 
+static RECT shared_rect_to_rect( rectangle_t rect )
+{
+    RECT ret = { rect.left, rect.top, rect.right, rect.bottom };
+    return ret;
+}
+
+/***********************************************************************
+ *           get_shared_window_rects
+ *
+ * Compute the rectangles of a window of another process from the window shared
+ * memory, the same way the server does. Return FALSE to fall back to the server.
+ */
+static BOOL get_shared_window_rects( HWND hwnd, enum coords_relative relative, RECT *window_rect,
+                                     RECT *client_rect, UINT dpi, BOOL *ret )
+{
+    struct window_shared_memory info, parent;
+    RECT window, client, orig_window, orig_client;
+    UINT from, to;
+
+    if (!get_shared_window_info( hwnd, &info )) return FALSE;
+    if (!info.handle)
+    {
+        RtlSetLastWin32Error( ERROR_INVALID_WINDOW_HANDLE );
+        *ret = FALSE;
+        return TRUE;
+    }
+
+    window = orig_window = shared_rect_to_rect( info.window_rect );
+    client = orig_client = shared_rect_to_rect( info.client_rect );
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        OffsetRect( &window, -orig_client.left, -orig_client.top );
+        OffsetRect( &client, -orig_client.left, -orig_client.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &orig_client, &window );
+        break;
+    case COORDS_WINDOW:
+        OffsetRect( &window, -orig_window.left, -orig_window.top );
+        OffsetRect( &client, -orig_window.left, -orig_window.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &orig_window, &client );
+        break;
+    case COORDS_PARENT:
+        if (!info.parent) break;
+        if (!get_shared_window_info( UlongToHandle( info.parent ), &parent ) || !parent.handle) return FALSE;
+        if (parent.ex_style & WS_EX_LAYOUTRTL)
+        {
+            RECT parent_client = shared_rect_to_rect( parent.client_rect );
+            mirror_rect( &parent_client, &window );
+            mirror_rect( &parent_client, &client );
+        }
+        break;
+    case COORDS_SCREEN:
+        for (parent.parent = info.parent; parent.parent; )
+        {
+            if (!get_shared_window_info( UlongToHandle( parent.parent ), &parent ) || !parent.handle)
+                return FALSE;
+            if (!parent.parent) break;  /* desktop window */
+            OffsetRect( &window, parent.client_rect.left, parent.client_rect.top );
+            OffsetRect( &client, parent.client_rect.left, parent.client_rect.top );
+        }
+        break;
+    default:
+        RtlSetLastWin32Error( ERROR_INVALID_PARAMETER );
+        *ret = FALSE;
+        return TRUE;
+    }
+
+    from = info.dpi ? info.dpi : info.monitor_dpi;
+    to = dpi ? dpi : info.monitor_dpi;
+    if (window_rect) *window_rect = map_dpi_rect( window, from, to );
+    if (client_rect) *client_rect = map_dpi_rect( client, from, to );
+    *ret = TRUE;
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_window_rects
  *
@@ -1677,6 +1829,8 @@ BOOL get_window_rects( HWND hwnd, enum coords_relative relative, RECT *window_re
     }
 
 other_process:
+    if (get_shared_window_rects( hwnd, relative, window_rect, client_rect, dpi, &ret )) return ret;
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -783,6 +783,38 @@ volatile struct input_shared_memory *get_foreground_shared_memory( void )
     return get_thread_input_shared_memory( tid, &thread_info->foreground_shared_memory );
 }
 
+volatile struct window_shared_memory *get_window_shared_memory( HWND hwnd )
+{
+    static struct window_shared_memory *window_shared;
+    static LONG window_shared_failed;
+    UINT index = WINDOW_SHARED_MEMORY_INDEX( HandleToUlong( hwnd ) );
+    struct window_shared_memory *ret;
+    WCHAR bufferW[MAX_PATH];
+
+    if (index >= WINDOW_SHARED_MEMORY_COUNT) return NULL;
+
+    __WINE_ATOMIC_LOAD_RELAXED( &window_shared, &ret );
+    if (!ret)
+    {
+        /* the section is created once by the server, don't retry opening it on every query */
+        if (ReadNoFence( &window_shared_failed )) return NULL;
+        asciiz_to_unicode( bufferW, "\\KernelObjects\\__wine_thread_mappings\\windows" );
+        map_shared_memory_section( bufferW, WINDOW_SHARED_MEMORY_COUNT * sizeof(*ret), NULL, (void **)&ret );
+        if (!ret)
+        {
+            WriteNoFence( &window_shared_failed, TRUE );
+            return NULL;
+        }
+        if (InterlockedCompareExchangePointer( (void **)&window_shared, ret, NULL ))
+        {
+            NtUnmapViewOfSection( GetCurrentProcess(), ret );
+            ret = window_shared;
+        }
+    }
+
+    return ret + index;
+}
+
 /***********************************************************************
  *           winstation_init
  *
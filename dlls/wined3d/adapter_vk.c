@@ -405,6 +405,169 @@ static void get_physical_device_info(const struct wined3d_adapter_vk *adapter_vk
         VK_CALL(vkGetPhysicalDeviceFeatures(physical_device, &features2->features));
 }
 
+static BOOL wined3d_adapter_vk_get_pipeline_cache_name(const struct wined3d_adapter_vk *adapter_vk,
+        char *name, size_t size)
+{
+    const struct wined3d_vk_info *vk_info = &adapter_vk->vk_info;
+    char dir[MAX_PATH], uuid[VK_UUID_SIZE * 2 + 1];
+    VkPhysicalDeviceProperties properties;
+    unsigned int i;
+    int len;
+
+    if (!wined3d_get_shader_cache_directory("vulkan", dir, sizeof(dir)))
+        return FALSE;
+
+    VK_CALL(vkGetPhysicalDeviceProperties(adapter_vk->physical_device, &properties));
+    for (i = 0; i < VK_UUID_SIZE; ++i)
+        sprintf(&uuid[i * 2], "%02x", properties.pipelineCacheUUID[i]);
+
+    len = snprintf(name, size, "%s\\%04x-%04x-%08x-%s.bin", dir, properties.vendorID,
+            properties.deviceID, properties.driverVersion, uuid);
+    return len >= 0 && (size_t)len < size;
+}
+
+static void *wined3d_read_pipeline_cache_file(const char *name, size_t *size)
+{
+    LARGE_INTEGER file_size;
+    void *data = NULL;
+    HANDLE file;
+    DWORD read;
+
+    if ((file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart
+            && file_size.QuadPart <= (LONGLONG)wined3d_settings.shader_cache_size * 1024 * 1024
+            && (data = heap_alloc(file_size.QuadPart)))
+    {
+        if (ReadFile(file, data, file_size.QuadPart, &read, NULL) && read == file_size.QuadPart)
+        {
+            *size = read;
+        }
+        else
+        {
+            heap_free(data);
+            data = NULL;
+        }
+    }
+    CloseHandle(file);
+
+    return data;
+}
+
+/* The pipeline cache is shared by all pipelines created on the device, and
+ * serialised to disk when the device is destroyed, so that pipelines compiled
+ * in earlier runs don't need to be compiled again. */
+static void wined3d_device_vk_create_pipeline_cache(struct wined3d_device_vk *device_vk,
+        const struct wined3d_adapter_vk *adapter_vk)
+{
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
+    VkPipelineCacheCreateInfo cache_info;
+    char name[MAX_PATH];
+    void *data = NULL;
+    size_t size;
+    VkResult vr;
+
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.pNext = NULL;
+    cache_info.flags = 0;
+    cache_info.initialDataSize = 0;
+    cache_info.pInitialData = NULL;
+
+    if (wined3d_adapter_vk_get_pipeline_cache_name(adapter_vk, name, sizeof(name))
+            && (data = wined3d_read_pipeline_cache_file(name, &size)))
+    {
+        TRACE("Loading pipeline cache %s, size %Iu.\n", debugstr_a(name), size);
+        cache_info.initialDataSize = size;
+        cache_info.pInitialData = data;
+    }
+
+    if ((vr = VK_CALL(vkCreatePipelineCache(device_vk->vk_device,
+            &cache_info, NULL, &device_vk->vk_pipeline_cache))) < 0 && cache_info.initialDataSize)
+    {
+        WARN("Failed to create pipeline cache from %s, vr %s.\n", debugstr_a(name), wined3d_debug_vkresult(vr));
+        cache_info.initialDataSize = 0;
+        cache_info.pInitialData = NULL;
+        vr = VK_CALL(vkCreatePipelineCache(device_vk->vk_device, &cache_info, NULL, &device_vk->vk_pipeline_cache));
+    }
+    if (vr < 0)
+    {
+        WARN("Failed to create pipeline cache, vr %s.\n", wined3d_debug_vkresult(vr));
+        device_vk->vk_pipeline_cache = VK_NULL_HANDLE;
+    }
+    device_vk->vk_pipeline_cache_size = cache_info.initialDataSize;
+
+    heap_free(data);
+}
+
+/* Other processes may have written the cache file since it was loaded. Merge
+ * its current contents, so that their pipelines are kept when it is replaced. */
+static void wined3d_device_vk_merge_pipeline_cache_file(struct wined3d_device_vk *device_vk, const char *name)
+{
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
+    VkPipelineCacheCreateInfo cache_info;
+    VkPipelineCache vk_pipeline_cache;
+    size_t size;
+    void *data;
+    VkResult vr;
+
+    if (!(data = wined3d_read_pipeline_cache_file(name, &size)))
+        return;
+
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.pNext = NULL;
+    cache_info.flags = 0;
+    cache_info.initialDataSize = size;
+    cache_info.pInitialData = data;
+
+    if ((vr = VK_CALL(vkCreatePipelineCache(device_vk->vk_device, &cache_info, NULL, &vk_pipeline_cache))) >= 0)
+    {
+        if ((vr = VK_CALL(vkMergePipelineCaches(device_vk->vk_device,
+                device_vk->vk_pipeline_cache, 1, &vk_pipeline_cache))) < 0)
+            WARN("Failed to merge pipeline cache %s, vr %s.\n", debugstr_a(name), wined3d_debug_vkresult(vr));
+        VK_CALL(vkDestroyPipelineCache(device_vk->vk_device, vk_pipeline_cache, NULL));
+    }
+    heap_free(data);
+}
+
+static void wined3d_device_vk_destroy_pipeline_cache(struct wined3d_device_vk *device_vk)
+{
+    const struct wined3d_adapter_vk *adapter_vk = wined3d_adapter_vk_const(device_vk->d.adapter);
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
+    char name[MAX_PATH];
+    void *data;
+    size_t size;
+    VkResult vr;
+
+    if (!device_vk->vk_pipeline_cache)
+        return;
+
+    /* Only write the cache back if new pipelines were added to it. */
+    if ((vr = VK_CALL(vkGetPipelineCacheData(device_vk->vk_device, device_vk->vk_pipeline_cache, &size, NULL))) >= 0
+            && size != device_vk->vk_pipeline_cache_size
+            && wined3d_adapter_vk_get_pipeline_cache_name(adapter_vk, name, sizeof(name)))
+    {
+        wined3d_device_vk_merge_pipeline_cache_file(device_vk, name);
+
+        if ((vr = VK_CALL(vkGetPipelineCacheData(device_vk->vk_device,
+                device_vk->vk_pipeline_cache, &size, NULL))) >= 0
+                && size <= (size_t)wined3d_settings.shader_cache_size * 1024 * 1024
+                && (data = heap_alloc(size)))
+        {
+            if ((vr = VK_CALL(vkGetPipelineCacheData(device_vk->vk_device,
+                    device_vk->vk_pipeline_cache, &size, data))) == VK_SUCCESS)
+            {
+                TRACE("Writing pipeline cache %s, size %Iu.\n", debugstr_a(name), size);
+                wined3d_write_shader_cache_file(name, data, size);
+            }
+            heap_free(data);
+        }
+    }
+
+    VK_CALL(vkDestroyPipelineCache(device_vk->vk_device, device_vk->vk_pipeline_cache, NULL));
+}
+
 static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wined3d_adapter *adapter,
         enum wined3d_device_type device_type, HWND focus_window, unsigned int flags, BYTE surface_alignment,
         const enum wined3d_feature_level *levels, unsigned int level_count,
@@ -497,6 +660,7 @@ static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wi
     }
 
     wined3d_lock_init(&device_vk->allocator_cs, "wined3d_device_vk.allocator_cs");
+    wined3d_device_vk_create_pipeline_cache(device_vk, adapter_vk);
 
     *device = &device_vk->d;
 
@@ -518,6 +682,7 @@ static void adapter_vk_destroy_device(struct wined3d_device *device)
 
     wined3d_lock_cleanup(&device_vk->allocator_cs);
 
+    wined3d_device_vk_destroy_pipeline_cache(device_vk);
     VK_CALL(vkDestroyDevice(device_vk->vk_device, NULL));
     heap_free(device_vk);
 }
@@ -2670,6 +2670,8 @@ static void wined3d_context_gl_cleanup_resources(struct wined3d_context_gl *cont
             *r = blocks[count];
     }
     device_gl->retired_block_count = count;
+
+    wined3d_device_gl_reclaim_streaming_ring(device_gl);
 }
 
 void wined3d_context_gl_wait_command_fence(struct wined3d_context_gl *context_gl, uint64_t id)
@@ -3155,15 +3157,25 @@ void wined3d_context_gl_destroy_bo(struct wined3d_context_gl *context_gl, struct
 
     if (bo->memory)
     {
-        unsigned int order = bo->memory->order;
+        size_t size;
 
         if (bo->b.map_ptr)
             wined3d_allocator_chunk_gl_unmap(wined3d_allocator_chunk_gl(bo->memory->chunk), context_gl);
-        wined3d_context_gl_destroy_allocator_block(context_gl, bo->memory, bo->command_fence_id);
+
+        if (bo->streaming_entry)
+        {
+            size = bo->size;
+            wined3d_device_gl_retire_streaming_bo(device_gl, bo);
+        }
+        else
+        {
+            size = WINED3D_ALLOCATOR_CHUNK_SIZE >> bo->memory->order;
+            wined3d_context_gl_destroy_allocator_block(context_gl, bo->memory, bo->command_fence_id);
+        }
 
         if (bo->command_fence_id == device_gl->current_fence_id)
         {
-            device_gl->retired_bo_size += WINED3D_ALLOCATOR_CHUNK_SIZE >> order;
+            device_gl->retired_bo_size += size;
             if (device_gl->retired_bo_size > WINED3D_RETIRED_BO_SIZE_THRESHOLD)
                 wined3d_context_gl_submit_command_fence(context_gl);
         }
@@ -20,6 +20,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_stats);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_sync);
 WINE_DECLARE_DEBUG_CHANNEL(fps);
 
@@ -633,6 +634,79 @@ static struct wined3d_cs_packet *wined3d_next_cs_packet(const uint8_t *data, SIZ
     return packet;
 }
 
+static void wined3d_cs_count_op(struct wined3d_cs *cs, enum wined3d_cs_op opcode)
+{
+    if (!cs->collect_stats)
+        return;
+
+    if (opcode == WINED3D_CS_OP_DRAW)
+        ++cs->stats.draws;
+    else if (opcode == WINED3D_CS_OP_DISPATCH)
+        ++cs->stats.dispatches;
+    else if (opcode >= WINED3D_CS_OP_SET_PREDICATION && opcode <= WINED3D_CS_OP_PUSH_CONSTANTS)
+        ++cs->stats.state_changes;
+}
+
+static void wined3d_cs_count_upload(struct wined3d_cs *cs,
+        const struct wined3d_resource *resource, const struct wined3d_box *box)
+{
+    unsigned int row_pitch, slice_pitch;
+    LONG64 size;
+
+    if (resource->type == WINED3D_RTYPE_BUFFER)
+    {
+        size = box->right - box->left;
+    }
+    else
+    {
+        wined3d_format_calculate_pitch(resource->format, 1, box->right - box->left,
+                box->bottom - box->top, &row_pitch, &slice_pitch);
+        size = (LONG64)slice_pitch * (box->back - box->front);
+    }
+    InterlockedExchangeAdd64(&cs->stats.upload_bytes, size);
+}
+
+static void wined3d_cs_report_stats(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_stats *stats = &cs->stats;
+    LARGE_INTEGER frequency, now;
+    double elapsed, frames;
+    LONG64 upload_bytes;
+
+    ++stats->frames;
+
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    elapsed = (double)(now.QuadPart - stats->start_time) / frequency.QuadPart;
+    if (elapsed < 1.0)
+        return;
+    frames = stats->frames;
+    upload_bytes = InterlockedExchangeAdd64(&stats->upload_bytes, 0);
+    InterlockedExchangeAdd64(&stats->upload_bytes, -upload_bytes);
+
+    TRACE_(d3d_stats)("%u frames in %.2fs; per frame: %.1f draws, %.1f dispatches, %.1f state changes, "
+            "%.1f pipelines, %.1f KiB uploaded.\n", stats->frames, elapsed, stats->draws / frames,
+            stats->dispatches / frames, stats->state_changes / frames, stats->pipelines / frames,
+            upload_bytes / (1024.0 * frames));
+    TRACE_(d3d_stats)("Per frame: %.1f packets, %.1f maps (%.1f stalled), %.1f queue stalls, %.1f finishes; "
+            "max queue depth %ld bytes, CS idle %.1f%%.\n",
+            InterlockedExchange(&stats->packets, 0) / frames,
+            InterlockedExchange(&stats->maps, 0) / frames,
+            InterlockedExchange(&stats->map_stalls, 0) / frames,
+            InterlockedExchange(&stats->queue_stalls, 0) / frames,
+            InterlockedExchange(&stats->finish_stalls, 0) / frames,
+            InterlockedExchange(&stats->max_queue_depth, 0),
+            100.0 * stats->idle_time / (now.QuadPart - stats->start_time));
+
+    stats->frames = 0;
+    stats->draws = 0;
+    stats->dispatches = 0;
+    stats->state_changes = 0;
+    stats->pipelines = 0;
+    stats->idle_time = 0;
+    stats->start_time = now.QuadPart;
+}
+
 static void wined3d_cs_exec_nop(struct wined3d_cs *cs, const void *data)
 {
 }
@@ -714,7 +788,11 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
         }
     }
 
+    if (cs->collect_stats)
+        wined3d_cs_report_stats(cs);
+
     InterlockedDecrement(&cs->pending_presents);
+    RtlWakeAddressAll(&cs->pending_presents);
 }
 
 void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *swapchain,
@@ -748,7 +826,7 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
      * ahead of the worker thread. */
     while (pending >= swapchain->max_frame_latency)
     {
-        YieldProcessor();
+        RtlWaitOnAddress(&cs->pending_presents, &pending, sizeof(pending), NULL);
         pending = InterlockedCompareExchange(&cs->pending_presents, 0, 0);
     }
 }
@@ -2381,6 +2459,12 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
      * increasing the map count would be visible to applications. */
     wined3d_not_from_cs(context->device->cs);
 
+    if (context->device->cs->collect_stats)
+    {
+        InterlockedIncrement(&context->device->cs->stats.maps);
+        InterlockedIncrement(&resource->stats_maps);
+    }
+
     if ((flags & (WINED3D_MAP_DISCARD | WINED3D_MAP_NOOVERWRITE))
             && context->ops->map_upload_bo(context, resource, sub_resource_idx, map_desc, box, flags))
     {
@@ -2389,6 +2473,12 @@ HRESULT wined3d_device_context_emit_map(struct wined3d_device_context *context,
         return WINED3D_OK;
     }
 
+    if (context->device->cs->collect_stats)
+    {
+        InterlockedIncrement(&context->device->cs->stats.map_stalls);
+        InterlockedIncrement(&resource->stats_map_stalls);
+    }
+
     wined3d_resource_wait_idle(resource);
 
     /* We might end up invalidating the resource on the CS thread. */
@@ -2436,6 +2526,10 @@ HRESULT wined3d_device_context_emit_unmap(struct wined3d_device_context *context
         wined3d_resource_get_sub_resource_map_pitch(resource, sub_resource_idx, &row_pitch, &slice_pitch);
         if (bo.flags & UPLOAD_BO_UPLOAD_ON_UNMAP)
             wined3d_device_context_upload_bo(context, resource, sub_resource_idx, &box, &bo, row_pitch, slice_pitch);
+        /* Otherwise the data was written straight into a coherent mapping,
+         * and no UPDATE_SUB_RESOURCE op will count it. */
+        else if (context->device->cs->collect_stats)
+            wined3d_cs_count_upload(context->device->cs, resource, &box);
         return WINED3D_OK;
     }
 
@@ -2624,6 +2718,9 @@ static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const voi
     const struct wined3d_box *box = &op->box;
     struct wined3d_context *context;
 
+    if (cs->collect_stats)
+        wined3d_cs_count_upload(cs, resource, box);
+
     context = context_acquire(cs->c.device, NULL, 0);
 
     if (resource->type == WINED3D_RTYPE_BUFFER)
@@ -2935,6 +3032,7 @@ static void wined3d_cs_st_submit(struct wined3d_device_context *context, enum wi
         ERR("Invalid opcode %#x.\n", opcode);
     else
         wined3d_cs_op_handlers[opcode](cs, &data[start]);
+    wined3d_cs_count_op(cs, opcode);
 
     if (cs->data == data)
         cs->start = cs->end = start;
@@ -3117,14 +3215,49 @@ static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined
 {
     struct wined3d_cs_packet *packet;
     size_t packet_size;
+    LONG depth;
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head & WINED3D_CS_QUEUE_MASK];
     TRACE("Queuing op %s at %p.\n", debug_cs_op(*(const enum wined3d_cs_op *)packet->data), packet);
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
     InterlockedExchange((LONG *)&queue->head, queue->head + packet_size);
+    if (cs->collect_stats)
+    {
+        InterlockedIncrement(&cs->stats.packets);
+        /* Submission is serialised, so only the reset in
+         * wined3d_cs_report_stats() can race with this. */
+        depth = (queue->head - *(volatile ULONG *)&queue->tail) & WINED3D_CS_QUEUE_MASK;
+        if (depth > *(volatile LONG *)&cs->stats.max_queue_depth)
+            InterlockedExchange(&cs->stats.max_queue_depth, depth);
+    }
 
-    if (InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
-        SetEvent(cs->event);
+    /* The exchange above is a full barrier, pairing with the one in
+     * wined3d_cs_wait_for_work(), so either the CS thread sees the new head,
+     * or we see "waiting_for_work" set. */
+    if (*(volatile LONG *)&cs->waiting_for_work
+            && InterlockedCompareExchange(&cs->waiting_for_work, FALSE, TRUE))
+        RtlWakeAddressSingle(&cs->waiting_for_work);
+}
+
+/* Wait for the CS thread to move the tail of "queue" away from "tail". */
+static void wined3d_cs_wait_for_tail(struct wined3d_cs *cs, struct wined3d_cs_queue *queue, ULONG tail)
+{
+    unsigned int spin_count;
+
+    for (spin_count = 0; spin_count < WINED3D_CS_WAIT_SPIN_COUNT; ++spin_count)
+    {
+        if (*(volatile ULONG *)&queue->tail != tail)
+            return;
+        YieldProcessor();
+    }
+
+    /* RtlWaitOnAddress() compares the tail again before sleeping, and the CS
+     * thread checks "waiting_for_tail" after updating the tail, so wakeups
+     * can't be lost. */
+    InterlockedIncrement(&cs->waiting_for_tail);
+    while (*(volatile ULONG *)&queue->tail == tail)
+        RtlWaitOnAddress(&queue->tail, &tail, sizeof(tail), NULL);
+    InterlockedDecrement(&cs->waiting_for_tail);
 }
 
 static void wined3d_cs_mt_submit(struct wined3d_device_context *context, enum wined3d_cs_queue_id queue_id)
@@ -3143,6 +3276,7 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
     size_t header_size, packet_size, remaining;
     struct wined3d_cs_packet *packet;
     ULONG head = queue->head & WINED3D_CS_QUEUE_MASK;
+    bool stalled = false;
 
     header_size = FIELD_OFFSET(struct wined3d_cs_packet, data[0]);
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[size]);
@@ -3173,7 +3307,8 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
     for (;;)
     {
-        ULONG tail = (*(volatile ULONG *)&queue->tail) & WINED3D_CS_QUEUE_MASK;
+        ULONG queue_tail = *(volatile ULONG *)&queue->tail;
+        ULONG tail = queue_tail & WINED3D_CS_QUEUE_MASK;
         ULONG new_pos;
 
         /* Empty. */
@@ -3191,6 +3326,10 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
         TRACE("Waiting for free space. Head %lu, tail %lu, packet size %Iu.\n",
                 head, tail, packet_size);
+        if (cs->collect_stats && !stalled)
+            InterlockedIncrement(&cs->stats.queue_stalls);
+        stalled = true;
+        wined3d_cs_wait_for_tail(cs, queue, queue_tail);
     }
 
     packet = (struct wined3d_cs_packet *)&queue->data[head];
@@ -3212,12 +3351,17 @@ static void *wined3d_cs_mt_require_space(struct wined3d_device_context *context,
 static void wined3d_cs_mt_finish(struct wined3d_device_context *context, enum wined3d_cs_queue_id queue_id)
 {
     struct wined3d_cs *cs = wined3d_cs_from_context(context);
+    struct wined3d_cs_queue *queue = &cs->queue[queue_id];
+    ULONG tail;
 
     if (cs->thread_id == GetCurrentThreadId())
         return wined3d_cs_st_finish(context, queue_id);
 
-    while (cs->queue[queue_id].head != *(volatile ULONG *)&cs->queue[queue_id].tail)
-        YieldProcessor();
+    if (cs->collect_stats && *(volatile ULONG *)&queue->tail != queue->head)
+        InterlockedIncrement(&cs->stats.finish_stalls);
+
+    while ((tail = *(volatile ULONG *)&queue->tail) != queue->head)
+        wined3d_cs_wait_for_tail(cs, queue, tail);
 }
 
 static const struct wined3d_device_context_ops wined3d_cs_mt_ops =
@@ -3249,23 +3393,23 @@ static void poll_queries(struct wined3d_cs *cs)
     }
 }
 
-static void wined3d_cs_wait_event(struct wined3d_cs *cs)
+static void wined3d_cs_wait_for_work(struct wined3d_cs *cs)
 {
-    InterlockedExchange(&cs->waiting_for_event, TRUE);
+    static const LONG waiting = TRUE;
 
-    /* The main thread might have enqueued a command and blocked on it after
-     * the CS thread decided to enter wined3d_cs_wait_event(), but before
-     * "waiting_for_event" was set.
-     *
-     * Likewise, we can race with the main thread when resetting
-     * "waiting_for_event", in which case we would need to call
-     * WaitForSingleObject() because the main thread called SetEvent(). */
-    if (!(wined3d_cs_queue_is_empty(cs, &cs->queue[WINED3D_CS_QUEUE_DEFAULT])
+    InterlockedExchange(&cs->waiting_for_work, TRUE);
+
+    /* The main thread might have enqueued a command after the CS thread
+     * decided to wait, but before "waiting_for_work" was set. In that case
+     * the main thread won't wake us, so check the queues again before
+     * sleeping. RtlWaitOnAddress() returns immediately if the main thread
+     * cleared "waiting_for_work" in the meantime. */
+    while (*(volatile LONG *)&cs->waiting_for_work
+            && wined3d_cs_queue_is_empty(cs, &cs->queue[WINED3D_CS_QUEUE_DEFAULT])
             && wined3d_cs_queue_is_empty(cs, &cs->queue[WINED3D_CS_QUEUE_MAP]))
-            && InterlockedCompareExchange(&cs->waiting_for_event, FALSE, TRUE))
-        return;
+        RtlWaitOnAddress(&cs->waiting_for_work, &waiting, sizeof(waiting), NULL);
 
-    WaitForSingleObject(cs->event, INFINITE);
+    InterlockedExchange(&cs->waiting_for_work, FALSE);
 }
 
 static void wined3d_cs_command_lock(const struct wined3d_cs *cs)
@@ -3304,10 +3448,13 @@ static inline bool wined3d_cs_execute_next(struct wined3d_cs *cs, struct wined3d
         wined3d_cs_command_lock(cs);
         wined3d_cs_op_handlers[opcode](cs, packet->data);
         wined3d_cs_command_unlock(cs);
+        wined3d_cs_count_op(cs, opcode);
         TRACE("%s at %p executed.\n", debug_cs_op(opcode), packet);
     }
 
     InterlockedExchange((LONG *)&queue->tail, tail);
+    if (*(volatile LONG *)&cs->waiting_for_tail)
+        RtlWakeAddressAll(&queue->tail);
     return true;
 }
 
@@ -3336,12 +3483,27 @@ static void wined3d_cs_exec_execute_command_list(struct wined3d_cs *cs, const vo
             ERR("Invalid opcode %#x.\n", opcode);
         else
             wined3d_cs_op_handlers[opcode](cs, packet->data);
+        wined3d_cs_count_op(cs, opcode);
         TRACE("%s executed.\n", debug_cs_op(opcode));
     }
 }
 
+/* Adapt the time the CS thread spins before going to sleep to the gaps
+ * between packets. If packets usually arrive within a short time, spin for
+ * about twice that long; if the gaps are too long to be worth spinning for,
+ * go to sleep quickly. */
+static void wined3d_cs_update_spin_limit(LONGLONG *spin_limit, LONGLONG gap, LONGLONG spin_min, LONGLONG spin_max)
+{
+    LONGLONG sample = gap * 2 <= spin_max ? gap * 2 : spin_min;
+
+    *spin_limit += (sample - *spin_limit) / 8;
+    *spin_limit = min(max(*spin_limit, spin_min), spin_max);
+}
+
 static DWORD WINAPI wined3d_cs_run(void *ctx)
 {
+    LONGLONG spin_min, spin_max, spin_limit;
+    LARGE_INTEGER frequency, idle_start, now;
     struct wined3d_cs_queue *queue;
     unsigned int spin_count = 0;
     struct wined3d_cs *cs = ctx;
@@ -3356,6 +3518,11 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
      * thread freeing "cs" before the FreeLibraryAndExitThread() call. */
     wined3d_module = cs->wined3d_module;
 
+    QueryPerformanceFrequency(&frequency);
+    spin_min = frequency.QuadPart * WINED3D_CS_SPIN_MIN_US / 1000000;
+    spin_max = frequency.QuadPart * WINED3D_CS_SPIN_MAX_US / 1000000;
+    spin_limit = spin_max;
+
     list_init(&cs->query_poll_list);
     cs->thread_id = GetCurrentThreadId();
     while (run)
@@ -3374,18 +3541,39 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             queue = &cs->queue[WINED3D_CS_QUEUE_DEFAULT];
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
-                if (++spin_count >= WINED3D_CS_SPIN_COUNT && list_empty(&cs->query_poll_list))
-                    wined3d_cs_wait_event(cs);
+                if (!spin_count++)
+                {
+                    QueryPerformanceCounter(&idle_start);
+                }
+                else if (!(spin_count % WINED3D_CS_SPIN_CHECK_INTERVAL) && list_empty(&cs->query_poll_list))
+                {
+                    QueryPerformanceCounter(&now);
+                    if (now.QuadPart - idle_start.QuadPart >= spin_limit)
+                        wined3d_cs_wait_for_work(cs);
+                }
+                YieldProcessor();
                 continue;
             }
         }
-        spin_count = 0;
+
+        if (spin_count)
+        {
+            QueryPerformanceCounter(&now);
+            wined3d_cs_update_spin_limit(&spin_limit, now.QuadPart - idle_start.QuadPart, spin_min, spin_max);
+            if (cs->collect_stats)
+                cs->stats.idle_time += now.QuadPart - idle_start.QuadPart;
+            spin_count = 0;
+        }
 
         run = wined3d_cs_execute_next(cs, queue);
     }
 
-    cs->queue[WINED3D_CS_QUEUE_MAP].tail = cs->queue[WINED3D_CS_QUEUE_MAP].head;
-    cs->queue[WINED3D_CS_QUEUE_DEFAULT].tail = cs->queue[WINED3D_CS_QUEUE_DEFAULT].head;
+    InterlockedExchange((LONG *)&cs->queue[WINED3D_CS_QUEUE_MAP].tail, cs->queue[WINED3D_CS_QUEUE_MAP].head);
+    InterlockedExchange((LONG *)&cs->queue[WINED3D_CS_QUEUE_DEFAULT].tail, cs->queue[WINED3D_CS_QUEUE_DEFAULT].head);
+    /* "cs" may be freed as soon as the default queue tail is updated. Waking
+     * waiters only uses the addresses, and doesn't access the queues. */
+    RtlWakeAddressAll(&cs->queue[WINED3D_CS_QUEUE_MAP].tail);
+    RtlWakeAddressAll(&cs->queue[WINED3D_CS_QUEUE_DEFAULT].tail);
     TRACE("Stopped.\n");
     FreeLibraryAndExitThread(wined3d_module, 0);
 }
@@ -3408,6 +3596,13 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     cs->c.ops = &wined3d_cs_st_ops;
     cs->c.device = device;
     cs->serialize_commands = TRACE_ON(d3d_sync) || wined3d_settings.cs_multithreaded & WINED3D_CSMT_SERIALIZE;
+    if ((cs->collect_stats = TRACE_ON(d3d_stats)))
+    {
+        LARGE_INTEGER now;
+
+        QueryPerformanceCounter(&now);
+        cs->stats.start_time = now.QuadPart;
+    }
 
     if (cs->serialize_commands)
         ERR_(d3d_sync)("Forcing serialization of all command streams.\n");
@@ -3432,18 +3627,10 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     {
         cs->c.ops = &wined3d_cs_mt_ops;
 
-        if (!(cs->event = CreateEventW(NULL, FALSE, FALSE, NULL)))
-        {
-            ERR("Failed to create command stream event.\n");
-            heap_free(cs->data);
-            goto fail;
-        }
-
         if (!(GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
                 (const WCHAR *)wined3d_cs_run, &cs->wined3d_module)))
         {
             ERR("Failed to get wined3d module handle.\n");
-            CloseHandle(cs->event);
             heap_free(cs->data);
             goto fail;
         }
@@ -3452,7 +3639,6 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
         {
             ERR("Failed to create wined3d command stream thread.\n");
             FreeLibrary(cs->wined3d_module);
-            CloseHandle(cs->event);
             heap_free(cs->data);
             goto fail;
         }
@@ -3474,8 +3660,6 @@ void wined3d_cs_destroy(struct wined3d_cs *cs)
     {
         wined3d_cs_emit_stop(cs);
         CloseHandle(cs->thread);
-        if (!CloseHandle(cs->event))
-            ERR("Closing event failed.\n");
     }
 
     wined3d_state_destroy(cs->c.state);
@@ -3990,6 +4174,24 @@ struct wined3d_deferred_context
 
     SIZE_T query_count, queries_capacity;
     struct wined3d_deferred_query_issue *queries;
+
+    /* Scratch space for wined3d_deferred_context_strip_dead_state(). */
+    SIZE_T packet_offsets_capacity;
+    SIZE_T *packet_offsets;
+};
+
+/* State that is overwritten by later packets of a command list, before any
+ * packet that consumes it. Built while walking the list backwards. */
+struct wined3d_command_list_state_mask
+{
+    bool all;
+    uint32_t ops;
+    uint32_t shaders;
+    uint32_t rtvs;
+    uint32_t streams;
+    uint32_t constant_buffers[WINED3D_SHADER_TYPE_COUNT];
+    uint32_t samplers[WINED3D_SHADER_TYPE_COUNT];
+    uint32_t srvs[WINED3D_SHADER_TYPE_COUNT][WINED3D_BITMAP_SIZE(MAX_SHADER_RESOURCE_VIEWS)];
 };
 
 static struct wined3d_deferred_context *wined3d_deferred_context_from_context(struct wined3d_device_context *context)
@@ -4288,6 +4490,8 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
         wined3d_query_decref(deferred->queries[i].query);
     heap_free(deferred->queries);
 
+    heap_free(deferred->packet_offsets);
+
     while (offset < deferred->data_size)
     {
         packet = wined3d_next_cs_packet(deferred->data, &offset, ~(SIZE_T)0);
@@ -4299,16 +4503,175 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
     heap_free(deferred);
 }
 
+static bool wined3d_command_list_state_mask_cover(uint32_t *map, unsigned int size,
+        unsigned int start_idx, unsigned int count)
+{
+    bool covered = true;
+    unsigned int i;
+
+    if (start_idx >= size || count > size - start_idx)
+        return false;
+
+    for (i = start_idx; i < start_idx + count; ++i)
+    {
+        if (!wined3d_bitmap_set(map, i))
+            covered = false;
+    }
+
+    return covered;
+}
+
+/* Add the state written by "data" to "mask". Returns false if the packet does
+ * something other than setting state; otherwise "dead" is set if all state
+ * written by the packet is overwritten by later packets. */
+static bool wined3d_command_list_state_mask_update(struct wined3d_command_list_state_mask *mask,
+        const void *data, bool *dead)
+{
+    enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)data;
+
+    switch (opcode)
+    {
+        case WINED3D_CS_OP_NOP:
+            *dead = true;
+            return true;
+
+        case WINED3D_CS_OP_RESET_STATE:
+        {
+            const struct wined3d_cs_reset_state *op = data;
+
+            *dead = mask->all && !op->invalidate;
+            mask->all = true;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_VIEWPORTS:
+        case WINED3D_CS_OP_SET_SCISSOR_RECTS:
+        case WINED3D_CS_OP_SET_VERTEX_DECLARATION:
+        case WINED3D_CS_OP_SET_INDEX_BUFFER:
+        case WINED3D_CS_OP_SET_BLEND_STATE:
+        case WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE:
+        case WINED3D_CS_OP_SET_RASTERIZER_STATE:
+            *dead = mask->all || (mask->ops & (1u << opcode));
+            mask->ops |= 1u << opcode;
+            return true;
+
+        case WINED3D_CS_OP_SET_SHADER:
+        {
+            const struct wined3d_cs_set_shader *op = data;
+
+            *dead = mask->all || (mask->shaders & (1u << op->type));
+            mask->shaders |= 1u << op->type;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_RENDERTARGET_VIEWS:
+        {
+            const struct wined3d_cs_set_rendertarget_views *op = data;
+
+            *dead = wined3d_command_list_state_mask_cover(&mask->rtvs,
+                    WINED3D_MAX_RENDER_TARGETS, op->start_idx, op->count) || mask->all;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_STREAM_SOURCES:
+        {
+            const struct wined3d_cs_set_stream_sources *op = data;
+
+            *dead = wined3d_command_list_state_mask_cover(&mask->streams,
+                    WINED3D_MAX_STREAMS, op->start_idx, op->count) || mask->all;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_CONSTANT_BUFFERS:
+        {
+            const struct wined3d_cs_set_constant_buffers *op = data;
+
+            *dead = wined3d_command_list_state_mask_cover(&mask->constant_buffers[op->type],
+                    MAX_CONSTANT_BUFFERS, op->start_idx, op->count) || mask->all;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_SAMPLERS:
+        {
+            const struct wined3d_cs_set_samplers *op = data;
+
+            *dead = wined3d_command_list_state_mask_cover(&mask->samplers[op->type],
+                    MAX_SAMPLER_OBJECTS, op->start_idx, op->count) || mask->all;
+            return true;
+        }
+
+        case WINED3D_CS_OP_SET_SHADER_RESOURCE_VIEWS:
+        {
+            const struct wined3d_cs_set_shader_resource_views *op = data;
+
+            *dead = wined3d_command_list_state_mask_cover(mask->srvs[op->type],
+                    MAX_SHADER_RESOURCE_VIEWS, op->start_idx, op->count) || mask->all;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/* Applications commonly reset and rebind most of the pipeline state at the
+ * start of a command list, or between draws, without every binding ending up
+ * being used. Drop state packets that are overwritten before anything reads
+ * them while we're still on the recording thread, so that the CS thread
+ * doesn't have to execute them and invalidate the corresponding state. */
+static void wined3d_deferred_context_strip_dead_state(struct wined3d_deferred_context *deferred)
+{
+    struct wined3d_command_list_state_mask mask;
+    SIZE_T offset = 0, count = 0, dead_count = 0;
+    struct wined3d_cs_packet *packet;
+    bool dead;
+
+    while (offset < deferred->data_size)
+    {
+        if (!wined3d_array_reserve((void **)&deferred->packet_offsets, &deferred->packet_offsets_capacity,
+                count + 1, sizeof(*deferred->packet_offsets)))
+            return;
+        deferred->packet_offsets[count++] = offset;
+        wined3d_next_cs_packet(deferred->data, &offset, ~(SIZE_T)0);
+    }
+
+    /* State set at the end of the list may be used by subsequent commands on
+     * the immediate context, so treat the end of the list as a consumer. */
+    memset(&mask, 0, sizeof(mask));
+    while (count--)
+    {
+        packet = (struct wined3d_cs_packet *)((BYTE *)deferred->data + deferred->packet_offsets[count]);
+
+        if (!wined3d_command_list_state_mask_update(&mask, packet->data, &dead))
+        {
+            memset(&mask, 0, sizeof(mask));
+            continue;
+        }
+
+        if (!dead || *(const enum wined3d_cs_op *)packet->data == WINED3D_CS_OP_NOP)
+            continue;
+
+        wined3d_cs_packet_decref_objects(packet);
+        *(enum wined3d_cs_op *)packet->data = WINED3D_CS_OP_NOP;
+        ++dead_count;
+    }
+
+    if (dead_count)
+        TRACE_(d3d_perf)("Dropped %Iu redundant state packets from deferred context %p.\n", dead_count, deferred);
+}
+
 HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device_context *context,
         bool restore, struct wined3d_command_list **list)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
     struct wined3d_command_list *object;
+    SIZE_T offset = 0;
     void *memory;
 
     TRACE("context %p, list %p.\n", context, list);
 
     wined3d_device_context_lock(context);
+    wined3d_deferred_context_strip_dead_state(deferred);
     memory = heap_alloc(sizeof(*object) + deferred->resource_count * sizeof(*object->resources)
             + deferred->upload_count * sizeof(*object->uploads)
             + deferred->command_list_count * sizeof(*object->command_lists)
@@ -4353,8 +4716,18 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     /* Transfer our references to the queries to the command list. */
 
     object->data = memory;
-    object->data_size = deferred->data_size;
-    memcpy(object->data, deferred->data, deferred->data_size);
+    object->data_size = 0;
+    while (offset < deferred->data_size)
+    {
+        const struct wined3d_cs_packet *packet;
+        SIZE_T start = offset;
+
+        packet = wined3d_next_cs_packet(deferred->data, &offset, ~(SIZE_T)0);
+        if (*(const enum wined3d_cs_op *)packet->data == WINED3D_CS_OP_NOP)
+            continue;
+        memcpy((BYTE *)object->data + object->data_size, packet, offset - start);
+        object->data_size += offset - start;
+    }
 
     deferred->data_size = 0;
     deferred->resource_count = 0;
@@ -1178,12 +1178,254 @@ bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl, struct win
     bo->command_fence_id = 0;
     bo->b.buffer_offset = buffer_offset;
     bo->b.memory_offset = bo->b.buffer_offset;
+    bo->streaming_entry = NULL;
     bo->b.map_ptr = NULL;
     bo->b.client_map_count = 0;
 
     return true;
 }
 
+static void wined3d_device_gl_create_streaming_ring(struct wined3d_device_gl *device_gl,
+        struct wined3d_context_gl *context_gl)
+{
+    struct wined3d_streaming_ring_gl *ring = &device_gl->streaming_ring;
+    const struct wined3d_gl_info *gl_info = context_gl->gl_info;
+    struct wined3d_bo_address addr;
+    struct wined3d_bo_gl *bo;
+
+    if (!gl_info->supported[ARB_BUFFER_STORAGE] || !context_gl->c.d3d_info->fences)
+        return;
+
+    if (!(ring->entries = heap_calloc(WINED3D_STREAMING_RING_ENTRY_COUNT, sizeof(*ring->entries))))
+        return;
+
+    ring->flags = GL_CLIENT_STORAGE_BIT | GL_MAP_WRITE_BIT;
+    if (!(bo = heap_alloc(sizeof(*bo))))
+        goto fail;
+    if (!wined3d_device_gl_create_bo(device_gl, context_gl, WINED3D_STREAMING_RING_SIZE,
+            GL_ARRAY_BUFFER, GL_STREAM_DRAW, true, ring->flags, bo))
+    {
+        heap_free(bo);
+        goto fail;
+    }
+
+    addr.buffer_object = &bo->b;
+    addr.addr = NULL;
+    if (!bo->memory || !wined3d_context_gl_map_bo_address(context_gl, &addr,
+            WINED3D_STREAMING_RING_SIZE, WINED3D_MAP_WRITE | WINED3D_MAP_NOOVERWRITE))
+    {
+        WARN("Failed to map streaming ring memory.\n");
+        wined3d_context_gl_destroy_bo(context_gl, bo);
+        heap_free(bo);
+        goto fail;
+    }
+
+    ring->bo = bo;
+    ring->head = ring->tail = 0;
+    ring->entry_head = ring->entry_tail = 0;
+    ring->detached_count = 0;
+    TRACE("Created %u byte streaming ring at offset %#Ix of chunk %p.\n",
+            WINED3D_STREAMING_RING_SIZE, bo->b.buffer_offset, bo->memory->chunk);
+    return;
+
+fail:
+    heap_free(ring->entries);
+    ring->entries = NULL;
+}
+
+static void wined3d_device_gl_destroy_streaming_ring(struct wined3d_device_gl *device_gl,
+        struct wined3d_context_gl *context_gl)
+{
+    struct wined3d_streaming_ring_gl *ring = &device_gl->streaming_ring;
+    struct wined3d_bo_gl *bo;
+
+    if (!(bo = ring->bo))
+        return;
+
+    wined3d_device_gl_reclaim_streaming_ring(device_gl);
+    if (ring->entry_head != ring->entry_tail)
+        ERR("Streaming ring still has %u entries in use.\n", ring->entry_head - ring->entry_tail);
+    if (ring->detached_count)
+        ERR("Streaming ring still has %u detached entries.\n", ring->detached_count);
+
+    wined3d_device_gl_allocator_lock(device_gl);
+    ring->bo = NULL;
+    wined3d_device_gl_allocator_unlock(device_gl);
+
+    wined3d_context_gl_destroy_bo(context_gl, bo);
+    heap_free(bo);
+    heap_free(ring->entries);
+    ring->entries = NULL;
+}
+
+/* Suballocate a bo for a DISCARD map from the streaming ring. This only bumps
+ * the ring head; no GL calls are made, and the memory is already mapped. */
+bool wined3d_device_gl_create_streaming_bo(struct wined3d_device_gl *device_gl, GLsizeiptr size,
+        GLenum binding, GLbitfield flags, struct wined3d_bo_gl *bo)
+{
+    const struct wined3d_gl_info *gl_info = &device_gl->d.adapter->gl_info;
+    struct wined3d_streaming_ring_gl *ring = &device_gl->streaming_ring;
+    struct wined3d_streaming_entry_gl *entry;
+    struct wined3d_bo_gl *ring_bo;
+    uint64_t start, offset;
+    unsigned int i;
+
+    if (flags != ring->flags || size > WINED3D_STREAMING_RING_SIZE / 4
+            || !use_buffer_chunk_suballocation(device_gl, gl_info, binding))
+        return false;
+
+    wined3d_device_gl_allocator_lock(device_gl);
+
+    if (!(ring_bo = ring->bo) || ring->entry_head - ring->entry_tail == WINED3D_STREAMING_RING_ENTRY_COUNT)
+    {
+        wined3d_device_gl_allocator_unlock(device_gl);
+        return false;
+    }
+
+    start = (ring->head + WINED3D_STREAMING_RING_ALIGNMENT - 1) & ~(uint64_t)(WINED3D_STREAMING_RING_ALIGNMENT - 1);
+    for (;;)
+    {
+        /* Allocations never wrap around the end of the ring. */
+        if ((start % WINED3D_STREAMING_RING_SIZE) + size > WINED3D_STREAMING_RING_SIZE)
+            start = (start + WINED3D_STREAMING_RING_SIZE - 1) & ~(uint64_t)(WINED3D_STREAMING_RING_SIZE - 1);
+        if (start + size - ring->tail > WINED3D_STREAMING_RING_SIZE)
+        {
+            wined3d_device_gl_allocator_unlock(device_gl);
+            TRACE_(d3d_perf)("Streaming ring is full.\n");
+            return false;
+        }
+
+        /* Skip over the memory of detached entries. */
+        offset = start % WINED3D_STREAMING_RING_SIZE;
+        for (i = 0; i < ring->detached_count; ++i)
+        {
+            entry = &ring->detached[i];
+            if (offset < entry->end && entry->start < offset + size)
+                break;
+        }
+        if (i == ring->detached_count)
+            break;
+        start += entry->end - offset;
+        start = (start + WINED3D_STREAMING_RING_ALIGNMENT - 1) & ~(uint64_t)(WINED3D_STREAMING_RING_ALIGNMENT - 1);
+    }
+
+    /* The entry covers any padding as well, so that reclaiming it advances
+     * the tail past the padding. */
+    entry = &ring->entries[ring->entry_head++ % WINED3D_STREAMING_RING_ENTRY_COUNT];
+    entry->start = ring->head;
+    entry->end = start + size;
+    entry->fence_id = 0;
+    entry->stall_fence_id = 0;
+    entry->bo = bo;
+    entry->retired = false;
+    ring->head = entry->end;
+
+    wined3d_device_gl_allocator_unlock(device_gl);
+
+    bo->id = ring_bo->id;
+    bo->memory = ring_bo->memory;
+    bo->size = size;
+    bo->binding = binding;
+    bo->usage = GL_STREAM_DRAW;
+    bo->flags = flags;
+    bo->b.coherent = false;
+    list_init(&bo->b.users);
+    bo->command_fence_id = 0;
+    bo->b.buffer_offset = ring_bo->b.buffer_offset + (start % WINED3D_STREAMING_RING_SIZE);
+    bo->b.memory_offset = bo->b.buffer_offset;
+    bo->b.map_ptr = NULL;
+    bo->b.client_map_count = 0;
+    bo->streaming_entry = entry;
+
+    TRACE("Allocated %Iu bytes at ring position 0x%s.\n", size, wine_dbgstr_longlong(start));
+
+    return true;
+}
+
+/* Move an entry that is still in use out of the ring order. */
+static bool wined3d_streaming_ring_gl_detach_entry(struct wined3d_streaming_ring_gl *ring,
+        struct wined3d_streaming_entry_gl *entry)
+{
+    struct wined3d_streaming_entry_gl *detached;
+    GLsizeiptr size = entry->bo->size;
+
+    if (ring->detached_count == ARRAY_SIZE(ring->detached))
+        return false;
+
+    TRACE_(d3d_perf)("Detaching long-lived streaming bo %p.\n", entry->bo);
+
+    detached = &ring->detached[ring->detached_count++];
+    *detached = *entry;
+    detached->start = (entry->end - size) % WINED3D_STREAMING_RING_SIZE;
+    detached->end = detached->start + size;
+    entry->bo->streaming_entry = detached;
+    return true;
+}
+
+void wined3d_device_gl_reclaim_streaming_ring(struct wined3d_device_gl *device_gl)
+{
+    struct wined3d_streaming_ring_gl *ring = &device_gl->streaming_ring;
+    struct wined3d_streaming_entry_gl *entry;
+    unsigned int i = 0;
+
+    wined3d_device_gl_allocator_lock(device_gl);
+
+    while (i < ring->detached_count)
+    {
+        entry = &ring->detached[i];
+        if (!entry->retired || entry->fence_id > device_gl->completed_fence_id)
+        {
+            ++i;
+            continue;
+        }
+
+        if (i != --ring->detached_count)
+        {
+            *entry = ring->detached[ring->detached_count];
+            if (!entry->retired)
+                entry->bo->streaming_entry = entry;
+        }
+    }
+
+    while (ring->entry_tail != ring->entry_head)
+    {
+        entry = &ring->entries[ring->entry_tail % WINED3D_STREAMING_RING_ENTRY_COUNT];
+        if (entry->retired)
+        {
+            if (entry->fence_id > device_gl->completed_fence_id)
+                break;
+        }
+        else
+        {
+            /* Buffers that stop being discarded keep their last bo around
+             * indefinitely. Give such bos a frame to be retired once they
+             * reach the tail, and move them out of the way otherwise. */
+            if (!entry->stall_fence_id)
+                entry->stall_fence_id = device_gl->current_fence_id;
+            if (device_gl->current_fence_id - entry->stall_fence_id < 2
+                    || !wined3d_streaming_ring_gl_detach_entry(ring, entry))
+                break;
+        }
+        ring->tail = entry->end;
+        ++ring->entry_tail;
+    }
+
+    wined3d_device_gl_allocator_unlock(device_gl);
+}
+
+void wined3d_device_gl_retire_streaming_bo(struct wined3d_device_gl *device_gl, struct wined3d_bo_gl *bo)
+{
+    struct wined3d_streaming_entry_gl *entry = bo->streaming_entry;
+
+    wined3d_device_gl_allocator_lock(device_gl);
+    entry->fence_id = bo->command_fence_id;
+    entry->retired = true;
+    wined3d_device_gl_allocator_unlock(device_gl);
+
+    bo->streaming_entry = NULL;
+    wined3d_device_gl_reclaim_streaming_ring(device_gl);
+}
+
 void wined3d_device_gl_delete_opengl_contexts_cs(void *object)
 {
     struct wined3d_device_gl *device_gl = object;
@@ -1213,6 +1455,7 @@ void wined3d_device_gl_delete_opengl_contexts_cs(void *object)
         wined3d_context_gl_wait_command_fence(context_gl,
                 wined3d_device_gl(context_gl->c.device)->current_fence_id - 1);
     }
+    wined3d_device_gl_destroy_streaming_ring(device_gl, context_gl);
     wined3d_allocator_cleanup(&device_gl->allocator);
 
     context_release(context);
@@ -1287,6 +1530,7 @@ void wined3d_device_gl_create_primary_opengl_context_cs(void *object)
     wined3d_raw_blitter_create(&device->blitter, context_gl->gl_info);
 
     wined3d_device_gl_create_dummy_textures(device_gl, context_gl);
+    wined3d_device_gl_create_streaming_ring(device_gl, context_gl);
     wined3d_device_create_default_samplers(device, context);
     context_release(context);
 }
@@ -122,6 +122,23 @@ struct constant_heap
 };
 
 /* GLSL shader private data */
+struct glsl_program_cache_key
+{
+    uint64_t hash[2];
+};
+
+/* Pre-link state of a program that is not part of its shader sources. */
+struct glsl_program_link_state
+{
+    uint32_t attribs_map;
+    uint32_t flags;
+};
+
+#define WINED3D_GLSL_LINK_EXPLICIT_ATTRIB_LOCATION  0x00000001
+#define WINED3D_GLSL_LINK_SM4_VERTEX_INPUTS         0x00000002
+#define WINED3D_GLSL_LINK_LEGACY_FRAGMENT_OUTPUT    0x00000004
+#define WINED3D_GLSL_LINK_DUAL_SOURCE_BLEND         0x00000008
+
 struct shader_glsl_priv
 {
     struct wined3d_string_buffer shader_buffer;
@@ -138,6 +155,10 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL ffp_proj_control;
     BOOL legacy_lighting;
+
+    BOOL program_cache_checked;
+    BOOL program_cache_enabled;
+    struct glsl_program_cache_key program_cache_driver_key;
 };
 
 struct glsl_vs_program
@@ -636,6 +657,364 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+/* The program binary cache stores the output of glGetProgramBinary() for
+ * linked programs on disk, keyed by the GL driver identity, the pre-link
+ * program state and the sources of the attached shaders. Files are named
+ * after the first half of the key; the header repeats the full key. */
+#define WINED3D_GLSL_PROGRAM_CACHE_MAGIC    0x62706777 /* wgpb */
+#define WINED3D_GLSL_PROGRAM_CACHE_VERSION  1
+
+struct glsl_program_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    struct glsl_program_cache_key key;
+    uint32_t format;
+    uint32_t size;
+};
+
+struct glsl_program_cache_file
+{
+    FILETIME access_time;
+    uint64_t size;
+    char name[MAX_PATH];
+};
+
+static struct
+{
+    BOOL initialised;
+    BOOL enabled;
+    char path[MAX_PATH];
+    uint64_t size;
+    uint64_t max_size;
+}
+glsl_program_cache;
+
+static CRITICAL_SECTION glsl_program_cache_cs;
+static CRITICAL_SECTION_DEBUG glsl_program_cache_cs_debug =
+{
+    0, 0, &glsl_program_cache_cs,
+    {&glsl_program_cache_cs_debug.ProcessLocksList,
+    &glsl_program_cache_cs_debug.ProcessLocksList},
+    0, 0, {(DWORD_PTR)(__FILE__ ": glsl_program_cache_cs")}
+};
+static CRITICAL_SECTION glsl_program_cache_cs = {&glsl_program_cache_cs_debug, -1, 0, 0, 0, 0};
+
+static void glsl_program_cache_key_init(struct glsl_program_cache_key *key)
+{
+    key->hash[0] = 0xcbf29ce484222325ull;
+    key->hash[1] = 0x84222325cbf29ce4ull;
+}
+
+/* FNV-1a over two lanes with different offset bases. */
+static void glsl_program_cache_key_update(struct glsl_program_cache_key *key, const void *data, size_t size)
+{
+    const unsigned char *ptr = data;
+    uint64_t h0 = key->hash[0], h1 = key->hash[1];
+
+    while (size--)
+    {
+        h0 = (h0 ^ *ptr) * 0x100000001b3ull;
+        h1 = (h1 ^ *ptr++) * 0x100000001b3ull;
+    }
+
+    key->hash[0] = h0;
+    key->hash[1] = h1;
+}
+
+static void glsl_program_cache_get_file_name(const struct glsl_program_cache_key *key, char *name, size_t size)
+{
+    snprintf(name, size, "%s\\%08x%08x.bin", glsl_program_cache.path,
+            (unsigned int)(key->hash[0] >> 32), (unsigned int)key->hash[0]);
+}
+
+static int glsl_program_cache_file_compare(const void *a, const void *b)
+{
+    const struct glsl_program_cache_file *f1 = a, *f2 = b;
+
+    return CompareFileTime(&f1->access_time, &f2->access_time);
+}
+
+/* Recompute the cache size from the directory contents, which may have been
+ * changed by other processes, and evict the least recently used programs if
+ * the limit is exceeded. Called with glsl_program_cache_cs held. */
+static void glsl_program_cache_trim(void)
+{
+    struct glsl_program_cache_file *files = NULL;
+    SIZE_T count = 0, capacity = 0, i;
+    char pattern[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    uint64_t size = 0;
+    HANDLE find;
+
+    snprintf(pattern, sizeof(pattern), "%s\\*.bin", glsl_program_cache.path);
+    if ((find = FindFirstFileA(pattern, &data)) == INVALID_HANDLE_VALUE)
+    {
+        glsl_program_cache.size = 0;
+        return;
+    }
+
+    do
+    {
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+        if (!wined3d_array_reserve((void **)&files, &capacity, count + 1, sizeof(*files)))
+            break;
+        files[count].access_time = data.ftLastAccessTime;
+        files[count].size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        snprintf(files[count].name, sizeof(files[count].name), "%s\\%s",
+                glsl_program_cache.path, data.cFileName);
+        size += files[count++].size;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    if (size > glsl_program_cache.max_size)
+    {
+        TRACE("Program cache size %s exceeds the limit, evicting.\n", wine_dbgstr_longlong(size));
+        qsort(files, count, sizeof(*files), glsl_program_cache_file_compare);
+        for (i = 0; i < count && size > glsl_program_cache.max_size / 4 * 3; ++i)
+        {
+            if (DeleteFileA(files[i].name))
+                size -= files[i].size;
+        }
+    }
+
+    glsl_program_cache.size = size;
+    heap_free(files);
+}
+
+static BOOL glsl_program_cache_init(void)
+{
+    BOOL enabled;
+
+    EnterCriticalSection(&glsl_program_cache_cs);
+
+    if (!glsl_program_cache.initialised)
+    {
+        glsl_program_cache.initialised = TRUE;
+        glsl_program_cache.max_size = (uint64_t)wined3d_settings.shader_cache_size * 1024 * 1024;
+        glsl_program_cache.enabled = wined3d_get_shader_cache_directory("glsl",
+                glsl_program_cache.path, sizeof(glsl_program_cache.path));
+
+        if (glsl_program_cache.enabled)
+        {
+            TRACE("Using program cache directory %s.\n", debugstr_a(glsl_program_cache.path));
+            glsl_program_cache_trim();
+        }
+    }
+    enabled = glsl_program_cache.enabled;
+
+    LeaveCriticalSection(&glsl_program_cache_cs);
+
+    return enabled;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_program_cache_enabled(const struct wined3d_gl_info *gl_info, struct shader_glsl_priv *priv)
+{
+    static const GLenum strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION_ARB};
+    struct glsl_program_cache_key *key = &priv->program_cache_driver_key;
+    const char *str;
+    unsigned int i;
+    GLint count;
+
+    if (priv->program_cache_checked)
+        return priv->program_cache_enabled;
+    priv->program_cache_checked = TRUE;
+
+    if (!gl_info->supported[ARB_GET_PROGRAM_BINARY])
+        return FALSE;
+
+    gl_info->gl_ops.gl.p_glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+    checkGLcall("glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS)");
+    if (!count)
+    {
+        TRACE("The GL driver doesn't support any program binary formats.\n");
+        return FALSE;
+    }
+
+    if (!glsl_program_cache_init())
+        return FALSE;
+
+    glsl_program_cache_key_init(key);
+    for (i = 0; i < ARRAY_SIZE(strings); ++i)
+    {
+        if ((str = (const char *)gl_info->gl_ops.gl.p_glGetString(strings[i])))
+            glsl_program_cache_key_update(key, str, strlen(str) + 1);
+    }
+
+    return priv->program_cache_enabled = TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_get_program_cache_key(const struct wined3d_gl_info *gl_info,
+        const struct shader_glsl_priv *priv, GLuint program_id, const struct glsl_program_link_state *link_state,
+        struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_key sources = {{0, 0}}, shader_key;
+    GLint shader_count, type, length, source_size = 0;
+    GLuint shaders[8];
+    char *source = NULL;
+    GLint i;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_ATTACHED_SHADERS, &shader_count));
+    if (shader_count > ARRAY_SIZE(shaders))
+        return FALSE;
+    GL_EXTCALL(glGetAttachedShaders(program_id, shader_count, NULL, shaders));
+
+    /* The attachment order doesn't affect the linked program, so combine the
+     * per-shader hashes in an order-independent way. */
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        if (length <= 0)
+            continue;
+        if (length > source_size)
+        {
+            heap_free(source);
+            if (!(source = heap_alloc(length)))
+                return FALSE;
+            source_size = length;
+        }
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size, &length, source));
+
+        glsl_program_cache_key_init(&shader_key);
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type));
+        glsl_program_cache_key_update(&shader_key, &type, sizeof(type));
+        glsl_program_cache_key_update(&shader_key, source, length);
+        sources.hash[0] += shader_key.hash[0];
+        sources.hash[1] += shader_key.hash[1];
+    }
+    heap_free(source);
+    checkGLcall("get program sources");
+
+    *key = priv->program_cache_driver_key;
+    glsl_program_cache_key_update(key, link_state, sizeof(*link_state));
+    glsl_program_cache_key_update(key, &sources, sizeof(sources));
+
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_load_program_binary(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header header;
+    char name[MAX_PATH];
+    GLint status = 0;
+    FILETIME now;
+    void *data;
+    HANDLE file;
+    DWORD read;
+
+    glsl_program_cache_get_file_name(key, name, sizeof(name));
+    if ((file = CreateFileA(name, GENERIC_READ | FILE_WRITE_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL)) == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (!ReadFile(file, &header, sizeof(header), &read, NULL) || read != sizeof(header)
+            || header.magic != WINED3D_GLSL_PROGRAM_CACHE_MAGIC
+            || header.version != WINED3D_GLSL_PROGRAM_CACHE_VERSION
+            || memcmp(&header.key, key, sizeof(*key))
+            || !(data = heap_alloc(header.size)))
+    {
+        CloseHandle(file);
+        return FALSE;
+    }
+
+    if (!ReadFile(file, data, header.size, &read, NULL) || read != header.size)
+    {
+        heap_free(data);
+        CloseHandle(file);
+        return FALSE;
+    }
+
+    /* The access time is used to find the least recently used programs. */
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, &now, NULL);
+    CloseHandle(file);
+
+    GL_EXTCALL(glProgramBinary(program_id, header.format, data, header.size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    heap_free(data);
+
+    if (!status)
+        WARN("Failed to load program binary %s, format %#x.\n", debugstr_a(name), header.format);
+
+    return status;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_store_program_binary(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header *header;
+    char name[MAX_PATH];
+    GLint status, length;
+    GLenum format;
+    DWORD size;
+    BOOL ret;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (!status || length <= 0 || !(header = heap_alloc(sizeof(*header) + length)))
+        return;
+
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &format, header + 1));
+    checkGLcall("glGetProgramBinary");
+
+    header->magic = WINED3D_GLSL_PROGRAM_CACHE_MAGIC;
+    header->version = WINED3D_GLSL_PROGRAM_CACHE_VERSION;
+    header->key = *key;
+    header->format = format;
+    header->size = length;
+
+    glsl_program_cache_get_file_name(key, name, sizeof(name));
+    size = sizeof(*header) + length;
+    ret = wined3d_write_shader_cache_file(name, header, size);
+    heap_free(header);
+    if (!ret)
+        return;
+
+    EnterCriticalSection(&glsl_program_cache_cs);
+    glsl_program_cache.size += size;
+    if (glsl_program_cache.size > glsl_program_cache.max_size)
+        glsl_program_cache_trim();
+    LeaveCriticalSection(&glsl_program_cache_cs);
+}
+
+/* Link a program, or restore it from the program binary cache. "link_state"
+ * is NULL for programs that can't be cached. Returns whether the program was
+ * actually linked.
+ *
+ * Context activation is done by the caller. */
+static BOOL shader_glsl_link_program(const struct wined3d_gl_info *gl_info, struct shader_glsl_priv *priv,
+        GLuint program_id, const struct glsl_program_link_state *link_state)
+{
+    struct glsl_program_cache_key key;
+    BOOL cache;
+
+    if ((cache = link_state && shader_glsl_program_cache_enabled(gl_info, priv)
+            && shader_glsl_get_program_cache_key(gl_info, priv, program_id, link_state, &key)))
+    {
+        if (shader_glsl_load_program_binary(gl_info, program_id, &key))
+        {
+            TRACE("Loaded GLSL shader program %u from the program cache.\n", program_id);
+            return FALSE;
+        }
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+    GL_EXTCALL(glLinkProgram(program_id));
+    shader_glsl_validate_link(gl_info, program_id);
+
+    if (cache)
+        shader_glsl_store_program_binary(gl_info, program_id, &key);
+    return TRUE;
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -10114,6 +10493,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
     struct wined3d_string_buffer *buffer = &priv->shader_buffer;
     struct glsl_cs_compiled_shader *gl_shaders;
     struct glsl_shader_private *shader_data;
+    struct glsl_program_link_state link_state = {0};
     struct glsl_shader_prog_link *entry;
     GLuint shader_id, program_id;
 
@@ -10169,9 +10549,8 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    if (shader_glsl_link_program(gl_info, priv, program_id, &link_state))
+        wined3d_cs_count_pipeline(context_gl->c.device->cs);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10239,6 +10618,7 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     const struct wined3d_shader *pre_rasterization_shader;
     const struct ps_np2fixup_info *np2fixup_info = NULL;
     struct wined3d_shader *hshader, *dshader, *gshader;
+    struct glsl_program_link_state link_state = {0};
     struct glsl_shader_prog_link *entry = NULL;
     struct wined3d_shader *vshader = NULL;
     struct wined3d_shader *pshader = NULL;
@@ -10418,6 +10798,16 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         attribs_map = (1u << WINED3D_FFP_ATTRIBS_COUNT) - 1;
     }
 
+    link_state.attribs_map = attribs_map;
+    if (shader_glsl_use_explicit_attrib_location(gl_info))
+        link_state.flags |= WINED3D_GLSL_LINK_EXPLICIT_ATTRIB_LOCATION;
+    if (vshader && vshader->reg_maps.shader_version.major >= 4)
+        link_state.flags |= WINED3D_GLSL_LINK_SM4_VERTEX_INPUTS;
+    if (use_legacy_fragment_output(gl_info))
+        link_state.flags |= WINED3D_GLSL_LINK_LEGACY_FRAGMENT_OUTPUT;
+    if (state->blend_state && state->blend_state->dual_source)
+        link_state.flags |= WINED3D_GLSL_LINK_DUAL_SOURCE_BLEND;
+
     if (!shader_glsl_use_explicit_attrib_location(gl_info))
     {
         /* Bind vertex attributes to a corresponding index number to match
@@ -10499,10 +10889,11 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    /* Link the program. Transform feedback varyings aren't part of the
+     * program cache key, so don't cache programs using them. */
+    if (shader_glsl_link_program(gl_info, priv, program_id,
+            gshader && gshader->u.gs.so_desc ? NULL : &link_state))
+        wined3d_cs_count_pipeline(context_gl->c.device->cs);
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
             vshader ? vshader->limits->constant_float : 0);
@@ -25,6 +25,7 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_stats);
 
 static void resource_check_usage(uint32_t usage, unsigned int access)
 {
@@ -209,6 +210,8 @@ HRESULT resource_init(struct wined3d_resource *resource, struct wined3d_device *
     resource->resource_ops = resource_ops;
     resource->map_binding = WINED3D_LOCATION_SYSMEM;
     resource->heap_memory = NULL;
+    resource->stats_maps = 0;
+    resource->stats_map_stalls = 0;
 
     if (!(usage & WINED3DUSAGE_PRIVATE))
     {
@@ -245,6 +248,12 @@ void resource_cleanup(struct wined3d_resource *resource)
 
     TRACE("Cleaning up resource %p.\n", resource);
 
+    if (resource->stats_maps)
+        TRACE_(d3d_stats)("Resource %p (%s, %s, %ux%ux%u): %ld maps, %ld stalled.\n", resource,
+                debug_d3dresourcetype(resource->type), debug_d3dformat(resource->format->id),
+                resource->width, resource->height, resource->depth,
+                resource->stats_maps, resource->stats_map_stalls);
+
     if (!(resource->usage & WINED3DUSAGE_PRIVATE))
     {
         if (!(resource->access & WINED3D_RESOURCE_ACCESS_CPU) && d3d->flags & WINED3D_VIDMEM_ACCOUNTING)
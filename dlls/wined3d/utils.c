@@ -7143,6 +7143,80 @@ BOOL wined3d_array_reserve(void **elements, SIZE_T *capacity, SIZE_T count, SIZE
     return TRUE;
 }
 
+/* Find, and create if needed, the on-disk shader cache directory "name". */
+BOOL wined3d_get_shader_cache_directory(const char *name, char *path, size_t size)
+{
+    DWORD attributes;
+    int len;
+    char *p;
+
+    if (!wined3d_settings.shader_cache_size)
+        return FALSE;
+
+    if (wined3d_settings.shader_cache_path)
+        len = snprintf(path, size, "%s\\%s", wined3d_settings.shader_cache_path, name);
+    else if ((p = getenv("LOCALAPPDATA")))
+        len = snprintf(path, size, "%s\\wined3d\\%s", p, name);
+    else
+        return FALSE;
+    if (len < 0 || (size_t)len >= size)
+        return FALSE;
+
+    for (p = path; *p; ++p)
+    {
+        if (*p != '\\' || p == path || p[-1] == ':' || p[-1] == '\\')
+            continue;
+        *p = 0;
+        CreateDirectoryA(path, NULL);
+        *p = '\\';
+    }
+    CreateDirectoryA(path, NULL);
+
+    attributes = GetFileAttributesA(path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        WARN("Failed to create shader cache directory %s.\n", debugstr_a(path));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Write a shader cache file. The data is written to a temporary file first,
+ * so that other processes never see a partially written file. */
+BOOL wined3d_write_shader_cache_file(const char *file_name, const void *data, DWORD size)
+{
+    char dir[MAX_PATH], tmp_name[MAX_PATH];
+    HANDLE file;
+    DWORD written;
+    char *p;
+    BOOL ret;
+
+    lstrcpynA(dir, file_name, sizeof(dir));
+    if (!(p = strrchr(dir, '\\')))
+        return FALSE;
+    *p = 0;
+
+    if (!GetTempFileNameA(dir, "wsc", 0, tmp_name))
+        return FALSE;
+    if ((file = CreateFileA(tmp_name, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        DeleteFileA(tmp_name);
+        return FALSE;
+    }
+    ret = WriteFile(file, data, size, &written, NULL) && written == size;
+    CloseHandle(file);
+
+    if (!ret || !MoveFileExA(tmp_name, file_name, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to write shader cache file %s.\n", debugstr_a(file_name));
+        DeleteFileA(tmp_name);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 static void swap_rows(float **a, float **b)
 {
     float *tmp = *a;
@@ -530,6 +530,10 @@ struct wined3d_settings
     enum wined3d_renderer renderer;
     enum wined3d_shader_backend shader_backend;
     BOOL cb_access_map_w;
+    /* On-disk shader caches. The size is in MiB, 0 disables them. The path is
+     * the base directory, each cache uses its own subdirectory of it. */
+    unsigned int shader_cache_size;
+    char *shader_cache_path;
 };
 
 extern struct wined3d_settings wined3d_settings DECLSPEC_HIDDEN;
@@ -1697,6 +1701,9 @@ struct wined3d_bo_gl
 
     GLbitfield flags;
     uint64_t command_fence_id;
+
+    /* Non-NULL if the bo was suballocated from the device streaming ring. */
+    struct wined3d_streaming_entry_gl *streaming_entry;
 };
 
 static inline struct wined3d_bo_gl *wined3d_bo_gl(struct wined3d_bo *bo)
@@ -4118,6 +4125,10 @@ struct wined3d_null_views_vk
 #define WINED3D_ALLOCATOR_MIN_BLOCK_SIZE    (WINED3D_ALLOCATOR_CHUNK_SIZE >> (WINED3D_ALLOCATOR_CHUNK_ORDER_COUNT - 1))
 #define WINED3D_SLAB_BO_MIN_OBJECT_ALIGN    16
 #define WINED3D_RETIRED_BO_SIZE_THRESHOLD   (64 * 1024 * 1024)
+#define WINED3D_STREAMING_RING_SIZE         (4 * 1024 * 1024)
+#define WINED3D_STREAMING_RING_ENTRY_COUNT  4096
+#define WINED3D_STREAMING_RING_ALIGNMENT    256
+#define WINED3D_STREAMING_RING_DETACHED_MAX 16
 
 struct wined3d_allocator_chunk
 {
@@ -4235,6 +4246,9 @@ struct wined3d_device_vk
     uint32_t vk_queue_family_index;
     uint32_t timestamp_bits;
 
+    VkPipelineCache vk_pipeline_cache;
+    size_t vk_pipeline_cache_size;
+
     struct wined3d_vk_info vk_info;
 
     struct wined3d_null_resources_vk null_resources_vk;
@@ -4299,6 +4313,32 @@ struct wined3d_device_gl
     SIZE_T retired_blocks_size;
     SIZE_T retired_block_count;
 
+    /* Persistently mapped ring used for DISCARD maps of dynamic buffers.
+     * Allocations are made in order by bumping "head", and reclaimed in
+     * order by advancing "tail" once the command fence of the oldest
+     * retired entry has completed. Entries that are still in use more than
+     * a frame after they reached the tail are moved to "detached", so that
+     * they don't hold up the tail; new allocations skip over their memory
+     * until they are retired. Protected by allocator_cs. */
+    struct wined3d_streaming_ring_gl
+    {
+        struct wined3d_bo_gl *bo;
+        GLbitfield flags;
+        uint64_t head, tail;
+        struct wined3d_streaming_entry_gl
+        {
+            uint64_t start, end;
+            uint64_t fence_id;
+            uint64_t stall_fence_id;
+            struct wined3d_bo_gl *bo;
+            bool retired;
+        } *entries;
+        unsigned int entry_head, entry_tail;
+        /* For detached entries, "start" and "end" are offsets into the ring. */
+        struct wined3d_streaming_entry_gl detached[WINED3D_STREAMING_RING_DETACHED_MAX];
+        unsigned int detached_count;
+    } streaming_ring;
+
     HWND backup_wnd;
     HDC backup_dc;
 };
@@ -4336,10 +4376,15 @@ static inline void wined3d_allocator_chunk_gl_unlock(struct wined3d_allocator_ch
 bool wined3d_device_gl_create_bo(struct wined3d_device_gl *device_gl,
         struct wined3d_context_gl *context_gl, GLsizeiptr size, GLenum binding,
         GLenum usage, bool coherent, GLbitfield flags, struct wined3d_bo_gl *bo) DECLSPEC_HIDDEN;
+bool wined3d_device_gl_create_streaming_bo(struct wined3d_device_gl *device_gl, GLsizeiptr size,
+        GLenum binding, GLbitfield flags, struct wined3d_bo_gl *bo) DECLSPEC_HIDDEN;
 void wined3d_device_gl_create_primary_opengl_context_cs(void *object) DECLSPEC_HIDDEN;
 void wined3d_device_gl_delete_opengl_contexts_cs(void *object) DECLSPEC_HIDDEN;
 HDC wined3d_device_gl_get_backup_dc(struct wined3d_device_gl *device_gl) DECLSPEC_HIDDEN;
 GLbitfield wined3d_device_gl_get_memory_type_flags(unsigned int memory_type_idx) DECLSPEC_HIDDEN;
+void wined3d_device_gl_reclaim_streaming_ring(struct wined3d_device_gl *device_gl) DECLSPEC_HIDDEN;
+void wined3d_device_gl_retire_streaming_bo(struct wined3d_device_gl *device_gl,
+        struct wined3d_bo_gl *bo) DECLSPEC_HIDDEN;
 
 static inline float wined3d_alpha_ref(const struct wined3d_state *state)
 {
@@ -4443,6 +4488,10 @@ struct wined3d_resource
 
     LONG srv_bind_count_device;
     LONG rtv_bind_count_device;
+
+    /* Lifetime map counts, only collected for the d3d_stats channel. */
+    LONG stats_maps;
+    LONG stats_map_stalls;
 };
 
 static inline ULONG wined3d_resource_incref(struct wined3d_resource *resource)
@@ -5049,7 +5098,10 @@ enum wined3d_push_constants
 
 #define WINED3D_CS_QUERY_POLL_INTERVAL  10u
 #define WINED3D_CS_QUEUE_SIZE           0x400000u
-#define WINED3D_CS_SPIN_COUNT           10000000u
+#define WINED3D_CS_SPIN_MIN_US          20
+#define WINED3D_CS_SPIN_MAX_US          2000
+#define WINED3D_CS_SPIN_CHECK_INTERVAL  64u
+#define WINED3D_CS_WAIT_SPIN_COUNT      4096u
 #define WINED3D_CS_QUEUE_MASK           (WINED3D_CS_QUEUE_SIZE - 1)
 
 C_ASSERT(!(WINED3D_CS_QUEUE_SIZE & (WINED3D_CS_QUEUE_SIZE - 1)));
@@ -5085,6 +5137,29 @@ struct wined3d_device_context
     struct wined3d_state *state;
 };
 
+/* Counters reported through the "d3d_stats" debug channel. The client
+ * counters can be updated from any thread submitting to the CS, and are
+ * updated atomically; the remaining ones are only accessed by the CS
+ * thread. */
+struct wined3d_cs_stats
+{
+    LONG packets;
+    LONG queue_stalls;
+    LONG finish_stalls;
+    LONG maps;
+    LONG map_stalls;
+    LONG max_queue_depth;
+    LONG64 upload_bytes;
+
+    unsigned int frames;
+    unsigned int draws;
+    unsigned int dispatches;
+    unsigned int state_changes;
+    unsigned int pipelines;
+    LONGLONG idle_time;
+    LONGLONG start_time;
+};
+
 struct wined3d_cs
 {
     struct wined3d_device_context c;
@@ -5101,11 +5176,20 @@ struct wined3d_cs
     struct list query_poll_list;
     BOOL queries_flushed;
 
-    HANDLE event;
-    LONG waiting_for_event;
+    LONG waiting_for_work;
+    LONG waiting_for_tail;
     LONG pending_presents;
+
+    BOOL collect_stats;
+    struct wined3d_cs_stats stats;
 };
 
+static inline void wined3d_cs_count_pipeline(struct wined3d_cs *cs)
+{
+    if (cs->collect_stats)
+        ++cs->stats.pipelines;
+}
+
 static inline void wined3d_device_context_lock(struct wined3d_device_context *context)
 {
     if (context == &context->device->cs->c)
@@ -6335,6 +6419,8 @@ static inline const struct wined3d_format_vk *wined3d_format_vk(const struct win
 }
 
 BOOL wined3d_array_reserve(void **elements, SIZE_T *capacity, SIZE_T count, SIZE_T size) DECLSPEC_HIDDEN;
+BOOL wined3d_get_shader_cache_directory(const char *name, char *path, size_t size) DECLSPEC_HIDDEN;
+BOOL wined3d_write_shader_cache_file(const char *file_name, const void *data, DWORD size) DECLSPEC_HIDDEN;
 
 static inline BOOL wined3d_format_is_typeless(const struct wined3d_format *format)
 {
@@ -62,6 +62,9 @@ struct wg_transform
     GstSample *output_sample;
     bool output_caps_changed;
     GstCaps *output_caps;
+
+    guint64 zero_copy_bytes;
+    guint64 copied_bytes;
 };
 
 static void align_video_info_planes(gsize plane_align, GstVideoInfo *info, GstVideoAlignment *align)
@@ -78,6 +81,27 @@ static void align_video_info_planes(gsize plane_align, GstVideoInfo *info, GstVi
     gst_video_info_align(info, align);
 }
 
+/* Whether the default layout of a frame already matches the one we expose for
+ * the output samples, so that decoders can write into them without a pool. */
+static bool video_info_planes_are_aligned(gsize plane_align, const GstVideoInfo *info)
+{
+    GstVideoInfo aligned_info = *info;
+    GstVideoAlignment align;
+    unsigned int i;
+
+    align_video_info_planes(plane_align, &aligned_info, &align);
+    if (aligned_info.size != info->size)
+        return false;
+
+    for (i = 0; i < GST_VIDEO_INFO_N_PLANES(info); ++i)
+    {
+        if (aligned_info.stride[i] != info->stride[i] || aligned_info.offset[i] != info->offset[i])
+            return false;
+    }
+
+    return true;
+}
+
 static GstFlowReturn transform_sink_chain_cb(GstPad *pad, GstObject *parent, GstBuffer *buffer)
 {
     struct wg_transform *transform = gst_pad_get_element_private(pad);
@@ -140,11 +164,30 @@ static gboolean transform_sink_query_cb(GstPad *pad, GstObject *parent, GstQuery
             GstCaps *caps;
 
             gst_query_parse_allocation(query, &caps, &needs_pool);
-            if (stream_type_from_caps(caps) != GST_STREAM_TYPE_VIDEO || !needs_pool)
+            if (stream_type_from_caps(caps) != GST_STREAM_TYPE_VIDEO)
+            {
+                /* Let decoders allocate their output from the sample memory directly. */
+                gst_query_add_allocation_param(query, transform->allocator, NULL);
+                GST_INFO("Proposing allocator %p for query %p.", transform->allocator, query);
+                return true;
+            }
+
+            if (!gst_video_info_from_caps(&info, caps))
                 break;
 
-            if (!gst_video_info_from_caps(&info, caps)
-                    || !(pool = gst_video_buffer_pool_new()))
+            if (!needs_pool)
+            {
+                /* Without a pool the decoder uses the default frame layout, only
+                 * propose our allocator if that matches the sample layout. */
+                if (!video_info_planes_are_aligned(plane_align, &info))
+                    break;
+
+                gst_query_add_allocation_param(query, transform->allocator, NULL);
+                GST_INFO("Proposing allocator %p for query %p.", transform->allocator, query);
+                return true;
+            }
+
+            if (!(pool = gst_video_buffer_pool_new()))
                 break;
 
             align_video_info_planes(plane_align, &info, &align);
@@ -269,6 +312,9 @@ NTSTATUS wg_transform_destroy(void *args)
     while ((sample = gst_atomic_queue_pop(transform->output_queue)))
         gst_sample_unref(sample);
 
+    GST_INFO("Transform %p delivered %" G_GUINT64_FORMAT " bytes without copy, copied %" G_GUINT64_FORMAT " bytes.",
+            transform, transform->zero_copy_bytes, transform->copied_bytes);
+
     wg_allocator_destroy(transform->allocator);
     g_object_unref(transform->container);
     g_object_unref(transform->my_sink);
@@ -710,9 +756,10 @@ static NTSTATUS copy_buffer(GstBuffer *buffer, GstCaps *caps, struct wg_sample *
     return STATUS_SUCCESS;
 }
 
-static NTSTATUS read_transform_output_data(GstBuffer *buffer, GstCaps *caps, gsize plane_align,
-        struct wg_sample *sample)
+static NTSTATUS read_transform_output_data(struct wg_transform *transform, GstBuffer *buffer,
+        GstCaps *caps, struct wg_sample *sample)
 {
+    gsize plane_align = transform->attrs.output_plane_align;
     gsize total_size;
     bool needs_copy;
     NTSTATUS status;
@@ -766,15 +813,22 @@ static NTSTATUS read_transform_output_data(GstBuffer *buffer, GstCaps *caps, gsi
 
     if (needs_copy)
     {
+        transform->copied_bytes += sample->size;
         if (stream_type_from_caps(caps) == GST_STREAM_TYPE_VIDEO)
-            GST_WARNING("Copied %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+            GST_WARNING("Copied %u bytes, sample %p, flags %#x, total copied %" G_GUINT64_FORMAT " bytes",
+                    sample->size, sample, sample->flags, transform->copied_bytes);
         else
-            GST_INFO("Copied %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+            GST_INFO("Copied %u bytes, sample %p, flags %#x, total copied %" G_GUINT64_FORMAT " bytes",
+                    sample->size, sample, sample->flags, transform->copied_bytes);
     }
-    else if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
-        GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
     else
-        GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    {
+        transform->zero_copy_bytes += sample->size;
+        if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
+            GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+        else
+            GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    }
 
     return STATUS_SUCCESS;
 }
@@ -862,8 +916,7 @@ NTSTATUS wg_transform_read_data(void *args)
         return STATUS_SUCCESS;
     }
 
-    if ((status = read_transform_output_data(output_buffer, output_caps,
-                transform->attrs.output_plane_align, sample)))
+    if ((status = read_transform_output_data(transform, output_buffer, output_caps, sample)))
     {
         wg_allocator_release_sample(transform->allocator, sample, false);
         return status;
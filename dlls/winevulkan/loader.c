@@ -605,6 +605,40 @@ VkResult WINAPI vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferA
     return params.result;
 }
 
+VkResult WINAPI vkResetCommandPool(VkDevice device, VkCommandPool handle, VkCommandPoolResetFlags flags)
+{
+    struct vk_command_pool *cmd_pool = command_pool_from_handle(handle);
+    struct vkResetCommandPool_params params;
+    VkCommandBuffer buffer;
+    NTSTATUS status;
+
+    /* Resetting the pool resets all of its command buffers, so any calls
+     * still recorded on the client side would be discarded anyway. */
+    LIST_FOR_EACH_ENTRY(buffer, &cmd_pool->command_buffers, struct VkCommandBuffer_T, pool_link)
+    {
+        buffer->stream_size = 0;
+    }
+
+    params.device = device;
+    params.commandPool = handle;
+    params.flags = flags;
+    status = UNIX_CALL(vkResetCommandPool, &params);
+    assert(!status);
+    return params.result;
+}
+
+void command_buffer_execute_stream(VkCommandBuffer buffer)
+{
+    struct execute_command_stream_params params;
+    NTSTATUS status;
+
+    params.stream = buffer->stream;
+    params.size = buffer->stream_size;
+    status = UNIX_CALL(execute_command_stream, &params);
+    assert(!status);
+    buffer->stream_size = 0;
+}
+
 void WINAPI vkFreeCommandBuffers(VkDevice device, VkCommandPool cmd_pool, uint32_t count,
                                  const VkCommandBuffer *buffers)
 {
@@ -621,6 +655,7 @@ void WINAPI vkFreeCommandBuffers(VkDevice device, VkCommandPool cmd_pool, uint32
     for (i = 0; i < count; i++)
     {
         list_remove(&buffers[i]->pool_link);
+        free(buffers[i]->stream);
         free(buffers[i]);
     }
 }
@@ -94,6 +94,7 @@ VkResult WINAPI vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkComm
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
     params.pBeginInfo = pBeginInfo;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkBeginCommandBuffer, &params);
     assert(!status && "vkBeginCommandBuffer");
     return params.result;
@@ -231,6 +232,7 @@ void WINAPI vkCmdBeginConditionalRenderingEXT(VkCommandBuffer commandBuffer, con
     struct vkCmdBeginConditionalRenderingEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pConditionalRenderingBegin = pConditionalRenderingBegin;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginConditionalRenderingEXT, &params);
 }
 
@@ -239,6 +241,7 @@ void WINAPI vkCmdBeginDebugUtilsLabelEXT(VkCommandBuffer commandBuffer, const Vk
     struct vkCmdBeginDebugUtilsLabelEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pLabelInfo = pLabelInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginDebugUtilsLabelEXT, &params);
 }
 
@@ -249,7 +252,7 @@ void WINAPI vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool
     params.queryPool = queryPool;
     params.query = query;
     params.flags = flags;
-    UNIX_CALL(vkCmdBeginQuery, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBeginQuery, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBeginQueryIndexedEXT(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t query, VkQueryControlFlags flags, uint32_t index)
@@ -260,7 +263,7 @@ void WINAPI vkCmdBeginQueryIndexedEXT(VkCommandBuffer commandBuffer, VkQueryPool
     params.query = query;
     params.flags = flags;
     params.index = index;
-    UNIX_CALL(vkCmdBeginQueryIndexedEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBeginQueryIndexedEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin, VkSubpassContents contents)
@@ -269,6 +272,7 @@ void WINAPI vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPa
     params.commandBuffer = commandBuffer;
     params.pRenderPassBegin = pRenderPassBegin;
     params.contents = contents;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginRenderPass, &params);
 }
 
@@ -278,6 +282,7 @@ void WINAPI vkCmdBeginRenderPass2(VkCommandBuffer commandBuffer, const VkRenderP
     params.commandBuffer = commandBuffer;
     params.pRenderPassBegin = pRenderPassBegin;
     params.pSubpassBeginInfo = pSubpassBeginInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginRenderPass2, &params);
 }
 
@@ -287,6 +292,7 @@ void WINAPI vkCmdBeginRenderPass2KHR(VkCommandBuffer commandBuffer, const VkRend
     params.commandBuffer = commandBuffer;
     params.pRenderPassBegin = pRenderPassBegin;
     params.pSubpassBeginInfo = pSubpassBeginInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginRenderPass2KHR, &params);
 }
 
@@ -295,6 +301,7 @@ void WINAPI vkCmdBeginRendering(VkCommandBuffer commandBuffer, const VkRendering
     struct vkCmdBeginRendering_params params;
     params.commandBuffer = commandBuffer;
     params.pRenderingInfo = pRenderingInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginRendering, &params);
 }
 
@@ -303,6 +310,7 @@ void WINAPI vkCmdBeginRenderingKHR(VkCommandBuffer commandBuffer, const VkRender
     struct vkCmdBeginRenderingKHR_params params;
     params.commandBuffer = commandBuffer;
     params.pRenderingInfo = pRenderingInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginRenderingKHR, &params);
 }
 
@@ -314,6 +322,7 @@ void WINAPI vkCmdBeginTransformFeedbackEXT(VkCommandBuffer commandBuffer, uint32
     params.counterBufferCount = counterBufferCount;
     params.pCounterBuffers = pCounterBuffers;
     params.pCounterBufferOffsets = pCounterBufferOffsets;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBeginTransformFeedbackEXT, &params);
 }
 
@@ -324,7 +333,7 @@ void WINAPI vkCmdBindDescriptorBufferEmbeddedSamplersEXT(VkCommandBuffer command
     params.pipelineBindPoint = pipelineBindPoint;
     params.layout = layout;
     params.set = set;
-    UNIX_CALL(vkCmdBindDescriptorBufferEmbeddedSamplersEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindDescriptorBufferEmbeddedSamplersEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindDescriptorBuffersEXT(VkCommandBuffer commandBuffer, uint32_t bufferCount, const VkDescriptorBufferBindingInfoEXT *pBindingInfos)
@@ -333,6 +342,7 @@ void WINAPI vkCmdBindDescriptorBuffersEXT(VkCommandBuffer commandBuffer, uint32_
     params.commandBuffer = commandBuffer;
     params.bufferCount = bufferCount;
     params.pBindingInfos = pBindingInfos;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindDescriptorBuffersEXT, &params);
 }
 
@@ -347,6 +357,7 @@ void WINAPI vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBin
     params.pDescriptorSets = pDescriptorSets;
     params.dynamicOffsetCount = dynamicOffsetCount;
     params.pDynamicOffsets = pDynamicOffsets;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindDescriptorSets, &params);
 }
 
@@ -357,7 +368,7 @@ void WINAPI vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer,
     params.buffer = buffer;
     params.offset = offset;
     params.indexType = indexType;
-    UNIX_CALL(vkCmdBindIndexBuffer, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindIndexBuffer, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindIndexBuffer2KHR(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkIndexType indexType)
@@ -368,7 +379,7 @@ void WINAPI vkCmdBindIndexBuffer2KHR(VkCommandBuffer commandBuffer, VkBuffer buf
     params.offset = offset;
     params.size = size;
     params.indexType = indexType;
-    UNIX_CALL(vkCmdBindIndexBuffer2KHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindIndexBuffer2KHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindInvocationMaskHUAWEI(VkCommandBuffer commandBuffer, VkImageView imageView, VkImageLayout imageLayout)
@@ -377,7 +388,7 @@ void WINAPI vkCmdBindInvocationMaskHUAWEI(VkCommandBuffer commandBuffer, VkImage
     params.commandBuffer = commandBuffer;
     params.imageView = imageView;
     params.imageLayout = imageLayout;
-    UNIX_CALL(vkCmdBindInvocationMaskHUAWEI, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindInvocationMaskHUAWEI, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline)
@@ -386,7 +397,7 @@ void WINAPI vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint
     params.commandBuffer = commandBuffer;
     params.pipelineBindPoint = pipelineBindPoint;
     params.pipeline = pipeline;
-    UNIX_CALL(vkCmdBindPipeline, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindPipeline, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindPipelineShaderGroupNV(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline, uint32_t groupIndex)
@@ -396,7 +407,7 @@ void WINAPI vkCmdBindPipelineShaderGroupNV(VkCommandBuffer commandBuffer, VkPipe
     params.pipelineBindPoint = pipelineBindPoint;
     params.pipeline = pipeline;
     params.groupIndex = groupIndex;
-    UNIX_CALL(vkCmdBindPipelineShaderGroupNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindPipelineShaderGroupNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindShadersEXT(VkCommandBuffer commandBuffer, uint32_t stageCount, const VkShaderStageFlagBits *pStages, const VkShaderEXT *pShaders)
@@ -406,6 +417,7 @@ void WINAPI vkCmdBindShadersEXT(VkCommandBuffer commandBuffer, uint32_t stageCou
     params.stageCount = stageCount;
     params.pStages = pStages;
     params.pShaders = pShaders;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindShadersEXT, &params);
 }
 
@@ -415,7 +427,7 @@ void WINAPI vkCmdBindShadingRateImageNV(VkCommandBuffer commandBuffer, VkImageVi
     params.commandBuffer = commandBuffer;
     params.imageView = imageView;
     params.imageLayout = imageLayout;
-    UNIX_CALL(vkCmdBindShadingRateImageNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdBindShadingRateImageNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdBindTransformFeedbackBuffersEXT(VkCommandBuffer commandBuffer, uint32_t firstBinding, uint32_t bindingCount, const VkBuffer *pBuffers, const VkDeviceSize *pOffsets, const VkDeviceSize *pSizes)
@@ -427,6 +439,7 @@ void WINAPI vkCmdBindTransformFeedbackBuffersEXT(VkCommandBuffer commandBuffer,
     params.pBuffers = pBuffers;
     params.pOffsets = pOffsets;
     params.pSizes = pSizes;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindTransformFeedbackBuffersEXT, &params);
 }
 
@@ -438,6 +451,7 @@ void WINAPI vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t first
     params.bindingCount = bindingCount;
     params.pBuffers = pBuffers;
     params.pOffsets = pOffsets;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindVertexBuffers, &params);
 }
 
@@ -451,6 +465,7 @@ void WINAPI vkCmdBindVertexBuffers2(VkCommandBuffer commandBuffer, uint32_t firs
     params.pOffsets = pOffsets;
     params.pSizes = pSizes;
     params.pStrides = pStrides;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindVertexBuffers2, &params);
 }
 
@@ -464,6 +479,7 @@ void WINAPI vkCmdBindVertexBuffers2EXT(VkCommandBuffer commandBuffer, uint32_t f
     params.pOffsets = pOffsets;
     params.pSizes = pSizes;
     params.pStrides = pStrides;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBindVertexBuffers2EXT, &params);
 }
 
@@ -478,6 +494,7 @@ void WINAPI vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkIm
     params.regionCount = regionCount;
     params.pRegions = pRegions;
     params.filter = filter;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBlitImage, &params);
 }
 
@@ -486,6 +503,7 @@ void WINAPI vkCmdBlitImage2(VkCommandBuffer commandBuffer, const VkBlitImageInfo
     struct vkCmdBlitImage2_params params;
     params.commandBuffer = commandBuffer;
     params.pBlitImageInfo = pBlitImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBlitImage2, &params);
 }
 
@@ -494,6 +512,7 @@ void WINAPI vkCmdBlitImage2KHR(VkCommandBuffer commandBuffer, const VkBlitImageI
     struct vkCmdBlitImage2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pBlitImageInfo = pBlitImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBlitImage2KHR, &params);
 }
 
@@ -509,6 +528,7 @@ void WINAPI vkCmdBuildAccelerationStructureNV(VkCommandBuffer commandBuffer, con
     params.src = src;
     params.scratch = scratch;
     params.scratchOffset = scratchOffset;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBuildAccelerationStructureNV, &params);
 }
 
@@ -521,6 +541,7 @@ void WINAPI vkCmdBuildAccelerationStructuresIndirectKHR(VkCommandBuffer commandB
     params.pIndirectDeviceAddresses = pIndirectDeviceAddresses;
     params.pIndirectStrides = pIndirectStrides;
     params.ppMaxPrimitiveCounts = ppMaxPrimitiveCounts;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBuildAccelerationStructuresIndirectKHR, &params);
 }
 
@@ -531,6 +552,7 @@ void WINAPI vkCmdBuildAccelerationStructuresKHR(VkCommandBuffer commandBuffer, u
     params.infoCount = infoCount;
     params.pInfos = pInfos;
     params.ppBuildRangeInfos = ppBuildRangeInfos;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBuildAccelerationStructuresKHR, &params);
 }
 
@@ -540,6 +562,7 @@ void WINAPI vkCmdBuildMicromapsEXT(VkCommandBuffer commandBuffer, uint32_t infoC
     params.commandBuffer = commandBuffer;
     params.infoCount = infoCount;
     params.pInfos = pInfos;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdBuildMicromapsEXT, &params);
 }
 
@@ -551,6 +574,7 @@ void WINAPI vkCmdClearAttachments(VkCommandBuffer commandBuffer, uint32_t attach
     params.pAttachments = pAttachments;
     params.rectCount = rectCount;
     params.pRects = pRects;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdClearAttachments, &params);
 }
 
@@ -563,6 +587,7 @@ void WINAPI vkCmdClearColorImage(VkCommandBuffer commandBuffer, VkImage image, V
     params.pColor = pColor;
     params.rangeCount = rangeCount;
     params.pRanges = pRanges;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdClearColorImage, &params);
 }
 
@@ -575,6 +600,7 @@ void WINAPI vkCmdClearDepthStencilImage(VkCommandBuffer commandBuffer, VkImage i
     params.pDepthStencil = pDepthStencil;
     params.rangeCount = rangeCount;
     params.pRanges = pRanges;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdClearDepthStencilImage, &params);
 }
 
@@ -583,6 +609,7 @@ void WINAPI vkCmdCopyAccelerationStructureKHR(VkCommandBuffer commandBuffer, con
     struct vkCmdCopyAccelerationStructureKHR_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyAccelerationStructureKHR, &params);
 }
 
@@ -593,7 +620,7 @@ void WINAPI vkCmdCopyAccelerationStructureNV(VkCommandBuffer commandBuffer, VkAc
     params.dst = dst;
     params.src = src;
     params.mode = mode;
-    UNIX_CALL(vkCmdCopyAccelerationStructureNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdCopyAccelerationStructureNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdCopyAccelerationStructureToMemoryKHR(VkCommandBuffer commandBuffer, const VkCopyAccelerationStructureToMemoryInfoKHR *pInfo)
@@ -601,6 +628,7 @@ void WINAPI vkCmdCopyAccelerationStructureToMemoryKHR(VkCommandBuffer commandBuf
     struct vkCmdCopyAccelerationStructureToMemoryKHR_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyAccelerationStructureToMemoryKHR, &params);
 }
 
@@ -612,6 +640,7 @@ void WINAPI vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, V
     params.dstBuffer = dstBuffer;
     params.regionCount = regionCount;
     params.pRegions = pRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBuffer, &params);
 }
 
@@ -620,6 +649,7 @@ void WINAPI vkCmdCopyBuffer2(VkCommandBuffer commandBuffer, const VkCopyBufferIn
     struct vkCmdCopyBuffer2_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyBufferInfo = pCopyBufferInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBuffer2, &params);
 }
 
@@ -628,6 +658,7 @@ void WINAPI vkCmdCopyBuffer2KHR(VkCommandBuffer commandBuffer, const VkCopyBuffe
     struct vkCmdCopyBuffer2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyBufferInfo = pCopyBufferInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBuffer2KHR, &params);
 }
 
@@ -640,6 +671,7 @@ void WINAPI vkCmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBu
     params.dstImageLayout = dstImageLayout;
     params.regionCount = regionCount;
     params.pRegions = pRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBufferToImage, &params);
 }
 
@@ -648,6 +680,7 @@ void WINAPI vkCmdCopyBufferToImage2(VkCommandBuffer commandBuffer, const VkCopyB
     struct vkCmdCopyBufferToImage2_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyBufferToImageInfo = pCopyBufferToImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBufferToImage2, &params);
 }
 
@@ -656,6 +689,7 @@ void WINAPI vkCmdCopyBufferToImage2KHR(VkCommandBuffer commandBuffer, const VkCo
     struct vkCmdCopyBufferToImage2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyBufferToImageInfo = pCopyBufferToImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyBufferToImage2KHR, &params);
 }
 
@@ -669,6 +703,7 @@ void WINAPI vkCmdCopyImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkIm
     params.dstImageLayout = dstImageLayout;
     params.regionCount = regionCount;
     params.pRegions = pRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImage, &params);
 }
 
@@ -677,6 +712,7 @@ void WINAPI vkCmdCopyImage2(VkCommandBuffer commandBuffer, const VkCopyImageInfo
     struct vkCmdCopyImage2_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyImageInfo = pCopyImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImage2, &params);
 }
 
@@ -685,6 +721,7 @@ void WINAPI vkCmdCopyImage2KHR(VkCommandBuffer commandBuffer, const VkCopyImageI
     struct vkCmdCopyImage2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyImageInfo = pCopyImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImage2KHR, &params);
 }
 
@@ -697,6 +734,7 @@ void WINAPI vkCmdCopyImageToBuffer(VkCommandBuffer commandBuffer, VkImage srcIma
     params.dstBuffer = dstBuffer;
     params.regionCount = regionCount;
     params.pRegions = pRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImageToBuffer, &params);
 }
 
@@ -705,6 +743,7 @@ void WINAPI vkCmdCopyImageToBuffer2(VkCommandBuffer commandBuffer, const VkCopyI
     struct vkCmdCopyImageToBuffer2_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyImageToBufferInfo = pCopyImageToBufferInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImageToBuffer2, &params);
 }
 
@@ -713,6 +752,7 @@ void WINAPI vkCmdCopyImageToBuffer2KHR(VkCommandBuffer commandBuffer, const VkCo
     struct vkCmdCopyImageToBuffer2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pCopyImageToBufferInfo = pCopyImageToBufferInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyImageToBuffer2KHR, &params);
 }
 
@@ -723,7 +763,7 @@ void WINAPI vkCmdCopyMemoryIndirectNV(VkCommandBuffer commandBuffer, VkDeviceAdd
     params.copyBufferAddress = copyBufferAddress;
     params.copyCount = copyCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdCopyMemoryIndirectNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdCopyMemoryIndirectNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdCopyMemoryToAccelerationStructureKHR(VkCommandBuffer commandBuffer, const VkCopyMemoryToAccelerationStructureInfoKHR *pInfo)
@@ -731,6 +771,7 @@ void WINAPI vkCmdCopyMemoryToAccelerationStructureKHR(VkCommandBuffer commandBuf
     struct vkCmdCopyMemoryToAccelerationStructureKHR_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyMemoryToAccelerationStructureKHR, &params);
 }
 
@@ -744,6 +785,7 @@ void WINAPI vkCmdCopyMemoryToImageIndirectNV(VkCommandBuffer commandBuffer, VkDe
     params.dstImage = dstImage;
     params.dstImageLayout = dstImageLayout;
     params.pImageSubresources = pImageSubresources;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyMemoryToImageIndirectNV, &params);
 }
 
@@ -752,6 +794,7 @@ void WINAPI vkCmdCopyMemoryToMicromapEXT(VkCommandBuffer commandBuffer, const Vk
     struct vkCmdCopyMemoryToMicromapEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyMemoryToMicromapEXT, &params);
 }
 
@@ -760,6 +803,7 @@ void WINAPI vkCmdCopyMicromapEXT(VkCommandBuffer commandBuffer, const VkCopyMicr
     struct vkCmdCopyMicromapEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyMicromapEXT, &params);
 }
 
@@ -768,6 +812,7 @@ void WINAPI vkCmdCopyMicromapToMemoryEXT(VkCommandBuffer commandBuffer, const Vk
     struct vkCmdCopyMicromapToMemoryEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pInfo = pInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCopyMicromapToMemoryEXT, &params);
 }
 
@@ -782,7 +827,7 @@ void WINAPI vkCmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, VkQueryPool
     params.dstOffset = dstOffset;
     params.stride = stride;
     params.flags = flags;
-    UNIX_CALL(vkCmdCopyQueryPoolResults, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdCopyQueryPoolResults, &params, sizeof(params));
 }
 
 void WINAPI vkCmdCuLaunchKernelNVX(VkCommandBuffer commandBuffer, const VkCuLaunchInfoNVX *pLaunchInfo)
@@ -790,6 +835,7 @@ void WINAPI vkCmdCuLaunchKernelNVX(VkCommandBuffer commandBuffer, const VkCuLaun
     struct vkCmdCuLaunchKernelNVX_params params;
     params.commandBuffer = commandBuffer;
     params.pLaunchInfo = pLaunchInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdCuLaunchKernelNVX, &params);
 }
 
@@ -798,6 +844,7 @@ void WINAPI vkCmdDebugMarkerBeginEXT(VkCommandBuffer commandBuffer, const VkDebu
     struct vkCmdDebugMarkerBeginEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pMarkerInfo = pMarkerInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdDebugMarkerBeginEXT, &params);
 }
 
@@ -805,7 +852,7 @@ void WINAPI vkCmdDebugMarkerEndEXT(VkCommandBuffer commandBuffer)
 {
     struct vkCmdDebugMarkerEndEXT_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdDebugMarkerEndEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDebugMarkerEndEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDebugMarkerInsertEXT(VkCommandBuffer commandBuffer, const VkDebugMarkerMarkerInfoEXT *pMarkerInfo)
@@ -813,6 +860,7 @@ void WINAPI vkCmdDebugMarkerInsertEXT(VkCommandBuffer commandBuffer, const VkDeb
     struct vkCmdDebugMarkerInsertEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pMarkerInfo = pMarkerInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdDebugMarkerInsertEXT, &params);
 }
 
@@ -823,7 +871,7 @@ void WINAPI vkCmdDecompressMemoryIndirectCountNV(VkCommandBuffer commandBuffer,
     params.indirectCommandsAddress = indirectCommandsAddress;
     params.indirectCommandsCountAddress = indirectCommandsCountAddress;
     params.stride = stride;
-    UNIX_CALL(vkCmdDecompressMemoryIndirectCountNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDecompressMemoryIndirectCountNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDecompressMemoryNV(VkCommandBuffer commandBuffer, uint32_t decompressRegionCount, const VkDecompressMemoryRegionNV *pDecompressMemoryRegions)
@@ -832,6 +880,7 @@ void WINAPI vkCmdDecompressMemoryNV(VkCommandBuffer commandBuffer, uint32_t deco
     params.commandBuffer = commandBuffer;
     params.decompressRegionCount = decompressRegionCount;
     params.pDecompressMemoryRegions = pDecompressMemoryRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdDecompressMemoryNV, &params);
 }
 
@@ -842,7 +891,7 @@ void WINAPI vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, u
     params.groupCountX = groupCountX;
     params.groupCountY = groupCountY;
     params.groupCountZ = groupCountZ;
-    UNIX_CALL(vkCmdDispatch, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDispatch, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDispatchBase(VkCommandBuffer commandBuffer, uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -855,7 +904,7 @@ void WINAPI vkCmdDispatchBase(VkCommandBuffer commandBuffer, uint32_t baseGroupX
     params.groupCountX = groupCountX;
     params.groupCountY = groupCountY;
     params.groupCountZ = groupCountZ;
-    UNIX_CALL(vkCmdDispatchBase, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDispatchBase, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDispatchBaseKHR(VkCommandBuffer commandBuffer, uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -868,7 +917,7 @@ void WINAPI vkCmdDispatchBaseKHR(VkCommandBuffer commandBuffer, uint32_t baseGro
     params.groupCountX = groupCountX;
     params.groupCountY = groupCountY;
     params.groupCountZ = groupCountZ;
-    UNIX_CALL(vkCmdDispatchBaseKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDispatchBaseKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset)
@@ -877,7 +926,7 @@ void WINAPI vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer
     params.commandBuffer = commandBuffer;
     params.buffer = buffer;
     params.offset = offset;
-    UNIX_CALL(vkCmdDispatchIndirect, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDispatchIndirect, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
@@ -888,7 +937,7 @@ void WINAPI vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint3
     params.instanceCount = instanceCount;
     params.firstVertex = firstVertex;
     params.firstInstance = firstInstance;
-    UNIX_CALL(vkCmdDraw, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDraw, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawClusterHUAWEI(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -898,7 +947,7 @@ void WINAPI vkCmdDrawClusterHUAWEI(VkCommandBuffer commandBuffer, uint32_t group
     params.groupCountX = groupCountX;
     params.groupCountY = groupCountY;
     params.groupCountZ = groupCountZ;
-    UNIX_CALL(vkCmdDrawClusterHUAWEI, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawClusterHUAWEI, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawClusterIndirectHUAWEI(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset)
@@ -907,7 +956,7 @@ void WINAPI vkCmdDrawClusterIndirectHUAWEI(VkCommandBuffer commandBuffer, VkBuff
     params.commandBuffer = commandBuffer;
     params.buffer = buffer;
     params.offset = offset;
-    UNIX_CALL(vkCmdDrawClusterIndirectHUAWEI, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawClusterIndirectHUAWEI, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
@@ -919,7 +968,7 @@ void WINAPI vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount,
     params.firstIndex = firstIndex;
     params.vertexOffset = vertexOffset;
     params.firstInstance = firstInstance;
-    UNIX_CALL(vkCmdDrawIndexed, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndexed, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
@@ -930,7 +979,7 @@ void WINAPI vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buf
     params.offset = offset;
     params.drawCount = drawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndexedIndirect, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndexedIndirect, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -943,7 +992,7 @@ void WINAPI vkCmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffe
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndexedIndirectCount, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndexedIndirectCount, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndexedIndirectCountAMD(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -956,7 +1005,7 @@ void WINAPI vkCmdDrawIndexedIndirectCountAMD(VkCommandBuffer commandBuffer, VkBu
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndexedIndirectCountAMD, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndexedIndirectCountAMD, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndexedIndirectCountKHR(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -969,7 +1018,7 @@ void WINAPI vkCmdDrawIndexedIndirectCountKHR(VkCommandBuffer commandBuffer, VkBu
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndexedIndirectCountKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndexedIndirectCountKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
@@ -980,7 +1029,7 @@ void WINAPI vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, Vk
     params.offset = offset;
     params.drawCount = drawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndirect, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndirect, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndirectByteCountEXT(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance, VkBuffer counterBuffer, VkDeviceSize counterBufferOffset, uint32_t counterOffset, uint32_t vertexStride)
@@ -993,7 +1042,7 @@ void WINAPI vkCmdDrawIndirectByteCountEXT(VkCommandBuffer commandBuffer, uint32_
     params.counterBufferOffset = counterBufferOffset;
     params.counterOffset = counterOffset;
     params.vertexStride = vertexStride;
-    UNIX_CALL(vkCmdDrawIndirectByteCountEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndirectByteCountEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -1006,7 +1055,7 @@ void WINAPI vkCmdDrawIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffe
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndirectCount, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndirectCount, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndirectCountAMD(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -1019,7 +1068,7 @@ void WINAPI vkCmdDrawIndirectCountAMD(VkCommandBuffer commandBuffer, VkBuffer bu
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndirectCountAMD, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndirectCountAMD, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawIndirectCountKHR(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -1032,7 +1081,7 @@ void WINAPI vkCmdDrawIndirectCountKHR(VkCommandBuffer commandBuffer, VkBuffer bu
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawIndirectCountKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawIndirectCountKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksEXT(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
@@ -1042,7 +1091,7 @@ void WINAPI vkCmdDrawMeshTasksEXT(VkCommandBuffer commandBuffer, uint32_t groupC
     params.groupCountX = groupCountX;
     params.groupCountY = groupCountY;
     params.groupCountZ = groupCountZ;
-    UNIX_CALL(vkCmdDrawMeshTasksEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksIndirectCountEXT(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -1055,7 +1104,7 @@ void WINAPI vkCmdDrawMeshTasksIndirectCountEXT(VkCommandBuffer commandBuffer, Vk
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawMeshTasksIndirectCountEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksIndirectCountEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksIndirectCountNV(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride)
@@ -1068,7 +1117,7 @@ void WINAPI vkCmdDrawMeshTasksIndirectCountNV(VkCommandBuffer commandBuffer, VkB
     params.countBufferOffset = countBufferOffset;
     params.maxDrawCount = maxDrawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawMeshTasksIndirectCountNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksIndirectCountNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksIndirectEXT(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
@@ -1079,7 +1128,7 @@ void WINAPI vkCmdDrawMeshTasksIndirectEXT(VkCommandBuffer commandBuffer, VkBuffe
     params.offset = offset;
     params.drawCount = drawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawMeshTasksIndirectEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksIndirectEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksIndirectNV(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
@@ -1090,7 +1139,7 @@ void WINAPI vkCmdDrawMeshTasksIndirectNV(VkCommandBuffer commandBuffer, VkBuffer
     params.offset = offset;
     params.drawCount = drawCount;
     params.stride = stride;
-    UNIX_CALL(vkCmdDrawMeshTasksIndirectNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksIndirectNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMeshTasksNV(VkCommandBuffer commandBuffer, uint32_t taskCount, uint32_t firstTask)
@@ -1099,7 +1148,7 @@ void WINAPI vkCmdDrawMeshTasksNV(VkCommandBuffer commandBuffer, uint32_t taskCou
     params.commandBuffer = commandBuffer;
     params.taskCount = taskCount;
     params.firstTask = firstTask;
-    UNIX_CALL(vkCmdDrawMeshTasksNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdDrawMeshTasksNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdDrawMultiEXT(VkCommandBuffer commandBuffer, uint32_t drawCount, const VkMultiDrawInfoEXT *pVertexInfo, uint32_t instanceCount, uint32_t firstInstance, uint32_t stride)
@@ -1111,6 +1160,7 @@ void WINAPI vkCmdDrawMultiEXT(VkCommandBuffer commandBuffer, uint32_t drawCount,
     params.instanceCount = instanceCount;
     params.firstInstance = firstInstance;
     params.stride = stride;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdDrawMultiEXT, &params);
 }
 
@@ -1124,6 +1174,7 @@ void WINAPI vkCmdDrawMultiIndexedEXT(VkCommandBuffer commandBuffer, uint32_t dra
     params.firstInstance = firstInstance;
     params.stride = stride;
     params.pVertexOffset = pVertexOffset;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdDrawMultiIndexedEXT, &params);
 }
 
@@ -1131,14 +1182,14 @@ void WINAPI vkCmdEndConditionalRenderingEXT(VkCommandBuffer commandBuffer)
 {
     struct vkCmdEndConditionalRenderingEXT_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdEndConditionalRenderingEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndConditionalRenderingEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndDebugUtilsLabelEXT(VkCommandBuffer commandBuffer)
 {
     struct vkCmdEndDebugUtilsLabelEXT_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdEndDebugUtilsLabelEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndDebugUtilsLabelEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t query)
@@ -1147,7 +1198,7 @@ void WINAPI vkCmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool,
     params.commandBuffer = commandBuffer;
     params.queryPool = queryPool;
     params.query = query;
-    UNIX_CALL(vkCmdEndQuery, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndQuery, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndQueryIndexedEXT(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t query, uint32_t index)
@@ -1157,14 +1208,14 @@ void WINAPI vkCmdEndQueryIndexedEXT(VkCommandBuffer commandBuffer, VkQueryPool q
     params.queryPool = queryPool;
     params.query = query;
     params.index = index;
-    UNIX_CALL(vkCmdEndQueryIndexedEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndQueryIndexedEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndRenderPass(VkCommandBuffer commandBuffer)
 {
     struct vkCmdEndRenderPass_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdEndRenderPass, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndRenderPass, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndRenderPass2(VkCommandBuffer commandBuffer, const VkSubpassEndInfo *pSubpassEndInfo)
@@ -1172,6 +1223,7 @@ void WINAPI vkCmdEndRenderPass2(VkCommandBuffer commandBuffer, const VkSubpassEn
     struct vkCmdEndRenderPass2_params params;
     params.commandBuffer = commandBuffer;
     params.pSubpassEndInfo = pSubpassEndInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdEndRenderPass2, &params);
 }
 
@@ -1180,6 +1232,7 @@ void WINAPI vkCmdEndRenderPass2KHR(VkCommandBuffer commandBuffer, const VkSubpas
     struct vkCmdEndRenderPass2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pSubpassEndInfo = pSubpassEndInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdEndRenderPass2KHR, &params);
 }
 
@@ -1187,14 +1240,14 @@ void WINAPI vkCmdEndRendering(VkCommandBuffer commandBuffer)
 {
     struct vkCmdEndRendering_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdEndRendering, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndRendering, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndRenderingKHR(VkCommandBuffer commandBuffer)
 {
     struct vkCmdEndRenderingKHR_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdEndRenderingKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdEndRenderingKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdEndTransformFeedbackEXT(VkCommandBuffer commandBuffer, uint32_t firstCounterBuffer, uint32_t counterBufferCount, const VkBuffer *pCounterBuffers, const VkDeviceSize *pCounterBufferOffsets)
@@ -1205,6 +1258,7 @@ void WINAPI vkCmdEndTransformFeedbackEXT(VkCommandBuffer commandBuffer, uint32_t
     params.counterBufferCount = counterBufferCount;
     params.pCounterBuffers = pCounterBuffers;
     params.pCounterBufferOffsets = pCounterBufferOffsets;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdEndTransformFeedbackEXT, &params);
 }
 
@@ -1214,6 +1268,7 @@ void WINAPI vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t command
     params.commandBuffer = commandBuffer;
     params.commandBufferCount = commandBufferCount;
     params.pCommandBuffers = pCommandBuffers;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdExecuteCommands, &params);
 }
 
@@ -1223,6 +1278,7 @@ void WINAPI vkCmdExecuteGeneratedCommandsNV(VkCommandBuffer commandBuffer, VkBoo
     params.commandBuffer = commandBuffer;
     params.isPreprocessed = isPreprocessed;
     params.pGeneratedCommandsInfo = pGeneratedCommandsInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdExecuteGeneratedCommandsNV, &params);
 }
 
@@ -1234,7 +1290,7 @@ void WINAPI vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, V
     params.dstOffset = dstOffset;
     params.size = size;
     params.data = data;
-    UNIX_CALL(vkCmdFillBuffer, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdFillBuffer, &params, sizeof(params));
 }
 
 void WINAPI vkCmdInsertDebugUtilsLabelEXT(VkCommandBuffer commandBuffer, const VkDebugUtilsLabelEXT *pLabelInfo)
@@ -1242,6 +1298,7 @@ void WINAPI vkCmdInsertDebugUtilsLabelEXT(VkCommandBuffer commandBuffer, const V
     struct vkCmdInsertDebugUtilsLabelEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pLabelInfo = pLabelInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdInsertDebugUtilsLabelEXT, &params);
 }
 
@@ -1250,7 +1307,7 @@ void WINAPI vkCmdNextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents co
     struct vkCmdNextSubpass_params params;
     params.commandBuffer = commandBuffer;
     params.contents = contents;
-    UNIX_CALL(vkCmdNextSubpass, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdNextSubpass, &params, sizeof(params));
 }
 
 void WINAPI vkCmdNextSubpass2(VkCommandBuffer commandBuffer, const VkSubpassBeginInfo *pSubpassBeginInfo, const VkSubpassEndInfo *pSubpassEndInfo)
@@ -1259,6 +1316,7 @@ void WINAPI vkCmdNextSubpass2(VkCommandBuffer commandBuffer, const VkSubpassBegi
     params.commandBuffer = commandBuffer;
     params.pSubpassBeginInfo = pSubpassBeginInfo;
     params.pSubpassEndInfo = pSubpassEndInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdNextSubpass2, &params);
 }
 
@@ -1268,6 +1326,7 @@ void WINAPI vkCmdNextSubpass2KHR(VkCommandBuffer commandBuffer, const VkSubpassB
     params.commandBuffer = commandBuffer;
     params.pSubpassBeginInfo = pSubpassBeginInfo;
     params.pSubpassEndInfo = pSubpassEndInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdNextSubpass2KHR, &params);
 }
 
@@ -1277,6 +1336,7 @@ void WINAPI vkCmdOpticalFlowExecuteNV(VkCommandBuffer commandBuffer, VkOpticalFl
     params.commandBuffer = commandBuffer;
     params.session = session;
     params.pExecuteInfo = pExecuteInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdOpticalFlowExecuteNV, &params);
 }
 
@@ -1293,6 +1353,7 @@ void WINAPI vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageF
     params.pBufferMemoryBarriers = pBufferMemoryBarriers;
     params.imageMemoryBarrierCount = imageMemoryBarrierCount;
     params.pImageMemoryBarriers = pImageMemoryBarriers;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPipelineBarrier, &params);
 }
 
@@ -1301,6 +1362,7 @@ void WINAPI vkCmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDepende
     struct vkCmdPipelineBarrier2_params params;
     params.commandBuffer = commandBuffer;
     params.pDependencyInfo = pDependencyInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPipelineBarrier2, &params);
 }
 
@@ -1309,6 +1371,7 @@ void WINAPI vkCmdPipelineBarrier2KHR(VkCommandBuffer commandBuffer, const VkDepe
     struct vkCmdPipelineBarrier2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pDependencyInfo = pDependencyInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPipelineBarrier2KHR, &params);
 }
 
@@ -1317,6 +1380,7 @@ void WINAPI vkCmdPreprocessGeneratedCommandsNV(VkCommandBuffer commandBuffer, co
     struct vkCmdPreprocessGeneratedCommandsNV_params params;
     params.commandBuffer = commandBuffer;
     params.pGeneratedCommandsInfo = pGeneratedCommandsInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPreprocessGeneratedCommandsNV, &params);
 }
 
@@ -1329,6 +1393,7 @@ void WINAPI vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout l
     params.offset = offset;
     params.size = size;
     params.pValues = pValues;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPushConstants, &params);
 }
 
@@ -1341,6 +1406,7 @@ void WINAPI vkCmdPushDescriptorSetKHR(VkCommandBuffer commandBuffer, VkPipelineB
     params.set = set;
     params.descriptorWriteCount = descriptorWriteCount;
     params.pDescriptorWrites = pDescriptorWrites;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPushDescriptorSetKHR, &params);
 }
 
@@ -1352,6 +1418,7 @@ void WINAPI vkCmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer,
     params.layout = layout;
     params.set = set;
     params.pData = pData;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdPushDescriptorSetWithTemplateKHR, &params);
 }
 
@@ -1361,7 +1428,7 @@ void WINAPI vkCmdResetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipe
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.stageMask = stageMask;
-    UNIX_CALL(vkCmdResetEvent, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdResetEvent, &params, sizeof(params));
 }
 
 void WINAPI vkCmdResetEvent2(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags2 stageMask)
@@ -1370,7 +1437,7 @@ void WINAPI vkCmdResetEvent2(VkCommandBuffer commandBuffer, VkEvent event, VkPip
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.stageMask = stageMask;
-    UNIX_CALL(vkCmdResetEvent2, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdResetEvent2, &params, sizeof(params));
 }
 
 void WINAPI vkCmdResetEvent2KHR(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags2 stageMask)
@@ -1379,7 +1446,7 @@ void WINAPI vkCmdResetEvent2KHR(VkCommandBuffer commandBuffer, VkEvent event, Vk
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.stageMask = stageMask;
-    UNIX_CALL(vkCmdResetEvent2KHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdResetEvent2KHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount)
@@ -1389,7 +1456,7 @@ void WINAPI vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPool query
     params.queryPool = queryPool;
     params.firstQuery = firstQuery;
     params.queryCount = queryCount;
-    UNIX_CALL(vkCmdResetQueryPool, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdResetQueryPool, &params, sizeof(params));
 }
 
 void WINAPI vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageResolve *pRegions)
@@ -1402,6 +1469,7 @@ void WINAPI vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, V
     params.dstImageLayout = dstImageLayout;
     params.regionCount = regionCount;
     params.pRegions = pRegions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdResolveImage, &params);
 }
 
@@ -1410,6 +1478,7 @@ void WINAPI vkCmdResolveImage2(VkCommandBuffer commandBuffer, const VkResolveIma
     struct vkCmdResolveImage2_params params;
     params.commandBuffer = commandBuffer;
     params.pResolveImageInfo = pResolveImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdResolveImage2, &params);
 }
 
@@ -1418,6 +1487,7 @@ void WINAPI vkCmdResolveImage2KHR(VkCommandBuffer commandBuffer, const VkResolve
     struct vkCmdResolveImage2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.pResolveImageInfo = pResolveImageInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdResolveImage2KHR, &params);
 }
 
@@ -1426,7 +1496,7 @@ void WINAPI vkCmdSetAlphaToCoverageEnableEXT(VkCommandBuffer commandBuffer, VkBo
     struct vkCmdSetAlphaToCoverageEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.alphaToCoverageEnable = alphaToCoverageEnable;
-    UNIX_CALL(vkCmdSetAlphaToCoverageEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetAlphaToCoverageEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetAlphaToOneEnableEXT(VkCommandBuffer commandBuffer, VkBool32 alphaToOneEnable)
@@ -1434,7 +1504,7 @@ void WINAPI vkCmdSetAlphaToOneEnableEXT(VkCommandBuffer commandBuffer, VkBool32
     struct vkCmdSetAlphaToOneEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.alphaToOneEnable = alphaToOneEnable;
-    UNIX_CALL(vkCmdSetAlphaToOneEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetAlphaToOneEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetAttachmentFeedbackLoopEnableEXT(VkCommandBuffer commandBuffer, VkImageAspectFlags aspectMask)
@@ -1442,7 +1512,7 @@ void WINAPI vkCmdSetAttachmentFeedbackLoopEnableEXT(VkCommandBuffer commandBuffe
     struct vkCmdSetAttachmentFeedbackLoopEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.aspectMask = aspectMask;
-    UNIX_CALL(vkCmdSetAttachmentFeedbackLoopEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetAttachmentFeedbackLoopEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetBlendConstants(VkCommandBuffer commandBuffer, const float blendConstants[4])
@@ -1450,6 +1520,7 @@ void WINAPI vkCmdSetBlendConstants(VkCommandBuffer commandBuffer, const float bl
     struct vkCmdSetBlendConstants_params params;
     params.commandBuffer = commandBuffer;
     params.blendConstants = blendConstants;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetBlendConstants, &params);
 }
 
@@ -1458,6 +1529,7 @@ void WINAPI vkCmdSetCheckpointNV(VkCommandBuffer commandBuffer, const void *pChe
     struct vkCmdSetCheckpointNV_params params;
     params.commandBuffer = commandBuffer;
     params.pCheckpointMarker = pCheckpointMarker;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetCheckpointNV, &params);
 }
 
@@ -1468,6 +1540,7 @@ void WINAPI vkCmdSetCoarseSampleOrderNV(VkCommandBuffer commandBuffer, VkCoarseS
     params.sampleOrderType = sampleOrderType;
     params.customSampleOrderCount = customSampleOrderCount;
     params.pCustomSampleOrders = pCustomSampleOrders;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetCoarseSampleOrderNV, &params);
 }
 
@@ -1478,6 +1551,7 @@ void WINAPI vkCmdSetColorBlendAdvancedEXT(VkCommandBuffer commandBuffer, uint32_
     params.firstAttachment = firstAttachment;
     params.attachmentCount = attachmentCount;
     params.pColorBlendAdvanced = pColorBlendAdvanced;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetColorBlendAdvancedEXT, &params);
 }
 
@@ -1488,6 +1562,7 @@ void WINAPI vkCmdSetColorBlendEnableEXT(VkCommandBuffer commandBuffer, uint32_t
     params.firstAttachment = firstAttachment;
     params.attachmentCount = attachmentCount;
     params.pColorBlendEnables = pColorBlendEnables;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetColorBlendEnableEXT, &params);
 }
 
@@ -1498,6 +1573,7 @@ void WINAPI vkCmdSetColorBlendEquationEXT(VkCommandBuffer commandBuffer, uint32_
     params.firstAttachment = firstAttachment;
     params.attachmentCount = attachmentCount;
     params.pColorBlendEquations = pColorBlendEquations;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetColorBlendEquationEXT, &params);
 }
 
@@ -1507,6 +1583,7 @@ void WINAPI vkCmdSetColorWriteEnableEXT(VkCommandBuffer commandBuffer, uint32_t
     params.commandBuffer = commandBuffer;
     params.attachmentCount = attachmentCount;
     params.pColorWriteEnables = pColorWriteEnables;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetColorWriteEnableEXT, &params);
 }
 
@@ -1517,6 +1594,7 @@ void WINAPI vkCmdSetColorWriteMaskEXT(VkCommandBuffer commandBuffer, uint32_t fi
     params.firstAttachment = firstAttachment;
     params.attachmentCount = attachmentCount;
     params.pColorWriteMasks = pColorWriteMasks;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetColorWriteMaskEXT, &params);
 }
 
@@ -1525,7 +1603,7 @@ void WINAPI vkCmdSetConservativeRasterizationModeEXT(VkCommandBuffer commandBuff
     struct vkCmdSetConservativeRasterizationModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.conservativeRasterizationMode = conservativeRasterizationMode;
-    UNIX_CALL(vkCmdSetConservativeRasterizationModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetConservativeRasterizationModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCoverageModulationModeNV(VkCommandBuffer commandBuffer, VkCoverageModulationModeNV coverageModulationMode)
@@ -1533,7 +1611,7 @@ void WINAPI vkCmdSetCoverageModulationModeNV(VkCommandBuffer commandBuffer, VkCo
     struct vkCmdSetCoverageModulationModeNV_params params;
     params.commandBuffer = commandBuffer;
     params.coverageModulationMode = coverageModulationMode;
-    UNIX_CALL(vkCmdSetCoverageModulationModeNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCoverageModulationModeNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCoverageModulationTableEnableNV(VkCommandBuffer commandBuffer, VkBool32 coverageModulationTableEnable)
@@ -1541,7 +1619,7 @@ void WINAPI vkCmdSetCoverageModulationTableEnableNV(VkCommandBuffer commandBuffe
     struct vkCmdSetCoverageModulationTableEnableNV_params params;
     params.commandBuffer = commandBuffer;
     params.coverageModulationTableEnable = coverageModulationTableEnable;
-    UNIX_CALL(vkCmdSetCoverageModulationTableEnableNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCoverageModulationTableEnableNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCoverageModulationTableNV(VkCommandBuffer commandBuffer, uint32_t coverageModulationTableCount, const float *pCoverageModulationTable)
@@ -1550,6 +1628,7 @@ void WINAPI vkCmdSetCoverageModulationTableNV(VkCommandBuffer commandBuffer, uin
     params.commandBuffer = commandBuffer;
     params.coverageModulationTableCount = coverageModulationTableCount;
     params.pCoverageModulationTable = pCoverageModulationTable;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetCoverageModulationTableNV, &params);
 }
 
@@ -1558,7 +1637,7 @@ void WINAPI vkCmdSetCoverageReductionModeNV(VkCommandBuffer commandBuffer, VkCov
     struct vkCmdSetCoverageReductionModeNV_params params;
     params.commandBuffer = commandBuffer;
     params.coverageReductionMode = coverageReductionMode;
-    UNIX_CALL(vkCmdSetCoverageReductionModeNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCoverageReductionModeNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCoverageToColorEnableNV(VkCommandBuffer commandBuffer, VkBool32 coverageToColorEnable)
@@ -1566,7 +1645,7 @@ void WINAPI vkCmdSetCoverageToColorEnableNV(VkCommandBuffer commandBuffer, VkBoo
     struct vkCmdSetCoverageToColorEnableNV_params params;
     params.commandBuffer = commandBuffer;
     params.coverageToColorEnable = coverageToColorEnable;
-    UNIX_CALL(vkCmdSetCoverageToColorEnableNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCoverageToColorEnableNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCoverageToColorLocationNV(VkCommandBuffer commandBuffer, uint32_t coverageToColorLocation)
@@ -1574,7 +1653,7 @@ void WINAPI vkCmdSetCoverageToColorLocationNV(VkCommandBuffer commandBuffer, uin
     struct vkCmdSetCoverageToColorLocationNV_params params;
     params.commandBuffer = commandBuffer;
     params.coverageToColorLocation = coverageToColorLocation;
-    UNIX_CALL(vkCmdSetCoverageToColorLocationNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCoverageToColorLocationNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCullMode(VkCommandBuffer commandBuffer, VkCullModeFlags cullMode)
@@ -1582,7 +1661,7 @@ void WINAPI vkCmdSetCullMode(VkCommandBuffer commandBuffer, VkCullModeFlags cull
     struct vkCmdSetCullMode_params params;
     params.commandBuffer = commandBuffer;
     params.cullMode = cullMode;
-    UNIX_CALL(vkCmdSetCullMode, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCullMode, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetCullModeEXT(VkCommandBuffer commandBuffer, VkCullModeFlags cullMode)
@@ -1590,7 +1669,7 @@ void WINAPI vkCmdSetCullModeEXT(VkCommandBuffer commandBuffer, VkCullModeFlags c
     struct vkCmdSetCullModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.cullMode = cullMode;
-    UNIX_CALL(vkCmdSetCullModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetCullModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasConstantFactor, float depthBiasClamp, float depthBiasSlopeFactor)
@@ -1600,7 +1679,7 @@ void WINAPI vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasCons
     params.depthBiasConstantFactor = depthBiasConstantFactor;
     params.depthBiasClamp = depthBiasClamp;
     params.depthBiasSlopeFactor = depthBiasSlopeFactor;
-    UNIX_CALL(vkCmdSetDepthBias, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBias, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBias2EXT(VkCommandBuffer commandBuffer, const VkDepthBiasInfoEXT *pDepthBiasInfo)
@@ -1608,6 +1687,7 @@ void WINAPI vkCmdSetDepthBias2EXT(VkCommandBuffer commandBuffer, const VkDepthBi
     struct vkCmdSetDepthBias2EXT_params params;
     params.commandBuffer = commandBuffer;
     params.pDepthBiasInfo = pDepthBiasInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetDepthBias2EXT, &params);
 }
 
@@ -1616,7 +1696,7 @@ void WINAPI vkCmdSetDepthBiasEnable(VkCommandBuffer commandBuffer, VkBool32 dept
     struct vkCmdSetDepthBiasEnable_params params;
     params.commandBuffer = commandBuffer;
     params.depthBiasEnable = depthBiasEnable;
-    UNIX_CALL(vkCmdSetDepthBiasEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBiasEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBiasEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthBiasEnable)
@@ -1624,7 +1704,7 @@ void WINAPI vkCmdSetDepthBiasEnableEXT(VkCommandBuffer commandBuffer, VkBool32 d
     struct vkCmdSetDepthBiasEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthBiasEnable = depthBiasEnable;
-    UNIX_CALL(vkCmdSetDepthBiasEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBiasEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float minDepthBounds, float maxDepthBounds)
@@ -1633,7 +1713,7 @@ void WINAPI vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float minDepthBou
     params.commandBuffer = commandBuffer;
     params.minDepthBounds = minDepthBounds;
     params.maxDepthBounds = maxDepthBounds;
-    UNIX_CALL(vkCmdSetDepthBounds, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBounds, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBoundsTestEnable(VkCommandBuffer commandBuffer, VkBool32 depthBoundsTestEnable)
@@ -1641,7 +1721,7 @@ void WINAPI vkCmdSetDepthBoundsTestEnable(VkCommandBuffer commandBuffer, VkBool3
     struct vkCmdSetDepthBoundsTestEnable_params params;
     params.commandBuffer = commandBuffer;
     params.depthBoundsTestEnable = depthBoundsTestEnable;
-    UNIX_CALL(vkCmdSetDepthBoundsTestEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBoundsTestEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthBoundsTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthBoundsTestEnable)
@@ -1649,7 +1729,7 @@ void WINAPI vkCmdSetDepthBoundsTestEnableEXT(VkCommandBuffer commandBuffer, VkBo
     struct vkCmdSetDepthBoundsTestEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthBoundsTestEnable = depthBoundsTestEnable;
-    UNIX_CALL(vkCmdSetDepthBoundsTestEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthBoundsTestEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthClampEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthClampEnable)
@@ -1657,7 +1737,7 @@ void WINAPI vkCmdSetDepthClampEnableEXT(VkCommandBuffer commandBuffer, VkBool32
     struct vkCmdSetDepthClampEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthClampEnable = depthClampEnable;
-    UNIX_CALL(vkCmdSetDepthClampEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthClampEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthClipEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthClipEnable)
@@ -1665,7 +1745,7 @@ void WINAPI vkCmdSetDepthClipEnableEXT(VkCommandBuffer commandBuffer, VkBool32 d
     struct vkCmdSetDepthClipEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthClipEnable = depthClipEnable;
-    UNIX_CALL(vkCmdSetDepthClipEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthClipEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthClipNegativeOneToOneEXT(VkCommandBuffer commandBuffer, VkBool32 negativeOneToOne)
@@ -1673,7 +1753,7 @@ void WINAPI vkCmdSetDepthClipNegativeOneToOneEXT(VkCommandBuffer commandBuffer,
     struct vkCmdSetDepthClipNegativeOneToOneEXT_params params;
     params.commandBuffer = commandBuffer;
     params.negativeOneToOne = negativeOneToOne;
-    UNIX_CALL(vkCmdSetDepthClipNegativeOneToOneEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthClipNegativeOneToOneEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthCompareOp(VkCommandBuffer commandBuffer, VkCompareOp depthCompareOp)
@@ -1681,7 +1761,7 @@ void WINAPI vkCmdSetDepthCompareOp(VkCommandBuffer commandBuffer, VkCompareOp de
     struct vkCmdSetDepthCompareOp_params params;
     params.commandBuffer = commandBuffer;
     params.depthCompareOp = depthCompareOp;
-    UNIX_CALL(vkCmdSetDepthCompareOp, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthCompareOp, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthCompareOpEXT(VkCommandBuffer commandBuffer, VkCompareOp depthCompareOp)
@@ -1689,7 +1769,7 @@ void WINAPI vkCmdSetDepthCompareOpEXT(VkCommandBuffer commandBuffer, VkCompareOp
     struct vkCmdSetDepthCompareOpEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthCompareOp = depthCompareOp;
-    UNIX_CALL(vkCmdSetDepthCompareOpEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthCompareOpEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthTestEnable(VkCommandBuffer commandBuffer, VkBool32 depthTestEnable)
@@ -1697,7 +1777,7 @@ void WINAPI vkCmdSetDepthTestEnable(VkCommandBuffer commandBuffer, VkBool32 dept
     struct vkCmdSetDepthTestEnable_params params;
     params.commandBuffer = commandBuffer;
     params.depthTestEnable = depthTestEnable;
-    UNIX_CALL(vkCmdSetDepthTestEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthTestEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthTestEnable)
@@ -1705,7 +1785,7 @@ void WINAPI vkCmdSetDepthTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 d
     struct vkCmdSetDepthTestEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthTestEnable = depthTestEnable;
-    UNIX_CALL(vkCmdSetDepthTestEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthTestEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthWriteEnable(VkCommandBuffer commandBuffer, VkBool32 depthWriteEnable)
@@ -1713,7 +1793,7 @@ void WINAPI vkCmdSetDepthWriteEnable(VkCommandBuffer commandBuffer, VkBool32 dep
     struct vkCmdSetDepthWriteEnable_params params;
     params.commandBuffer = commandBuffer;
     params.depthWriteEnable = depthWriteEnable;
-    UNIX_CALL(vkCmdSetDepthWriteEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthWriteEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDepthWriteEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthWriteEnable)
@@ -1721,7 +1801,7 @@ void WINAPI vkCmdSetDepthWriteEnableEXT(VkCommandBuffer commandBuffer, VkBool32
     struct vkCmdSetDepthWriteEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.depthWriteEnable = depthWriteEnable;
-    UNIX_CALL(vkCmdSetDepthWriteEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDepthWriteEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDescriptorBufferOffsetsEXT(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const uint32_t *pBufferIndices, const VkDeviceSize *pOffsets)
@@ -1734,6 +1814,7 @@ void WINAPI vkCmdSetDescriptorBufferOffsetsEXT(VkCommandBuffer commandBuffer, Vk
     params.setCount = setCount;
     params.pBufferIndices = pBufferIndices;
     params.pOffsets = pOffsets;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetDescriptorBufferOffsetsEXT, &params);
 }
 
@@ -1742,7 +1823,7 @@ void WINAPI vkCmdSetDeviceMask(VkCommandBuffer commandBuffer, uint32_t deviceMas
     struct vkCmdSetDeviceMask_params params;
     params.commandBuffer = commandBuffer;
     params.deviceMask = deviceMask;
-    UNIX_CALL(vkCmdSetDeviceMask, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDeviceMask, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDeviceMaskKHR(VkCommandBuffer commandBuffer, uint32_t deviceMask)
@@ -1750,7 +1831,7 @@ void WINAPI vkCmdSetDeviceMaskKHR(VkCommandBuffer commandBuffer, uint32_t device
     struct vkCmdSetDeviceMaskKHR_params params;
     params.commandBuffer = commandBuffer;
     params.deviceMask = deviceMask;
-    UNIX_CALL(vkCmdSetDeviceMaskKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDeviceMaskKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDiscardRectangleEXT(VkCommandBuffer commandBuffer, uint32_t firstDiscardRectangle, uint32_t discardRectangleCount, const VkRect2D *pDiscardRectangles)
@@ -1760,6 +1841,7 @@ void WINAPI vkCmdSetDiscardRectangleEXT(VkCommandBuffer commandBuffer, uint32_t
     params.firstDiscardRectangle = firstDiscardRectangle;
     params.discardRectangleCount = discardRectangleCount;
     params.pDiscardRectangles = pDiscardRectangles;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetDiscardRectangleEXT, &params);
 }
 
@@ -1768,7 +1850,7 @@ void WINAPI vkCmdSetDiscardRectangleEnableEXT(VkCommandBuffer commandBuffer, VkB
     struct vkCmdSetDiscardRectangleEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.discardRectangleEnable = discardRectangleEnable;
-    UNIX_CALL(vkCmdSetDiscardRectangleEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDiscardRectangleEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetDiscardRectangleModeEXT(VkCommandBuffer commandBuffer, VkDiscardRectangleModeEXT discardRectangleMode)
@@ -1776,7 +1858,7 @@ void WINAPI vkCmdSetDiscardRectangleModeEXT(VkCommandBuffer commandBuffer, VkDis
     struct vkCmdSetDiscardRectangleModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.discardRectangleMode = discardRectangleMode;
-    UNIX_CALL(vkCmdSetDiscardRectangleModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetDiscardRectangleModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags stageMask)
@@ -1785,7 +1867,7 @@ void WINAPI vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipeli
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.stageMask = stageMask;
-    UNIX_CALL(vkCmdSetEvent, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetEvent, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetEvent2(VkCommandBuffer commandBuffer, VkEvent event, const VkDependencyInfo *pDependencyInfo)
@@ -1794,6 +1876,7 @@ void WINAPI vkCmdSetEvent2(VkCommandBuffer commandBuffer, VkEvent event, const V
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.pDependencyInfo = pDependencyInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetEvent2, &params);
 }
 
@@ -1803,6 +1886,7 @@ void WINAPI vkCmdSetEvent2KHR(VkCommandBuffer commandBuffer, VkEvent event, cons
     params.commandBuffer = commandBuffer;
     params.event = event;
     params.pDependencyInfo = pDependencyInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetEvent2KHR, &params);
 }
 
@@ -1813,6 +1897,7 @@ void WINAPI vkCmdSetExclusiveScissorEnableNV(VkCommandBuffer commandBuffer, uint
     params.firstExclusiveScissor = firstExclusiveScissor;
     params.exclusiveScissorCount = exclusiveScissorCount;
     params.pExclusiveScissorEnables = pExclusiveScissorEnables;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetExclusiveScissorEnableNV, &params);
 }
 
@@ -1823,6 +1908,7 @@ void WINAPI vkCmdSetExclusiveScissorNV(VkCommandBuffer commandBuffer, uint32_t f
     params.firstExclusiveScissor = firstExclusiveScissor;
     params.exclusiveScissorCount = exclusiveScissorCount;
     params.pExclusiveScissors = pExclusiveScissors;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetExclusiveScissorNV, &params);
 }
 
@@ -1831,7 +1917,7 @@ void WINAPI vkCmdSetExtraPrimitiveOverestimationSizeEXT(VkCommandBuffer commandB
     struct vkCmdSetExtraPrimitiveOverestimationSizeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.extraPrimitiveOverestimationSize = extraPrimitiveOverestimationSize;
-    UNIX_CALL(vkCmdSetExtraPrimitiveOverestimationSizeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetExtraPrimitiveOverestimationSizeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetFragmentShadingRateEnumNV(VkCommandBuffer commandBuffer, VkFragmentShadingRateNV shadingRate, const VkFragmentShadingRateCombinerOpKHR combinerOps[2])
@@ -1840,6 +1926,7 @@ void WINAPI vkCmdSetFragmentShadingRateEnumNV(VkCommandBuffer commandBuffer, VkF
     params.commandBuffer = commandBuffer;
     params.shadingRate = shadingRate;
     params.combinerOps = combinerOps;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetFragmentShadingRateEnumNV, &params);
 }
 
@@ -1849,6 +1936,7 @@ void WINAPI vkCmdSetFragmentShadingRateKHR(VkCommandBuffer commandBuffer, const
     params.commandBuffer = commandBuffer;
     params.pFragmentSize = pFragmentSize;
     params.combinerOps = combinerOps;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetFragmentShadingRateKHR, &params);
 }
 
@@ -1857,7 +1945,7 @@ void WINAPI vkCmdSetFrontFace(VkCommandBuffer commandBuffer, VkFrontFace frontFa
     struct vkCmdSetFrontFace_params params;
     params.commandBuffer = commandBuffer;
     params.frontFace = frontFace;
-    UNIX_CALL(vkCmdSetFrontFace, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetFrontFace, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetFrontFaceEXT(VkCommandBuffer commandBuffer, VkFrontFace frontFace)
@@ -1865,7 +1953,7 @@ void WINAPI vkCmdSetFrontFaceEXT(VkCommandBuffer commandBuffer, VkFrontFace fron
     struct vkCmdSetFrontFaceEXT_params params;
     params.commandBuffer = commandBuffer;
     params.frontFace = frontFace;
-    UNIX_CALL(vkCmdSetFrontFaceEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetFrontFaceEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLineRasterizationModeEXT(VkCommandBuffer commandBuffer, VkLineRasterizationModeEXT lineRasterizationMode)
@@ -1873,7 +1961,7 @@ void WINAPI vkCmdSetLineRasterizationModeEXT(VkCommandBuffer commandBuffer, VkLi
     struct vkCmdSetLineRasterizationModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.lineRasterizationMode = lineRasterizationMode;
-    UNIX_CALL(vkCmdSetLineRasterizationModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLineRasterizationModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLineStippleEXT(VkCommandBuffer commandBuffer, uint32_t lineStippleFactor, uint16_t lineStipplePattern)
@@ -1882,7 +1970,7 @@ void WINAPI vkCmdSetLineStippleEXT(VkCommandBuffer commandBuffer, uint32_t lineS
     params.commandBuffer = commandBuffer;
     params.lineStippleFactor = lineStippleFactor;
     params.lineStipplePattern = lineStipplePattern;
-    UNIX_CALL(vkCmdSetLineStippleEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLineStippleEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLineStippleEnableEXT(VkCommandBuffer commandBuffer, VkBool32 stippledLineEnable)
@@ -1890,7 +1978,7 @@ void WINAPI vkCmdSetLineStippleEnableEXT(VkCommandBuffer commandBuffer, VkBool32
     struct vkCmdSetLineStippleEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.stippledLineEnable = stippledLineEnable;
-    UNIX_CALL(vkCmdSetLineStippleEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLineStippleEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLineWidth(VkCommandBuffer commandBuffer, float lineWidth)
@@ -1898,7 +1986,7 @@ void WINAPI vkCmdSetLineWidth(VkCommandBuffer commandBuffer, float lineWidth)
     struct vkCmdSetLineWidth_params params;
     params.commandBuffer = commandBuffer;
     params.lineWidth = lineWidth;
-    UNIX_CALL(vkCmdSetLineWidth, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLineWidth, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLogicOpEXT(VkCommandBuffer commandBuffer, VkLogicOp logicOp)
@@ -1906,7 +1994,7 @@ void WINAPI vkCmdSetLogicOpEXT(VkCommandBuffer commandBuffer, VkLogicOp logicOp)
     struct vkCmdSetLogicOpEXT_params params;
     params.commandBuffer = commandBuffer;
     params.logicOp = logicOp;
-    UNIX_CALL(vkCmdSetLogicOpEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLogicOpEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetLogicOpEnableEXT(VkCommandBuffer commandBuffer, VkBool32 logicOpEnable)
@@ -1914,7 +2002,7 @@ void WINAPI vkCmdSetLogicOpEnableEXT(VkCommandBuffer commandBuffer, VkBool32 log
     struct vkCmdSetLogicOpEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.logicOpEnable = logicOpEnable;
-    UNIX_CALL(vkCmdSetLogicOpEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetLogicOpEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetPatchControlPointsEXT(VkCommandBuffer commandBuffer, uint32_t patchControlPoints)
@@ -1922,7 +2010,7 @@ void WINAPI vkCmdSetPatchControlPointsEXT(VkCommandBuffer commandBuffer, uint32_
     struct vkCmdSetPatchControlPointsEXT_params params;
     params.commandBuffer = commandBuffer;
     params.patchControlPoints = patchControlPoints;
-    UNIX_CALL(vkCmdSetPatchControlPointsEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPatchControlPointsEXT, &params, sizeof(params));
 }
 
 VkResult WINAPI vkCmdSetPerformanceMarkerINTEL(VkCommandBuffer commandBuffer, const VkPerformanceMarkerInfoINTEL *pMarkerInfo)
@@ -1931,6 +2019,7 @@ VkResult WINAPI vkCmdSetPerformanceMarkerINTEL(VkCommandBuffer commandBuffer, co
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
     params.pMarkerInfo = pMarkerInfo;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkCmdSetPerformanceMarkerINTEL, &params);
     assert(!status && "vkCmdSetPerformanceMarkerINTEL");
     return params.result;
@@ -1942,6 +2031,7 @@ VkResult WINAPI vkCmdSetPerformanceOverrideINTEL(VkCommandBuffer commandBuffer,
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
     params.pOverrideInfo = pOverrideInfo;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkCmdSetPerformanceOverrideINTEL, &params);
     assert(!status && "vkCmdSetPerformanceOverrideINTEL");
     return params.result;
@@ -1953,6 +2043,7 @@ VkResult WINAPI vkCmdSetPerformanceStreamMarkerINTEL(VkCommandBuffer commandBuff
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
     params.pMarkerInfo = pMarkerInfo;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkCmdSetPerformanceStreamMarkerINTEL, &params);
     assert(!status && "vkCmdSetPerformanceStreamMarkerINTEL");
     return params.result;
@@ -1963,7 +2054,7 @@ void WINAPI vkCmdSetPolygonModeEXT(VkCommandBuffer commandBuffer, VkPolygonMode
     struct vkCmdSetPolygonModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.polygonMode = polygonMode;
-    UNIX_CALL(vkCmdSetPolygonModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPolygonModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetPrimitiveRestartEnable(VkCommandBuffer commandBuffer, VkBool32 primitiveRestartEnable)
@@ -1971,7 +2062,7 @@ void WINAPI vkCmdSetPrimitiveRestartEnable(VkCommandBuffer commandBuffer, VkBool
     struct vkCmdSetPrimitiveRestartEnable_params params;
     params.commandBuffer = commandBuffer;
     params.primitiveRestartEnable = primitiveRestartEnable;
-    UNIX_CALL(vkCmdSetPrimitiveRestartEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPrimitiveRestartEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetPrimitiveRestartEnableEXT(VkCommandBuffer commandBuffer, VkBool32 primitiveRestartEnable)
@@ -1979,7 +2070,7 @@ void WINAPI vkCmdSetPrimitiveRestartEnableEXT(VkCommandBuffer commandBuffer, VkB
     struct vkCmdSetPrimitiveRestartEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.primitiveRestartEnable = primitiveRestartEnable;
-    UNIX_CALL(vkCmdSetPrimitiveRestartEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPrimitiveRestartEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetPrimitiveTopology(VkCommandBuffer commandBuffer, VkPrimitiveTopology primitiveTopology)
@@ -1987,7 +2078,7 @@ void WINAPI vkCmdSetPrimitiveTopology(VkCommandBuffer commandBuffer, VkPrimitive
     struct vkCmdSetPrimitiveTopology_params params;
     params.commandBuffer = commandBuffer;
     params.primitiveTopology = primitiveTopology;
-    UNIX_CALL(vkCmdSetPrimitiveTopology, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPrimitiveTopology, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetPrimitiveTopologyEXT(VkCommandBuffer commandBuffer, VkPrimitiveTopology primitiveTopology)
@@ -1995,7 +2086,7 @@ void WINAPI vkCmdSetPrimitiveTopologyEXT(VkCommandBuffer commandBuffer, VkPrimit
     struct vkCmdSetPrimitiveTopologyEXT_params params;
     params.commandBuffer = commandBuffer;
     params.primitiveTopology = primitiveTopology;
-    UNIX_CALL(vkCmdSetPrimitiveTopologyEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetPrimitiveTopologyEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetProvokingVertexModeEXT(VkCommandBuffer commandBuffer, VkProvokingVertexModeEXT provokingVertexMode)
@@ -2003,7 +2094,7 @@ void WINAPI vkCmdSetProvokingVertexModeEXT(VkCommandBuffer commandBuffer, VkProv
     struct vkCmdSetProvokingVertexModeEXT_params params;
     params.commandBuffer = commandBuffer;
     params.provokingVertexMode = provokingVertexMode;
-    UNIX_CALL(vkCmdSetProvokingVertexModeEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetProvokingVertexModeEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRasterizationSamplesEXT(VkCommandBuffer commandBuffer, VkSampleCountFlagBits rasterizationSamples)
@@ -2011,7 +2102,7 @@ void WINAPI vkCmdSetRasterizationSamplesEXT(VkCommandBuffer commandBuffer, VkSam
     struct vkCmdSetRasterizationSamplesEXT_params params;
     params.commandBuffer = commandBuffer;
     params.rasterizationSamples = rasterizationSamples;
-    UNIX_CALL(vkCmdSetRasterizationSamplesEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRasterizationSamplesEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRasterizationStreamEXT(VkCommandBuffer commandBuffer, uint32_t rasterizationStream)
@@ -2019,7 +2110,7 @@ void WINAPI vkCmdSetRasterizationStreamEXT(VkCommandBuffer commandBuffer, uint32
     struct vkCmdSetRasterizationStreamEXT_params params;
     params.commandBuffer = commandBuffer;
     params.rasterizationStream = rasterizationStream;
-    UNIX_CALL(vkCmdSetRasterizationStreamEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRasterizationStreamEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRasterizerDiscardEnable(VkCommandBuffer commandBuffer, VkBool32 rasterizerDiscardEnable)
@@ -2027,7 +2118,7 @@ void WINAPI vkCmdSetRasterizerDiscardEnable(VkCommandBuffer commandBuffer, VkBoo
     struct vkCmdSetRasterizerDiscardEnable_params params;
     params.commandBuffer = commandBuffer;
     params.rasterizerDiscardEnable = rasterizerDiscardEnable;
-    UNIX_CALL(vkCmdSetRasterizerDiscardEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRasterizerDiscardEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRasterizerDiscardEnableEXT(VkCommandBuffer commandBuffer, VkBool32 rasterizerDiscardEnable)
@@ -2035,7 +2126,7 @@ void WINAPI vkCmdSetRasterizerDiscardEnableEXT(VkCommandBuffer commandBuffer, Vk
     struct vkCmdSetRasterizerDiscardEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.rasterizerDiscardEnable = rasterizerDiscardEnable;
-    UNIX_CALL(vkCmdSetRasterizerDiscardEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRasterizerDiscardEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRayTracingPipelineStackSizeKHR(VkCommandBuffer commandBuffer, uint32_t pipelineStackSize)
@@ -2043,7 +2134,7 @@ void WINAPI vkCmdSetRayTracingPipelineStackSizeKHR(VkCommandBuffer commandBuffer
     struct vkCmdSetRayTracingPipelineStackSizeKHR_params params;
     params.commandBuffer = commandBuffer;
     params.pipelineStackSize = pipelineStackSize;
-    UNIX_CALL(vkCmdSetRayTracingPipelineStackSizeKHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRayTracingPipelineStackSizeKHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetRepresentativeFragmentTestEnableNV(VkCommandBuffer commandBuffer, VkBool32 representativeFragmentTestEnable)
@@ -2051,7 +2142,7 @@ void WINAPI vkCmdSetRepresentativeFragmentTestEnableNV(VkCommandBuffer commandBu
     struct vkCmdSetRepresentativeFragmentTestEnableNV_params params;
     params.commandBuffer = commandBuffer;
     params.representativeFragmentTestEnable = representativeFragmentTestEnable;
-    UNIX_CALL(vkCmdSetRepresentativeFragmentTestEnableNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetRepresentativeFragmentTestEnableNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetSampleLocationsEXT(VkCommandBuffer commandBuffer, const VkSampleLocationsInfoEXT *pSampleLocationsInfo)
@@ -2059,6 +2150,7 @@ void WINAPI vkCmdSetSampleLocationsEXT(VkCommandBuffer commandBuffer, const VkSa
     struct vkCmdSetSampleLocationsEXT_params params;
     params.commandBuffer = commandBuffer;
     params.pSampleLocationsInfo = pSampleLocationsInfo;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetSampleLocationsEXT, &params);
 }
 
@@ -2067,7 +2159,7 @@ void WINAPI vkCmdSetSampleLocationsEnableEXT(VkCommandBuffer commandBuffer, VkBo
     struct vkCmdSetSampleLocationsEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.sampleLocationsEnable = sampleLocationsEnable;
-    UNIX_CALL(vkCmdSetSampleLocationsEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetSampleLocationsEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetSampleMaskEXT(VkCommandBuffer commandBuffer, VkSampleCountFlagBits samples, const VkSampleMask *pSampleMask)
@@ -2076,6 +2168,7 @@ void WINAPI vkCmdSetSampleMaskEXT(VkCommandBuffer commandBuffer, VkSampleCountFl
     params.commandBuffer = commandBuffer;
     params.samples = samples;
     params.pSampleMask = pSampleMask;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetSampleMaskEXT, &params);
 }
 
@@ -2086,6 +2179,7 @@ void WINAPI vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor
     params.firstScissor = firstScissor;
     params.scissorCount = scissorCount;
     params.pScissors = pScissors;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetScissor, &params);
 }
 
@@ -2095,6 +2189,7 @@ void WINAPI vkCmdSetScissorWithCount(VkCommandBuffer commandBuffer, uint32_t sci
     params.commandBuffer = commandBuffer;
     params.scissorCount = scissorCount;
     params.pScissors = pScissors;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetScissorWithCount, &params);
 }
 
@@ -2104,6 +2199,7 @@ void WINAPI vkCmdSetScissorWithCountEXT(VkCommandBuffer commandBuffer, uint32_t
     params.commandBuffer = commandBuffer;
     params.scissorCount = scissorCount;
     params.pScissors = pScissors;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetScissorWithCountEXT, &params);
 }
 
@@ -2112,7 +2208,7 @@ void WINAPI vkCmdSetShadingRateImageEnableNV(VkCommandBuffer commandBuffer, VkBo
     struct vkCmdSetShadingRateImageEnableNV_params params;
     params.commandBuffer = commandBuffer;
     params.shadingRateImageEnable = shadingRateImageEnable;
-    UNIX_CALL(vkCmdSetShadingRateImageEnableNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetShadingRateImageEnableNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t compareMask)
@@ -2121,7 +2217,7 @@ void WINAPI vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer, VkStencilF
     params.commandBuffer = commandBuffer;
     params.faceMask = faceMask;
     params.compareMask = compareMask;
-    UNIX_CALL(vkCmdSetStencilCompareMask, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilCompareMask, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilOp(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, VkStencilOp failOp, VkStencilOp passOp, VkStencilOp depthFailOp, VkCompareOp compareOp)
@@ -2133,7 +2229,7 @@ void WINAPI vkCmdSetStencilOp(VkCommandBuffer commandBuffer, VkStencilFaceFlags
     params.passOp = passOp;
     params.depthFailOp = depthFailOp;
     params.compareOp = compareOp;
-    UNIX_CALL(vkCmdSetStencilOp, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilOp, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilOpEXT(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, VkStencilOp failOp, VkStencilOp passOp, VkStencilOp depthFailOp, VkCompareOp compareOp)
@@ -2145,7 +2241,7 @@ void WINAPI vkCmdSetStencilOpEXT(VkCommandBuffer commandBuffer, VkStencilFaceFla
     params.passOp = passOp;
     params.depthFailOp = depthFailOp;
     params.compareOp = compareOp;
-    UNIX_CALL(vkCmdSetStencilOpEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilOpEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilReference(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t reference)
@@ -2154,7 +2250,7 @@ void WINAPI vkCmdSetStencilReference(VkCommandBuffer commandBuffer, VkStencilFac
     params.commandBuffer = commandBuffer;
     params.faceMask = faceMask;
     params.reference = reference;
-    UNIX_CALL(vkCmdSetStencilReference, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilReference, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilTestEnable(VkCommandBuffer commandBuffer, VkBool32 stencilTestEnable)
@@ -2162,7 +2258,7 @@ void WINAPI vkCmdSetStencilTestEnable(VkCommandBuffer commandBuffer, VkBool32 st
     struct vkCmdSetStencilTestEnable_params params;
     params.commandBuffer = commandBuffer;
     params.stencilTestEnable = stencilTestEnable;
-    UNIX_CALL(vkCmdSetStencilTestEnable, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilTestEnable, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 stencilTestEnable)
@@ -2170,7 +2266,7 @@ void WINAPI vkCmdSetStencilTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32
     struct vkCmdSetStencilTestEnableEXT_params params;
     params.commandBuffer = commandBuffer;
     params.stencilTestEnable = stencilTestEnable;
-    UNIX_CALL(vkCmdSetStencilTestEnableEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilTestEnableEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t writeMask)
@@ -2179,7 +2275,7 @@ void WINAPI vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer, VkStencilFac
     params.commandBuffer = commandBuffer;
     params.faceMask = faceMask;
     params.writeMask = writeMask;
-    UNIX_CALL(vkCmdSetStencilWriteMask, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetStencilWriteMask, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetTessellationDomainOriginEXT(VkCommandBuffer commandBuffer, VkTessellationDomainOrigin domainOrigin)
@@ -2187,7 +2283,7 @@ void WINAPI vkCmdSetTessellationDomainOriginEXT(VkCommandBuffer commandBuffer, V
     struct vkCmdSetTessellationDomainOriginEXT_params params;
     params.commandBuffer = commandBuffer;
     params.domainOrigin = domainOrigin;
-    UNIX_CALL(vkCmdSetTessellationDomainOriginEXT, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetTessellationDomainOriginEXT, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetVertexInputEXT(VkCommandBuffer commandBuffer, uint32_t vertexBindingDescriptionCount, const VkVertexInputBindingDescription2EXT *pVertexBindingDescriptions, uint32_t vertexAttributeDescriptionCount, const VkVertexInputAttributeDescription2EXT *pVertexAttributeDescriptions)
@@ -2198,6 +2294,7 @@ void WINAPI vkCmdSetVertexInputEXT(VkCommandBuffer commandBuffer, uint32_t verte
     params.pVertexBindingDescriptions = pVertexBindingDescriptions;
     params.vertexAttributeDescriptionCount = vertexAttributeDescriptionCount;
     params.pVertexAttributeDescriptions = pVertexAttributeDescriptions;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetVertexInputEXT, &params);
 }
 
@@ -2208,6 +2305,7 @@ void WINAPI vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewpo
     params.firstViewport = firstViewport;
     params.viewportCount = viewportCount;
     params.pViewports = pViewports;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewport, &params);
 }
 
@@ -2218,6 +2316,7 @@ void WINAPI vkCmdSetViewportShadingRatePaletteNV(VkCommandBuffer commandBuffer,
     params.firstViewport = firstViewport;
     params.viewportCount = viewportCount;
     params.pShadingRatePalettes = pShadingRatePalettes;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewportShadingRatePaletteNV, &params);
 }
 
@@ -2228,6 +2327,7 @@ void WINAPI vkCmdSetViewportSwizzleNV(VkCommandBuffer commandBuffer, uint32_t fi
     params.firstViewport = firstViewport;
     params.viewportCount = viewportCount;
     params.pViewportSwizzles = pViewportSwizzles;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewportSwizzleNV, &params);
 }
 
@@ -2236,7 +2336,7 @@ void WINAPI vkCmdSetViewportWScalingEnableNV(VkCommandBuffer commandBuffer, VkBo
     struct vkCmdSetViewportWScalingEnableNV_params params;
     params.commandBuffer = commandBuffer;
     params.viewportWScalingEnable = viewportWScalingEnable;
-    UNIX_CALL(vkCmdSetViewportWScalingEnableNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSetViewportWScalingEnableNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdSetViewportWScalingNV(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const VkViewportWScalingNV *pViewportWScalings)
@@ -2246,6 +2346,7 @@ void WINAPI vkCmdSetViewportWScalingNV(VkCommandBuffer commandBuffer, uint32_t f
     params.firstViewport = firstViewport;
     params.viewportCount = viewportCount;
     params.pViewportWScalings = pViewportWScalings;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewportWScalingNV, &params);
 }
 
@@ -2255,6 +2356,7 @@ void WINAPI vkCmdSetViewportWithCount(VkCommandBuffer commandBuffer, uint32_t vi
     params.commandBuffer = commandBuffer;
     params.viewportCount = viewportCount;
     params.pViewports = pViewports;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewportWithCount, &params);
 }
 
@@ -2264,6 +2366,7 @@ void WINAPI vkCmdSetViewportWithCountEXT(VkCommandBuffer commandBuffer, uint32_t
     params.commandBuffer = commandBuffer;
     params.viewportCount = viewportCount;
     params.pViewports = pViewports;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdSetViewportWithCountEXT, &params);
 }
 
@@ -2271,7 +2374,7 @@ void WINAPI vkCmdSubpassShadingHUAWEI(VkCommandBuffer commandBuffer)
 {
     struct vkCmdSubpassShadingHUAWEI_params params;
     params.commandBuffer = commandBuffer;
-    UNIX_CALL(vkCmdSubpassShadingHUAWEI, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdSubpassShadingHUAWEI, &params, sizeof(params));
 }
 
 void WINAPI vkCmdTraceRaysIndirect2KHR(VkCommandBuffer commandBuffer, VkDeviceAddress indirectDeviceAddress)
@@ -2279,7 +2382,7 @@ void WINAPI vkCmdTraceRaysIndirect2KHR(VkCommandBuffer commandBuffer, VkDeviceAd
     struct vkCmdTraceRaysIndirect2KHR_params params;
     params.commandBuffer = commandBuffer;
     params.indirectDeviceAddress = indirectDeviceAddress;
-    UNIX_CALL(vkCmdTraceRaysIndirect2KHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdTraceRaysIndirect2KHR, &params, sizeof(params));
 }
 
 void WINAPI vkCmdTraceRaysIndirectKHR(VkCommandBuffer commandBuffer, const VkStridedDeviceAddressRegionKHR *pRaygenShaderBindingTable, const VkStridedDeviceAddressRegionKHR *pMissShaderBindingTable, const VkStridedDeviceAddressRegionKHR *pHitShaderBindingTable, const VkStridedDeviceAddressRegionKHR *pCallableShaderBindingTable, VkDeviceAddress indirectDeviceAddress)
@@ -2291,6 +2394,7 @@ void WINAPI vkCmdTraceRaysIndirectKHR(VkCommandBuffer commandBuffer, const VkStr
     params.pHitShaderBindingTable = pHitShaderBindingTable;
     params.pCallableShaderBindingTable = pCallableShaderBindingTable;
     params.indirectDeviceAddress = indirectDeviceAddress;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdTraceRaysIndirectKHR, &params);
 }
 
@@ -2305,6 +2409,7 @@ void WINAPI vkCmdTraceRaysKHR(VkCommandBuffer commandBuffer, const VkStridedDevi
     params.width = width;
     params.height = height;
     params.depth = depth;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdTraceRaysKHR, &params);
 }
 
@@ -2326,7 +2431,7 @@ void WINAPI vkCmdTraceRaysNV(VkCommandBuffer commandBuffer, VkBuffer raygenShade
     params.width = width;
     params.height = height;
     params.depth = depth;
-    UNIX_CALL(vkCmdTraceRaysNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdTraceRaysNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdUpdateBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize dataSize, const void *pData)
@@ -2337,6 +2442,7 @@ void WINAPI vkCmdUpdateBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer,
     params.dstOffset = dstOffset;
     params.dataSize = dataSize;
     params.pData = pData;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdUpdateBuffer, &params);
 }
 
@@ -2346,7 +2452,7 @@ void WINAPI vkCmdUpdatePipelineIndirectBufferNV(VkCommandBuffer commandBuffer, V
     params.commandBuffer = commandBuffer;
     params.pipelineBindPoint = pipelineBindPoint;
     params.pipeline = pipeline;
-    UNIX_CALL(vkCmdUpdatePipelineIndirectBufferNV, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdUpdatePipelineIndirectBufferNV, &params, sizeof(params));
 }
 
 void WINAPI vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEvent *pEvents, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, uint32_t memoryBarrierCount, const VkMemoryBarrier *pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const VkBufferMemoryBarrier *pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier *pImageMemoryBarriers)
@@ -2363,6 +2469,7 @@ void WINAPI vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount,
     params.pBufferMemoryBarriers = pBufferMemoryBarriers;
     params.imageMemoryBarrierCount = imageMemoryBarrierCount;
     params.pImageMemoryBarriers = pImageMemoryBarriers;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWaitEvents, &params);
 }
 
@@ -2373,6 +2480,7 @@ void WINAPI vkCmdWaitEvents2(VkCommandBuffer commandBuffer, uint32_t eventCount,
     params.eventCount = eventCount;
     params.pEvents = pEvents;
     params.pDependencyInfos = pDependencyInfos;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWaitEvents2, &params);
 }
 
@@ -2383,6 +2491,7 @@ void WINAPI vkCmdWaitEvents2KHR(VkCommandBuffer commandBuffer, uint32_t eventCou
     params.eventCount = eventCount;
     params.pEvents = pEvents;
     params.pDependencyInfos = pDependencyInfos;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWaitEvents2KHR, &params);
 }
 
@@ -2395,6 +2504,7 @@ void WINAPI vkCmdWriteAccelerationStructuresPropertiesKHR(VkCommandBuffer comman
     params.queryType = queryType;
     params.queryPool = queryPool;
     params.firstQuery = firstQuery;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWriteAccelerationStructuresPropertiesKHR, &params);
 }
 
@@ -2407,6 +2517,7 @@ void WINAPI vkCmdWriteAccelerationStructuresPropertiesNV(VkCommandBuffer command
     params.queryType = queryType;
     params.queryPool = queryPool;
     params.firstQuery = firstQuery;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWriteAccelerationStructuresPropertiesNV, &params);
 }
 
@@ -2418,7 +2529,7 @@ void WINAPI vkCmdWriteBufferMarker2AMD(VkCommandBuffer commandBuffer, VkPipeline
     params.dstBuffer = dstBuffer;
     params.dstOffset = dstOffset;
     params.marker = marker;
-    UNIX_CALL(vkCmdWriteBufferMarker2AMD, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdWriteBufferMarker2AMD, &params, sizeof(params));
 }
 
 void WINAPI vkCmdWriteBufferMarkerAMD(VkCommandBuffer commandBuffer, VkPipelineStageFlagBits pipelineStage, VkBuffer dstBuffer, VkDeviceSize dstOffset, uint32_t marker)
@@ -2429,7 +2540,7 @@ void WINAPI vkCmdWriteBufferMarkerAMD(VkCommandBuffer commandBuffer, VkPipelineS
     params.dstBuffer = dstBuffer;
     params.dstOffset = dstOffset;
     params.marker = marker;
-    UNIX_CALL(vkCmdWriteBufferMarkerAMD, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdWriteBufferMarkerAMD, &params, sizeof(params));
 }
 
 void WINAPI vkCmdWriteMicromapsPropertiesEXT(VkCommandBuffer commandBuffer, uint32_t micromapCount, const VkMicromapEXT *pMicromaps, VkQueryType queryType, VkQueryPool queryPool, uint32_t firstQuery)
@@ -2441,6 +2552,7 @@ void WINAPI vkCmdWriteMicromapsPropertiesEXT(VkCommandBuffer commandBuffer, uint
     params.queryType = queryType;
     params.queryPool = queryPool;
     params.firstQuery = firstQuery;
+    command_buffer_flush(commandBuffer);
     UNIX_CALL(vkCmdWriteMicromapsPropertiesEXT, &params);
 }
 
@@ -2451,7 +2563,7 @@ void WINAPI vkCmdWriteTimestamp(VkCommandBuffer commandBuffer, VkPipelineStageFl
     params.pipelineStage = pipelineStage;
     params.queryPool = queryPool;
     params.query = query;
-    UNIX_CALL(vkCmdWriteTimestamp, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdWriteTimestamp, &params, sizeof(params));
 }
 
 void WINAPI vkCmdWriteTimestamp2(VkCommandBuffer commandBuffer, VkPipelineStageFlags2 stage, VkQueryPool queryPool, uint32_t query)
@@ -2461,7 +2573,7 @@ void WINAPI vkCmdWriteTimestamp2(VkCommandBuffer commandBuffer, VkPipelineStageF
     params.stage = stage;
     params.queryPool = queryPool;
     params.query = query;
-    UNIX_CALL(vkCmdWriteTimestamp2, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdWriteTimestamp2, &params, sizeof(params));
 }
 
 void WINAPI vkCmdWriteTimestamp2KHR(VkCommandBuffer commandBuffer, VkPipelineStageFlags2 stage, VkQueryPool queryPool, uint32_t query)
@@ -2471,7 +2583,7 @@ void WINAPI vkCmdWriteTimestamp2KHR(VkCommandBuffer commandBuffer, VkPipelineSta
     params.stage = stage;
     params.queryPool = queryPool;
     params.query = query;
-    UNIX_CALL(vkCmdWriteTimestamp2KHR, &params);
+    command_buffer_record_call(commandBuffer, unix_vkCmdWriteTimestamp2KHR, &params, sizeof(params));
 }
 
 VkResult WINAPI vkCompileDeferredNV(VkDevice device, VkPipeline pipeline, uint32_t shader)
@@ -3593,6 +3705,7 @@ VkResult WINAPI vkEndCommandBuffer(VkCommandBuffer commandBuffer)
     struct vkEndCommandBuffer_params params;
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkEndCommandBuffer, &params);
     assert(!status && "vkEndCommandBuffer");
     return params.result;
@@ -5649,23 +5762,12 @@ VkResult WINAPI vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBuf
     NTSTATUS status;
     params.commandBuffer = commandBuffer;
     params.flags = flags;
+    command_buffer_flush(commandBuffer);
     status = UNIX_CALL(vkResetCommandBuffer, &params);
     assert(!status && "vkResetCommandBuffer");
     return params.result;
 }
 
-VkResult WINAPI vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolResetFlags flags)
-{
-    struct vkResetCommandPool_params params;
-    NTSTATUS status;
-    params.device = device;
-    params.commandPool = commandPool;
-    params.flags = flags;
-    status = UNIX_CALL(vkResetCommandPool, &params);
-    assert(!status && "vkResetCommandPool");
-    return params.result;
-}
-
 VkResult WINAPI vkResetDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags)
 {
     struct vkResetDescriptorPool_params params;
@@ -17,6 +17,7 @@ enum unix_call
     unix_init,
     unix_is_available_instance_function,
     unix_is_available_device_function,
+    unix_execute_command_stream,
     unix_vkAcquireNextImage2KHR,
     unix_vkAcquireNextImageKHR,
     unix_vkAcquirePerformanceConfigurationINTEL,
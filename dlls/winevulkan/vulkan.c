@@ -693,8 +693,93 @@ static void wine_vk_device_free(struct wine_device *device)
     free(device);
 }
 
+static pthread_key_t conversion_arena_key;
+
+#define CONVERSION_ARENA_GRANULARITY 0x10000
+
+static void free_conversion_arena(void *data)
+{
+    struct conversion_arena *arena = data;
+
+    free(arena->base);
+    free(arena);
+}
+
+static struct conversion_arena *get_conversion_arena(void)
+{
+    struct conversion_arena *arena;
+
+    if ((arena = pthread_getspecific(conversion_arena_key)))
+        return arena;
+    if (!(arena = calloc(1, sizeof(*arena))))
+        return NULL;
+    pthread_setspecific(conversion_arena_key, arena);
+    return arena;
+}
+
+void *conversion_context_alloc_slow(struct conversion_context *pool, size_t size)
+{
+    struct conversion_arena *arena = pool->arena;
+    struct list *entry;
+    size_t aligned;
+
+    if (!arena && !pool->persistent && (arena = get_conversion_arena()))
+    {
+        /* Conversion contexts nest strictly within a thread, so the arena is
+         * used as a stack and rewound when the context is freed. */
+        pool->arena = arena;
+        pool->arena_mark = arena->used;
+    }
+
+    if (arena)
+    {
+        aligned = (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
+        if (arena->used + aligned <= arena->size)
+        {
+            void *ret = arena->base + arena->used;
+            arena->used += aligned;
+            return ret;
+        }
+        /* The arena can't move while in use; remember how large it needs to
+         * be and grow it once it is idle again. */
+        arena->high_water = max(arena->high_water, arena->used + aligned);
+    }
+
+    if (!(entry = malloc(sizeof(*entry) + size)))
+        return NULL;
+    list_add_tail(&pool->alloc_entries, entry);
+    return entry + 1;
+}
+
+void conversion_arena_release(struct conversion_context *pool)
+{
+    struct conversion_arena *arena = pool->arena;
+    size_t size;
+    char *base;
+
+    arena->used = pool->arena_mark;
+    pool->arena = NULL;
+
+    if (arena->used || arena->high_water <= arena->size)
+        return;
+
+    size = (arena->high_water + CONVERSION_ARENA_GRANULARITY - 1) & ~(size_t)(CONVERSION_ARENA_GRANULARITY - 1);
+    if (!(base = malloc(size)))
+        return;
+    TRACE("Growing conversion arena to %#zx bytes.\n", size);
+    free(arena->base);
+    arena->base = base;
+    arena->size = size;
+}
+
 NTSTATUS init_vulkan(void *args)
 {
+    if (pthread_key_create(&conversion_arena_key, free_conversion_arena))
+    {
+        ERR("Failed to allocate conversion arena key.\n");
+        return STATUS_UNSUCCESSFUL;
+    }
+
     vk_funcs = __wine_get_vulkan_driver(WINE_VULKAN_DRIVER_VERSION);
     if (!vk_funcs)
     {
@@ -3825,7 +3910,7 @@ VkResult wine_vkCreateDeferredOperationKHR(VkDevice                     handle,
         return res;
     }
 
-    init_conversion_context(&object->ctx);
+    init_persistent_conversion_context(&object->ctx);
 
     WINE_VK_ADD_NON_DISPATCHABLE_MAPPING(device->phys_dev->instance, object, object->deferred_operation, object);
     *deferredOperation = wine_deferred_operation_to_handle(object);
@@ -4352,8 +4437,47 @@ NTSTATUS vk_is_available_device_function(void *arg)
     return !!vk_funcs->p_vkGetDeviceProcAddr(device->device, params->name);
 }
 
+NTSTATUS vk_execute_command_stream(void *arg)
+{
+    struct execute_command_stream_params *params = arg;
+    const struct command_stream_entry *entry;
+    UINT32 offset;
+
+    for (offset = 0; offset < params->size; offset += entry->size)
+    {
+        entry = (const struct command_stream_entry *)(params->stream + offset);
+        __wine_unix_call_funcs[entry->code]((void *)entry->params);
+    }
+
+    return STATUS_SUCCESS;
+}
+
 #endif /* _WIN64 */
 
+NTSTATUS vk_execute_command_stream32(void *arg)
+{
+    struct
+    {
+        UINT32 stream;
+        UINT32 size;
+    } *params = arg;
+    const BYTE *stream = UlongToPtr(params->stream);
+    const struct command_stream_entry *entry;
+    UINT32 offset;
+
+    for (offset = 0; offset < params->size; offset += entry->size)
+    {
+        entry = (const struct command_stream_entry *)(stream + offset);
+#ifdef _WIN64
+        __wine_unix_call_wow64_funcs[entry->code]((void *)entry->params);
+#else
+        __wine_unix_call_funcs[entry->code]((void *)entry->params);
+#endif
+    }
+
+    return STATUS_SUCCESS;
+}
+
 NTSTATUS vk_is_available_instance_function32(void *arg)
 {
     struct
@@ -5553,7 +5677,10 @@ VkResult wine_vkQueueSubmit(VkQueue queue_handle, uint32_t submit_count, const V
     init_conversion_context(&ctx);
     MEMDUP(&ctx, submits, submits_orig, submit_count);
     if ((ret = process_keyed_mutexes(&ctx, device, submit_count, submits_win_ptr, sizeof(*submits), &km_counts, &km_infos)))
+    {
+        free_conversion_context(&ctx);
         return ret;
+    }
 
     for (i = 0; i < submit_count; ++i)
     {
@@ -5652,7 +5779,10 @@ static VkResult vk_queue_submit_2(VkQueue queue_handle, uint32_t submit_count, c
     init_conversion_context(&ctx);
     MEMDUP(&ctx, submits, submits_orig, submit_count);
     if ((ret = process_keyed_mutexes(&ctx, device, submit_count, submits_win_ptr, sizeof(*submits), &km_counts, &km_infos)))
+    {
+        free_conversion_context(&ctx);
         return ret;
+    }
     for (i = 0; i < submit_count; ++i)
     {
         duplicate_array_for_unwrapping(&ctx, (void **)&submits[i].pWaitSemaphoreInfos,
@@ -22,6 +22,7 @@
 
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
@@ -108,6 +109,9 @@ struct VkCommandBuffer_T
 {
     struct wine_vk_base base;
     struct list pool_link;
+    /* Calls recorded by command_buffer_record_call(), not yet executed. */
+    BYTE *stream;
+    UINT32 stream_size;
 };
 
 struct vulkan_func
@@ -158,6 +162,23 @@ struct is_available_device_function_params
     const char *name;
 };
 
+#define COMMAND_STREAM_SIZE 0x4000
+
+/* Each entry holds the parameters of a Unix call, replayed in order by
+ * vk_execute_command_stream(). */
+struct command_stream_entry
+{
+    UINT32 code;
+    UINT32 size;
+    BYTE params[1];
+};
+
+struct execute_command_stream_params
+{
+    const BYTE *stream;
+    UINT32 size;
+};
+
 #define wine_vk_find_struct(s, t) wine_vk_find_struct_((void *)s, VK_STRUCTURE_TYPE_##t)
 static inline void *wine_vk_find_struct_(void *s, VkStructureType t)
 {
@@ -174,4 +195,42 @@ static inline void *wine_vk_find_struct_(void *s, VkStructureType t)
 
 #define UNIX_CALL(code, params) WINE_UNIX_CALL(unix_ ## code, params)
 
+#ifndef WINE_UNIX_LIB
+
+void command_buffer_execute_stream(VkCommandBuffer buffer) DECLSPEC_HIDDEN;
+
+static inline void command_buffer_flush(VkCommandBuffer buffer)
+{
+    if (buffer->stream_size)
+        command_buffer_execute_stream(buffer);
+}
+
+/* Record a call that doesn't return anything and doesn't reference any
+ * client memory, so that consecutive calls can be executed with a single
+ * transition to the Unix side. */
+static inline void command_buffer_record_call(VkCommandBuffer buffer, enum unix_call code,
+        const void *params, UINT32 size)
+{
+    struct command_stream_entry *entry;
+    UINT32 entry_size;
+
+    entry_size = (offsetof(struct command_stream_entry, params[size]) + 7) & ~7;
+    if (buffer->stream_size + entry_size > COMMAND_STREAM_SIZE)
+        command_buffer_execute_stream(buffer);
+
+    if (!buffer->stream && !(buffer->stream = malloc(COMMAND_STREAM_SIZE)))
+    {
+        WINE_UNIX_CALL(code, (void *)params);
+        return;
+    }
+
+    entry = (struct command_stream_entry *)(buffer->stream + buffer->stream_size);
+    entry->code = code;
+    entry->size = entry_size;
+    memcpy(entry->params, params, size);
+    buffer->stream_size += entry_size;
+}
+
+#endif /* WINE_UNIX_LIB */
+
 #endif /* __WINE_VULKAN_LOADER_H */
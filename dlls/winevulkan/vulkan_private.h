@@ -360,18 +360,51 @@ NTSTATUS vk_is_available_instance_function(void *arg) DECLSPEC_HIDDEN;
 NTSTATUS vk_is_available_device_function(void *arg) DECLSPEC_HIDDEN;
 NTSTATUS vk_is_available_instance_function32(void *arg) DECLSPEC_HIDDEN;
 NTSTATUS vk_is_available_device_function32(void *arg) DECLSPEC_HIDDEN;
+NTSTATUS vk_execute_command_stream(void *arg) DECLSPEC_HIDDEN;
+NTSTATUS vk_execute_command_stream32(void *arg) DECLSPEC_HIDDEN;
+
+extern const unixlib_entry_t __wine_unix_call_funcs[] DECLSPEC_HIDDEN;
+#ifdef _WIN64
+extern const unixlib_entry_t __wine_unix_call_wow64_funcs[] DECLSPEC_HIDDEN;
+#endif
+
+/* Per-thread scratch memory backing conversion contexts which overflow their
+ * inline buffer. The arena keeps the largest size needed so far, so that steady
+ * state conversions don't hit the heap. */
+struct conversion_arena
+{
+    char *base;
+    size_t size;
+    size_t used;
+    size_t high_water;
+};
 
 struct conversion_context
 {
     char buffer[2048];
     uint32_t used;
     struct list alloc_entries;
+    struct conversion_arena *arena;
+    size_t arena_mark;
+    BOOL persistent;
 };
 
+void *conversion_context_alloc_slow(struct conversion_context *pool, size_t size);
+void conversion_arena_release(struct conversion_context *pool);
+
 static inline void init_conversion_context(struct conversion_context *pool)
 {
     pool->used = 0;
     list_init(&pool->alloc_entries);
+    pool->arena = NULL;
+    pool->persistent = FALSE;
+}
+
+/* Contexts outliving the current call can't use the thread arena. */
+static inline void init_persistent_conversion_context(struct conversion_context *pool)
+{
+    init_conversion_context(pool);
+    pool->persistent = TRUE;
 }
 
 static inline void free_conversion_context(struct conversion_context *pool)
@@ -379,6 +412,8 @@ static inline void free_conversion_context(struct conversion_context *pool)
     struct list *entry, *next;
     LIST_FOR_EACH_SAFE(entry, next, &pool->alloc_entries)
         free(entry);
+    if (pool->arena)
+        conversion_arena_release(pool);
 }
 
 struct wine_semaphore
@@ -439,14 +474,7 @@ static inline void *conversion_context_alloc(struct conversion_context *pool, si
         pool->used += (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
         return ret;
     }
-    else
-    {
-        struct list *entry;
-        if (!(entry = malloc(sizeof(*entry) + size)))
-            return NULL;
-        list_add_tail(&pool->alloc_entries, entry);
-        return entry + 1;
-    }
+    return conversion_context_alloc_slow(pool, size);
 }
 
 struct wine_deferred_operation
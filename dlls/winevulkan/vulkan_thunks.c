@@ -46979,6 +46979,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     init_vulkan,
     vk_is_available_instance_function,
     vk_is_available_device_function,
+    vk_execute_command_stream,
     thunk64_vkAcquireNextImage2KHR,
     thunk64_vkAcquireNextImageKHR,
     thunk64_vkAcquirePerformanceConfigurationINTEL,
@@ -47561,6 +47562,7 @@ const unixlib_entry_t __wine_unix_call_funcs[] =
     init_vulkan,
     vk_is_available_instance_function32,
     vk_is_available_device_function32,
+    vk_execute_command_stream32,
     thunk32_vkAcquireNextImage2KHR,
     thunk32_vkAcquireNextImageKHR,
     thunk32_vkAcquirePerformanceConfigurationINTEL,
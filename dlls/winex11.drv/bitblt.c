@@ -1582,6 +1582,8 @@ struct x11drv_window_surface
     COLORREF              color_key;
     HRGN                  region;
     void                 *bits;
+    BYTE                 *shadow;  /* image contents at the last flush, if only sending changes */
+    RECT                  exposed; /* area that must be sent even if unchanged */
 #ifdef HAVE_LIBXXSHM
     XShmSegmentInfo       shminfo;
 #endif
@@ -1891,6 +1893,9 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     TRACE( "updating surface %p with %p\n", surface, region );
 
     window_surface->funcs->lock( window_surface );
+    /* pixels that were clipped until now have never been sent */
+    SetRect( &surface->exposed, 0, 0, window_surface->rect.right - window_surface->rect.left,
+             window_surface->rect.bottom - window_surface->rect.top );
     if (!region)
     {
         if (surface->region) NtGdiDeleteObjectApp( surface->region );
@@ -1911,6 +1916,121 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     window_surface->funcs->unlock( window_surface );
 }
 
+static void put_surface_image( struct x11drv_window_surface *surface, const RECT *rect )
+{
+#ifdef HAVE_LIBXXSHM
+    if (surface->shminfo.shmid != -1)
+        XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                      rect->left, rect->top,
+                      surface->header.rect.left + rect->left, surface->header.rect.top + rect->top,
+                      rect->right - rect->left, rect->bottom - rect->top, False );
+    else
+#endif
+    XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+               rect->left, rect->top,
+               surface->header.rect.left + rect->left, surface->header.rect.top + rect->top,
+               rect->right - rect->left, rect->bottom - rect->top );
+}
+
+#define SURFACE_TILE_SIZE 64
+
+/* compare a tile with the last flushed image, and update the latter */
+static BOOL update_surface_tile( struct x11drv_window_surface *surface, const RECT *tile )
+{
+    int stride = surface->image->bytes_per_line, bpp = surface->image->bits_per_pixel;
+    int start = tile->left * bpp / 8, len = (tile->right * bpp + 7) / 8 - start;
+    const BYTE *src = (const BYTE *)surface->image->data + tile->top * stride + start;
+    BYTE *dst = surface->shadow + tile->top * stride + start;
+    RECT rc;
+    int y;
+
+    if (!intersect_rect( &rc, tile, &surface->exposed ))
+    {
+        for (y = tile->top; y < tile->bottom; y++, src += stride, dst += stride)
+            if (memcmp( src, dst, len )) break;
+        if (y == tile->bottom) return FALSE;
+    }
+    for ( ; y < tile->bottom; y++, src += stride, dst += stride) memcpy( dst, src, len );
+    return TRUE;
+}
+
+/***********************************************************************
+ *           put_surface_changes
+ *
+ * Send only the tiles of the image that changed since the last flush. Horizontally
+ * adjacent changed tiles are merged, and so are identical spans in consecutive rows.
+ */
+static void put_surface_changes( struct x11drv_window_surface *surface, const RECT *rect )
+{
+    int cols = (rect->right + SURFACE_TILE_SIZE - 1) / SURFACE_TILE_SIZE - rect->left / SURFACE_TILE_SIZE;
+    int i, j, prev_count = 0, count, sent = 0;
+    RECT *spans, *prev, *cur, *tmp, tile;
+
+    if (!(spans = malloc( 2 * cols * sizeof(*spans) )))
+    {
+        put_surface_image( surface, rect );
+        return;
+    }
+    prev = spans;
+    cur = spans + cols;
+
+    for (tile.top = rect->top; tile.top < rect->bottom; tile.top = tile.bottom)
+    {
+        tile.bottom = min( (tile.top / SURFACE_TILE_SIZE + 1) * SURFACE_TILE_SIZE, rect->bottom );
+
+        /* collect the spans of changed tiles in this row */
+        count = 0;
+        for (tile.left = rect->left; tile.left < rect->right; tile.left = tile.right)
+        {
+            tile.right = min( (tile.left / SURFACE_TILE_SIZE + 1) * SURFACE_TILE_SIZE, rect->right );
+            if (!update_surface_tile( surface, &tile )) continue;
+            if (count && cur[count - 1].right == tile.left) cur[count - 1].right = tile.right;
+            else cur[count++] = tile;
+        }
+
+        /* extend the spans of the previous row that are still changed, send the others */
+        for (i = 0; i < prev_count; i++)
+        {
+            for (j = 0; j < count; j++)
+            {
+                if (cur[j].left != prev[i].left || cur[j].right != prev[i].right) continue;
+                cur[j].top = prev[i].top;
+                break;
+            }
+            if (j == count)
+            {
+                put_surface_image( surface, &prev[i] );
+                sent++;
+            }
+        }
+        tmp = prev;
+        prev = cur;
+        cur = tmp;
+        prev_count = count;
+    }
+    for (i = 0; i < prev_count; i++) put_surface_image( surface, &prev[i] );
+    sent += prev_count;
+
+    TRACE( "%p: sent %d rects for %s\n", surface, sent, wine_dbgstr_rect( rect ));
+    free( spans );
+}
+
+/* remove the flushed area from the exposed rectangle, keeping what can't be expressed as a rectangle */
+static void subtract_flushed_rect( RECT *exposed, const RECT *flushed )
+{
+    if (flushed->left <= exposed->left && flushed->right >= exposed->right)
+    {
+        if (flushed->top <= exposed->top) exposed->top = max( exposed->top, flushed->bottom );
+        else if (flushed->bottom >= exposed->bottom) exposed->bottom = min( exposed->bottom, flushed->top );
+    }
+    else if (flushed->top <= exposed->top && flushed->bottom >= exposed->bottom)
+    {
+        if (flushed->left <= exposed->left) exposed->left = max( exposed->left, flushed->right );
+        else if (flushed->right >= exposed->right) exposed->right = min( exposed->right, flushed->left );
+    }
+    if (exposed->left >= exposed->right || exposed->top >= exposed->bottom) reset_bounds( exposed );
+}
+
 /***********************************************************************
  *           x11drv_surface_flush
  */
@@ -1956,23 +2076,10 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
                     ptr[x] |= surface->alpha_bits;
         }
 
-#ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
-        else
-#endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+        if (surface->shadow) put_surface_changes( surface, &coords.visrect );
+        else put_surface_image( surface, &coords.visrect );
         XFlush( gdi_display );
+        subtract_flushed_rect( &surface->exposed, &coords.visrect );
     }
     reset_bounds( &surface->bounds );
     window_surface->funcs->unlock( window_surface );
@@ -2003,6 +2110,7 @@ static void x11drv_surface_destroy( struct window_surface *window_surface )
         XDestroyImage( surface->image );
     }
     if (surface->region) NtGdiDeleteObjectApp( surface->region );
+    free( surface->shadow );
     free( surface );
 }
 
@@ -2047,6 +2155,7 @@ struct window_surface *create_surface( Window window, const XVisualInfo *vis, co
     surface->is_argb = (use_alpha && vis->depth == 32 && surface->info.bmiHeader.biCompression == BI_RGB);
     set_color_key( surface, color_key );
     reset_bounds( &surface->bounds );
+    reset_bounds( &surface->exposed );
 
 #ifdef HAVE_LIBXXSHM
     surface->image = create_shm_image( vis, width, height, &surface->shminfo );
@@ -2075,6 +2184,18 @@ struct window_surface *create_surface( Window window, const XVisualInfo *vis, co
     }
     else surface->bits = surface->image->data;
 
+    /* layered windows update their shape from the pixels, always send everything for them */
+    if (!surface->is_argb && surface->color_key == CLR_INVALID &&
+#ifdef HAVE_LIBXXSHM
+        (diff_window_surfaces > 0 || (diff_window_surfaces < 0 && surface->shminfo.shmid == -1)))
+#else
+        diff_window_surfaces)
+#endif
+    {
+        surface->shadow = calloc( height, surface->image->bytes_per_line );
+        SetRect( &surface->exposed, 0, 0, width, height );
+    }
+
     TRACE( "created %p for %lx %s bits %p-%p image %p\n", surface, window, wine_dbgstr_rect(rect),
            surface->bits, (char *)surface->bits + surface->info.bmiHeader.biSizeImage,
            surface->image->data );
@@ -2100,6 +2221,12 @@ void set_surface_color_key( struct window_surface *window_surface, COLORREF colo
     prev = surface->color_key;
     set_color_key( surface, color_key );
     if (surface->color_key != prev) update_surface_region( surface );
+    if (surface->color_key != CLR_INVALID)
+    {
+        /* the shape now depends on the pixels, stop sending only the changes */
+        free( surface->shadow );
+        surface->shadow = NULL;
+    }
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -2117,6 +2244,7 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
     window_surface->funcs->lock( window_surface );
     OffsetRect( &rc, -window_surface->rect.left, -window_surface->rect.top );
     add_bounds_rect( &surface->bounds, &rc );
+    add_bounds_rect( &surface->exposed, &rc );
     if (surface->region)
     {
         region = NtGdiCreateRectRgn( rect->left, rect->top, rect->right, rect->bottom );
@@ -84,6 +84,7 @@ int primary_monitor = 0;
 BOOL client_side_graphics = TRUE;
 BOOL client_side_with_render = TRUE;
 BOOL shape_layered_windows = TRUE;
+int diff_window_surfaces = -1;
 int copy_default_colors = 128;
 int alloc_system_colors = 256;
 int limit_number_of_resolutions = 0;
@@ -542,6 +543,9 @@ static void setup_options(void)
     if (!get_config_key( hkey, appkey, "ShapeLayeredWindows", buffer, sizeof(buffer) ))
         shape_layered_windows = IS_OPTION_TRUE( buffer[0] );
 
+    if (!get_config_key( hkey, appkey, "DiffWindowSurfaces", buffer, sizeof(buffer) ))
+        diff_window_surfaces = IS_OPTION_TRUE( buffer[0] );
+
     if (!get_config_key( hkey, appkey, "PrivateColorMap", buffer, sizeof(buffer) ))
         private_color_map = IS_OPTION_TRUE( buffer[0] );
 
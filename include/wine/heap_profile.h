@@ -0,0 +1,59 @@
+/*
+ * Wine heap allocation profiler definitions
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_WINE_HEAP_PROFILE_H
+#define __WINE_WINE_HEAP_PROFILE_H
+
+/* Wine specific heap information class for Rtl{Query,Set}HeapInformation */
+#define HeapWineProfileInformation ((HEAP_INFORMATION_CLASS)1000)
+
+#define HEAP_PROFILE_MAX_FRAMES    8
+#define HEAP_PROFILE_SIZE_CLASSES  32
+
+typedef struct _HEAP_PROFILE_SETTINGS
+{
+    ULONG Enabled;
+    ULONG SampleInterval; /* average number of allocated bytes between samples, 0 for default */
+} HEAP_PROFILE_SETTINGS, *PHEAP_PROFILE_SETTINGS;
+
+typedef struct _HEAP_PROFILE_CALLSITE
+{
+    ULONG64 SampledAllocs;
+    ULONG64 SampledBytes;
+    ULONG64 LiveAllocs;
+    ULONG64 LiveBytes;
+    ULONG   FrameCount; /* 0 for samples that didn't fit in the call site table */
+    PVOID   Frames[HEAP_PROFILE_MAX_FRAMES];
+} HEAP_PROFILE_CALLSITE, *PHEAP_PROFILE_CALLSITE;
+
+typedef struct _HEAP_PROFILE_INFORMATION
+{
+    ULONG   Enabled;
+    ULONG   SampleInterval;
+    ULONG64 TotalAllocs;
+    ULONG64 TotalFrees;
+    ULONG64 TotalBytes;
+    LONG64  LiveBytes;  /* relative to when profiling was enabled */
+    ULONG64 SizeHistogram[HEAP_PROFILE_SIZE_CLASSES]; /* allocation count by floor(log2(size)) */
+    ULONG   CallsiteCount;
+    HEAP_PROFILE_CALLSITE Callsites[1];
+} HEAP_PROFILE_INFORMATION, *PHEAP_PROFILE_INFORMATION;
+
+#endif  /* __WINE_WINE_HEAP_PROFILE_H */
@@ -903,6 +903,29 @@ struct input_shared_memory
     __int64              sync_serial;
 };
 
+struct window_shared_memory
+{
+    unsigned int         seq;
+    user_handle_t        handle;
+    user_handle_t        parent;
+    user_handle_t        owner;
+    thread_id_t          tid;
+    process_id_t         pid;
+    unsigned int         style;
+    unsigned int         ex_style;
+    rectangle_t          window_rect;
+    rectangle_t          client_rect;
+    unsigned int         dpi;
+    unsigned int         monitor_dpi;
+    lparam_t             id;
+    mod_handle_t         instance;
+    lparam_t             user_data;
+};
+
+
+#define WINDOW_SHARED_MEMORY_COUNT ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+#define WINDOW_SHARED_MEMORY_INDEX(handle) ((((handle) & 0xffff) - FIRST_USER_HANDLE) >> 1)
+
 
 #define SEQUENCE_MASK_BITS  4
 #define SEQUENCE_MASK ((1UL << SEQUENCE_MASK_BITS) - 1)
@@ -2767,6 +2790,18 @@ struct set_queue_mask_reply
 
 
 
+struct wake_posted_queue_request
+{
+    struct request_header __header;
+    thread_id_t  id;
+};
+struct wake_posted_queue_reply
+{
+    struct reply_header __header;
+};
+
+
+
 struct get_queue_status_request
 {
     struct request_header __header;
@@ -2864,6 +2899,25 @@ struct send_hardware_message_reply
 
 
 
+struct send_hardware_messages_request
+{
+    struct request_header __header;
+    unsigned int    flags;
+    /* VARARG(inputs,hw_inputs); */
+};
+struct send_hardware_messages_reply
+{
+    struct reply_header __header;
+    unsigned int    count;
+    int             wait;
+    int             prev_x;
+    int             prev_y;
+    int             new_x;
+    int             new_y;
+};
+
+
+
 struct get_message_request
 {
     struct request_header __header;
@@ -5903,11 +5957,13 @@ enum request
     REQ_get_msg_queue,
     REQ_set_queue_fd,
     REQ_set_queue_mask,
+    REQ_wake_posted_queue,
     REQ_get_queue_status,
     REQ_get_process_idle_event,
     REQ_send_message,
     REQ_post_quit_message,
     REQ_send_hardware_message,
+    REQ_send_hardware_messages,
     REQ_get_message,
     REQ_reply_message,
     REQ_accept_hardware_message,
@@ -6201,11 +6257,13 @@ union generic_request
     struct get_msg_queue_request get_msg_queue_request;
     struct set_queue_fd_request set_queue_fd_request;
     struct set_queue_mask_request set_queue_mask_request;
+    struct wake_posted_queue_request wake_posted_queue_request;
     struct get_queue_status_request get_queue_status_request;
     struct get_process_idle_event_request get_process_idle_event_request;
     struct send_message_request send_message_request;
     struct post_quit_message_request post_quit_message_request;
     struct send_hardware_message_request send_hardware_message_request;
+    struct send_hardware_messages_request send_hardware_messages_request;
     struct get_message_request get_message_request;
     struct reply_message_request reply_message_request;
     struct accept_hardware_message_request accept_hardware_message_request;
@@ -6497,11 +6555,13 @@ union generic_reply
     struct get_msg_queue_reply get_msg_queue_reply;
     struct set_queue_fd_reply set_queue_fd_reply;
     struct set_queue_mask_reply set_queue_mask_reply;
+    struct wake_posted_queue_reply wake_posted_queue_reply;
     struct get_queue_status_reply get_queue_status_reply;
     struct get_process_idle_event_reply get_process_idle_event_reply;
     struct send_message_reply send_message_reply;
     struct post_quit_message_reply post_quit_message_reply;
     struct send_hardware_message_reply send_hardware_message_reply;
+    struct send_hardware_messages_reply send_hardware_messages_reply;
     struct get_message_reply get_message_reply;
     struct reply_message_reply reply_message_reply;
     struct accept_hardware_message_reply accept_hardware_message_reply;
@@ -6682,7 +6742,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 759
+#define SERVER_PROTOCOL_VERSION 762
 
 /* ### protocol_version end ### */
 
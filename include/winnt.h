@@ -1748,6 +1748,7 @@ typedef struct _KNONVOLATILE_CONTEXT_POINTERS
 #endif
 
 NTSYSAPI void WINAPI RtlCaptureContext(CONTEXT*);
+NTSYSAPI WORD WINAPI RtlCaptureStackBackTrace(DWORD,DWORD,void**,DWORD*);
 
 #define WOW64_CONTEXT_i386 0x00010000
 #define WOW64_CONTEXT_i486 0x00010000
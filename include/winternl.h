@@ -1822,6 +1822,7 @@ typedef enum _SYSTEM_INFORMATION_CLASS {
     SystemBuildVersionInformation = 222,
 #ifdef __WINESRC__
     SystemWineVersionInformation = 1000,
+    SystemWineLargePageInformation = 1001,
 #endif
 } SYSTEM_INFORMATION_CLASS, *PSYSTEM_INFORMATION_CLASS;
 
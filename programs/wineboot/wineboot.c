@@ -451,7 +451,9 @@ static void create_user_shared_data( UINT64 *tsc_frequency )
     NtQuerySystemInformation( SystemCpuInformation, &sci, sizeof(sci), NULL );
 
     data->TickCountMultiplier         = 1 << 24;
-    data->LargePageMinimum            = 2 * 1024 * 1024;
+    if (NtQuerySystemInformation( SystemWineLargePageInformation, &data->LargePageMinimum,
+                                  sizeof(data->LargePageMinimum), NULL ))
+        data->LargePageMinimum = 0;
     data->NtBuildNumber               = version.dwBuildNumber;
     data->NtProductType               = version.wProductType;
     data->ProductTypeIsValid          = TRUE;
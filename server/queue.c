@@ -239,46 +239,6 @@ static unsigned int last_input_time;
 static cursor_pos_t cursor_history[64];
 static unsigned int cursor_history_latest;
 
-#if defined(__i386__) || defined(__x86_64__)
-
-#define SHARED_WRITE_BEGIN( x )                                  \
-    do {                                                         \
-        volatile unsigned int __seq = *(x);                      \
-        assert( (__seq & SEQUENCE_MASK) != SEQUENCE_MASK );      \
-        *(x) = ++__seq;                                          \
-    } while(0)
-
-#define SHARED_WRITE_END( x )                                    \
-    do {                                                         \
-        volatile unsigned int __seq = *(x);                      \
-        assert( (__seq & SEQUENCE_MASK) != 0 );                  \
-        if ((__seq & SEQUENCE_MASK) > 1) __seq--;                \
-        else __seq += SEQUENCE_MASK;                             \
-        *(x) = __seq;                                            \
-    } while(0)
-
-#else
-
-#define SHARED_WRITE_BEGIN( x )                                         \
-    do {                                                                \
-        assert( (*(x) & SEQUENCE_MASK) != SEQUENCE_MASK );              \
-        if ((__atomic_add_fetch( x, 1, __ATOMIC_RELAXED ) & SEQUENCE_MASK) == 1) \
-            __atomic_thread_fence( __ATOMIC_RELEASE );                  \
-    } while(0)
-
-#define SHARED_WRITE_END( x )                                           \
-    do {                                                                \
-        assert( (*(x) & SEQUENCE_MASK) != 0 );                          \
-        if ((*(x) & SEQUENCE_MASK) > 1)                                 \
-            __atomic_sub_fetch( x, 1, __ATOMIC_RELAXED );               \
-        else {                                                          \
-            __atomic_thread_fence( __ATOMIC_RELEASE );                  \
-            __atomic_add_fetch( x, SEQUENCE_MASK, __ATOMIC_RELAXED );   \
-        }                                                               \
-    } while(0)
-
-#endif
-
 static void queue_hardware_message( struct desktop *desktop, struct message *msg, int always_queue );
 static void free_message( struct message *msg );
 
@@ -852,9 +812,39 @@ static int merge_unique_message( struct thread_input *input, unsigned int messag
     return 1;
 }
 
+/* try to merge a relative raw mouse motion with the last message in the list; return 1 if successful */
+static int merge_rawinput_mousemove( struct thread_input *input, const struct message *msg )
+{
+    struct hardware_msg_data *prev_data, *msg_data = msg->data;
+    struct message *prev;
+    struct list *ptr;
+
+    /* only coalesce device motion, injected input is expected to be delivered as is */
+    if (msg_data->rawinput.type != RIM_TYPEMOUSE) return 0;
+    if (msg_data->source.origin != IMO_HARDWARE) return 0;
+    if (msg_data->flags != MOUSEEVENTF_MOVE) return 0;
+
+    if (!(ptr = list_tail( &input->msg_list ))) return 0;
+    prev = LIST_ENTRY( ptr, struct message, entry );
+    if (prev->msg != WM_INPUT || prev->result || prev->unique_id) return 0;
+    if (prev->win != msg->win || prev->wparam != msg->wparam) return 0;
+    if (prev->data_size != msg->data_size) return 0;
+    prev_data = prev->data;
+    if (prev_data->rawinput.type != RIM_TYPEMOUSE) return 0;
+    if (prev_data->source.origin != IMO_HARDWARE) return 0;
+    if (prev_data->flags != MOUSEEVENTF_MOVE) return 0;
+    /* now we can merge it, the consumer hasn't seen the previous one yet */
+    prev_data->rawinput.mouse.x += msg_data->rawinput.mouse.x;
+    prev_data->rawinput.mouse.y += msg_data->rawinput.mouse.y;
+    prev_data->info = msg_data->info;
+    prev->time = msg->time;
+    return 1;
+}
+
 /* try to merge a message with the messages in the list; return 1 if successful */
 static int merge_message( struct thread_input *input, const struct message *msg )
 {
+    if (msg->msg == WM_INPUT) return merge_rawinput_mousemove( input, msg );
     if (msg->msg == WM_POINTERUPDATE) return merge_pointer_update_message( input, msg );
     if (msg->msg == WM_MOUSEMOVE) return merge_mousemove( input, msg );
     if (msg->msg == WM_WINE_CLIPCURSOR) return merge_unique_message( input, WM_WINE_CLIPCURSOR, msg );
@@ -1360,6 +1350,9 @@ static void cleanup_msg_queue( struct msg_queue *queue )
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
     if (do_esync()) close( queue->esync_fd );
+    SHARED_WRITE_BEGIN( &queue->shared->seq );
+    queue->shared->created = FALSE;
+    SHARED_WRITE_END( &queue->shared->seq );
     queue->destroyed = 1;
 }
 
@@ -2078,6 +2071,7 @@ static int queue_rawinput_message( struct process* process, void *arg )
     msg->wparam = wparam;
     msg->lparam = 0;
     memcpy( msg->data, &raw_msg->data, sizeof(raw_msg->data) );
+    ((struct hardware_msg_data *)msg->data)->source = raw_msg->source;
     if (report_size) memcpy( (struct hardware_msg_data *)msg->data + 1, raw_msg->hid_report, report_size );
 
     if (raw_msg->message == WM_INPUT_DEVICE_CHANGE && raw_msg->data.rawinput.type == RIM_TYPEHID)
@@ -2916,6 +2910,29 @@ DECL_HANDLER(set_queue_mask)
 }
 
 
+/* wake up a queue of the current process after messages were posted to its client-side ring */
+DECL_HANDLER(wake_posted_queue)
+{
+    struct msg_queue *queue;
+    struct thread *thread;
+
+    if (!(thread = get_thread_from_id( req->id ))) return;
+    if (thread->process != current->process) set_error( STATUS_ACCESS_DENIED );
+    else if ((queue = thread->queue))
+    {
+        /* only the changed bits, the wake bits reflect the server posted list */
+        queue->changed_bits |= QS_POSTMESSAGE | QS_ALLPOSTMESSAGE;
+
+        SHARED_WRITE_BEGIN( &queue->shared->seq );
+        queue->shared->changed_bits = queue->changed_bits;
+        SHARED_WRITE_END( &queue->shared->seq );
+
+        if (is_signaled( queue )) wake_up( &queue->obj, 0 );
+    }
+    release_object( thread );
+}
+
+
 /* get the current message queue status */
 DECL_HANDLER(get_queue_status)
 {
@@ -3065,6 +3082,43 @@ DECL_HANDLER(send_hardware_message)
     release_object( desktop );
 }
 
+/* send a batch of hardware messages to the desktop of the current thread */
+DECL_HANDLER(send_hardware_messages)
+{
+    const hw_input_t *input = get_req_data();
+    data_size_t count = get_req_data_size() / sizeof(*input);
+    unsigned int origin = (req->flags & SEND_HWMSG_INJECTED ? IMO_INJECTED : IMO_HARDWARE);
+    struct msg_queue *sender = get_current_queue();
+    struct desktop *desktop;
+
+    if (!(desktop = get_thread_desktop( current, 0 ))) return;
+
+    reply->prev_x = desktop->shared->cursor.x;
+    reply->prev_y = desktop->shared->cursor.y;
+
+    /* stop after a message waiting for a low-level hook, the client resends the rest once it's done */
+    for (reply->count = 0; reply->count < count && !reply->wait; reply->count++, input++)
+    {
+        switch (input->type)
+        {
+        case INPUT_MOUSE:
+            reply->wait = queue_mouse_message( desktop, 0, input, origin, sender, req->flags );
+            break;
+        case INPUT_KEYBOARD:
+            reply->wait = queue_keyboard_message( desktop, 0, input, origin, sender, req->flags );
+            break;
+        default:
+            set_error( STATUS_INVALID_PARAMETER );
+            break;
+        }
+        if (get_error()) break;
+    }
+
+    reply->new_x = desktop->shared->cursor.x;
+    reply->new_y = desktop->shared->cursor.y;
+    release_object( desktop );
+}
+
 /* post a quit message to the current queue */
 DECL_HANDLER(post_quit_message)
 {
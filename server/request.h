@@ -229,11 +229,13 @@ DECL_HANDLER(get_atom_information);
 DECL_HANDLER(get_msg_queue);
 DECL_HANDLER(set_queue_fd);
 DECL_HANDLER(set_queue_mask);
+DECL_HANDLER(wake_posted_queue);
 DECL_HANDLER(get_queue_status);
 DECL_HANDLER(get_process_idle_event);
 DECL_HANDLER(send_message);
 DECL_HANDLER(post_quit_message);
 DECL_HANDLER(send_hardware_message);
+DECL_HANDLER(send_hardware_messages);
 DECL_HANDLER(get_message);
 DECL_HANDLER(reply_message);
 DECL_HANDLER(accept_hardware_message);
@@ -526,11 +528,13 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_get_msg_queue,
     (req_handler)req_set_queue_fd,
     (req_handler)req_set_queue_mask,
+    (req_handler)req_wake_posted_queue,
     (req_handler)req_get_queue_status,
     (req_handler)req_get_process_idle_event,
     (req_handler)req_send_message,
     (req_handler)req_post_quit_message,
     (req_handler)req_send_hardware_message,
+    (req_handler)req_send_hardware_messages,
     (req_handler)req_get_message,
     (req_handler)req_reply_message,
     (req_handler)req_accept_hardware_message,
@@ -1356,6 +1360,8 @@ C_ASSERT( sizeof(struct set_queue_mask_request) == 24 );
 C_ASSERT( FIELD_OFFSET(struct set_queue_mask_reply, wake_bits) == 8 );
 C_ASSERT( FIELD_OFFSET(struct set_queue_mask_reply, changed_bits) == 12 );
 C_ASSERT( sizeof(struct set_queue_mask_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct wake_posted_queue_request, id) == 12 );
+C_ASSERT( sizeof(struct wake_posted_queue_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_queue_status_request, clear_bits) == 12 );
 C_ASSERT( sizeof(struct get_queue_status_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_queue_status_reply, wake_bits) == 8 );
@@ -1386,6 +1392,15 @@ C_ASSERT( FIELD_OFFSET(struct send_hardware_message_reply, prev_y) == 16 );
 C_ASSERT( FIELD_OFFSET(struct send_hardware_message_reply, new_x) == 20 );
 C_ASSERT( FIELD_OFFSET(struct send_hardware_message_reply, new_y) == 24 );
 C_ASSERT( sizeof(struct send_hardware_message_reply) == 32 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_request, flags) == 12 );
+C_ASSERT( sizeof(struct send_hardware_messages_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, count) == 8 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, wait) == 12 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, prev_x) == 16 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, prev_y) == 20 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, new_x) == 24 );
+C_ASSERT( FIELD_OFFSET(struct send_hardware_messages_reply, new_y) == 28 );
+C_ASSERT( sizeof(struct send_hardware_messages_reply) == 32 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, flags) == 12 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, get_win) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_message_request, get_first) == 20 );
@@ -965,6 +965,21 @@ static void dump_varargs_rectangles( const char *prefix, data_size_t size )
     remove_data( size );
 }
 
+static void dump_varargs_hw_inputs( const char *prefix, data_size_t size )
+{
+    const hw_input_t *input = cur_data;
+    data_size_t len = size / sizeof(*input);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        dump_hw_input( "", input++ );
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
 static void dump_varargs_cursor_positions( const char *prefix, data_size_t size )
 {
     const cursor_pos_t *pos = cur_data;
@@ -2648,6 +2663,11 @@ static void dump_set_queue_mask_reply( const struct set_queue_mask_reply *req )
     fprintf( stderr, ", changed_bits=%08x", req->changed_bits );
 }
 
+static void dump_wake_posted_queue_request( const struct wake_posted_queue_request *req )
+{
+    fprintf( stderr, " id=%04x", req->id );
+}
+
 static void dump_get_queue_status_request( const struct get_queue_status_request *req )
 {
     fprintf( stderr, " clear_bits=%08x", req->clear_bits );
@@ -2704,6 +2724,22 @@ static void dump_send_hardware_message_reply( const struct send_hardware_message
     fprintf( stderr, ", new_y=%d", req->new_y );
 }
 
+static void dump_send_hardware_messages_request( const struct send_hardware_messages_request *req )
+{
+    fprintf( stderr, " flags=%08x", req->flags );
+    dump_varargs_hw_inputs( ", inputs=", cur_size );
+}
+
+static void dump_send_hardware_messages_reply( const struct send_hardware_messages_reply *req )
+{
+    fprintf( stderr, " count=%08x", req->count );
+    fprintf( stderr, ", wait=%d", req->wait );
+    fprintf( stderr, ", prev_x=%d", req->prev_x );
+    fprintf( stderr, ", prev_y=%d", req->prev_y );
+    fprintf( stderr, ", new_x=%d", req->new_x );
+    fprintf( stderr, ", new_y=%d", req->new_y );
+}
+
 static void dump_get_message_request( const struct get_message_request *req )
 {
     fprintf( stderr, " flags=%08x", req->flags );
@@ -4784,11 +4820,13 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_msg_queue_request,
     (dump_func)dump_set_queue_fd_request,
     (dump_func)dump_set_queue_mask_request,
+    (dump_func)dump_wake_posted_queue_request,
     (dump_func)dump_get_queue_status_request,
     (dump_func)dump_get_process_idle_event_request,
     (dump_func)dump_send_message_request,
     (dump_func)dump_post_quit_message_request,
     (dump_func)dump_send_hardware_message_request,
+    (dump_func)dump_send_hardware_messages_request,
     (dump_func)dump_get_message_request,
     (dump_func)dump_reply_message_request,
     (dump_func)dump_accept_hardware_message_request,
@@ -5078,11 +5116,13 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_msg_queue_reply,
     NULL,
     (dump_func)dump_set_queue_mask_reply,
+    NULL,
     (dump_func)dump_get_queue_status_reply,
     (dump_func)dump_get_process_idle_event_reply,
     NULL,
     NULL,
     (dump_func)dump_send_hardware_message_reply,
+    (dump_func)dump_send_hardware_messages_reply,
     (dump_func)dump_get_message_reply,
     NULL,
     NULL,
@@ -5372,11 +5412,13 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "get_msg_queue",
     "set_queue_fd",
     "set_queue_mask",
+    "wake_posted_queue",
     "get_queue_status",
     "get_process_idle_event",
     "send_message",
     "post_quit_message",
     "send_hardware_message",
+    "send_hardware_messages",
     "get_message",
     "reply_message",
     "accept_hardware_message",
@@ -30,6 +30,7 @@
 #include "ntuser.h"
 
 #include "object.h"
+#include "file.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -255,6 +256,64 @@ static unsigned int get_monitor_dpi( struct window *win )
     return win->dpi ? win->dpi : USER_DEFAULT_SCREEN_DPI;
 }
 
+static struct object *window_shared_mapping;
+static volatile struct window_shared_memory *window_shared;
+
+/* get the shared memory entry of a window, creating the mapping if needed */
+static volatile struct window_shared_memory *get_window_shared( user_handle_t handle )
+{
+    static const WCHAR nameW[] = {'w','i','n','d','o','w','s'};
+    static const struct unicode_str name = {nameW, sizeof(nameW)};
+    struct object *dir;
+
+    if (!window_shared_mapping)
+    {
+        if (!(dir = create_thread_map_directory())) return NULL;
+        window_shared_mapping = create_shared_mapping( dir, &name, WINDOW_SHARED_MEMORY_COUNT * sizeof(*window_shared),
+                                                       NULL, (void **)&window_shared );
+        release_object( dir );
+        if (!window_shared_mapping) return NULL;
+    }
+    return window_shared + WINDOW_SHARED_MEMORY_INDEX( handle );
+}
+
+/* publish the window state to the window shared memory */
+static void update_window_shared( struct window *win )
+{
+    volatile struct window_shared_memory *shared;
+
+    if (!win->handle || !(shared = get_window_shared( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( &shared->seq );
+    shared->handle      = win->handle;
+    shared->parent      = win->parent ? win->parent->handle : 0;
+    shared->owner       = win->owner;
+    shared->tid         = win->thread ? get_thread_id( win->thread ) : 0;
+    shared->pid         = win->thread ? get_process_id( win->thread->process ) : 0;
+    shared->style       = win->style;
+    shared->ex_style    = win->ex_style;
+    shared->window_rect = win->window_rect;
+    shared->client_rect = win->client_rect;
+    shared->dpi         = win->dpi;
+    shared->monitor_dpi = get_monitor_dpi( win );
+    shared->id          = win->id;
+    shared->instance    = win->instance;
+    shared->user_data   = win->user_data;
+    SHARED_WRITE_END( &shared->seq );
+}
+
+/* mark the window shared memory entry as unused */
+static void clear_window_shared( struct window *win )
+{
+    volatile struct window_shared_memory *shared;
+
+    if (!(shared = get_window_shared( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( &shared->seq );
+    shared->handle = 0;
+    SHARED_WRITE_END( &shared->seq );
+}
+
 /* link a window at the right place in the siblings list */
 static int link_window( struct window *win, struct window *previous )
 {
@@ -348,6 +407,8 @@ static int set_parent_window( struct window *win, struct window *parent )
 
         if (win->paint_flags & (PAINT_HAS_PIXEL_FORMAT | PAINT_PIXEL_FORMAT_CHILD))
             update_pixel_format_flags( win );
+
+        update_window_shared( win );
     }
     else  /* move it to parent unlinked list */
     {
@@ -494,6 +555,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_window_shared( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -628,6 +690,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_window_shared( win );
     return win;
 
 failed:
@@ -1813,6 +1876,7 @@ static void set_window_pos( struct window *win, struct window *previous,
     if (!(swp_flags & SWP_NOZORDER) && win->parent) zorder_changed |= link_window( win, previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
+    update_window_shared( win );
 
     /* keep children at the same position relative to top right corner when the parent is mirrored */
     if (win->ex_style & WS_EX_LAYOUTRTL)
@@ -1827,6 +1891,7 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->surface_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shared( child );
         }
     }
 
@@ -2045,6 +2110,7 @@ void free_window_handle( struct window *win )
     detach_window_thread( win );
 
     if (win->parent) set_parent_window( win, NULL );
+    clear_window_shared( win );
     free_user_handle( win->handle );
     win->handle = 0;
     release_object( win );
@@ -2100,6 +2166,7 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    update_window_shared( win );
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2167,6 +2234,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shared( desktop->top_window );
         }
     }
 
@@ -2179,6 +2247,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shared( desktop->msg_window );
         }
     }
 
@@ -2214,6 +2283,7 @@ DECL_HANDLER(set_window_owner)
 
     reply->prev_owner = win->owner;
     reply->full_owner = win->owner = owner ? owner->handle : 0;
+    update_window_shared( win );
 }
 
 
@@ -2285,6 +2355,7 @@ DECL_HANDLER(set_window_info)
     if (req->flags & SET_WIN_USERDATA) win->user_data = req->user_data;
     if (req->flags & SET_WIN_EXTRA) memcpy( win->extra_bytes + req->extra_offset,
                                             &req->extra_value, req->extra_size );
+    if (req->flags) update_window_shared( win );
 
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;